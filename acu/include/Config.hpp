@@ -1,4 +1,6 @@
 #pragma once
+#include <string>
+#include <cstdint>
 
 namespace drone {
 
@@ -7,6 +9,7 @@ struct Config {
     std::string gcu_address;
     uint16_t gcu_port;
     uint16_t local_port;
+    std::string drone_id;        // Handshake identity, defaults to the machine id
 
     // Flight controller settings
     float pid_roll_p{1.0f};
@@ -21,6 +24,30 @@ struct Config {
     float pid_altitude_p{1.0f};
     float pid_altitude_i{0.1f};
     float pid_altitude_d{0.1f};
+    std::string airframe{"conventional"};   // conventional, flying_wing or v_tail
+
+    // PWM outputs
+    std::string pwm_backend{"pca9685"};     // pca9685, sysfs or mock
+    std::string pwm_i2c_bus{"/dev/i2c-1"};  // PCA9685 bus and address
+    uint8_t pwm_i2c_address{0x40};
+    std::string pwm_chip{"/sys/class/pwm/pwmchip0"};   // sysfs backend
+
+    // Attitude estimation
+    bool attitude_ekf{true};       // false selects the Mahony filter
+    float imu_gyro_lpf_hz{80.0f};  // Software low-pass cutoffs on the IMU samples
+    float imu_accel_lpf_hz{30.0f};
+
+    // GPS receiver
+    bool gps_ubx{true};            // false keeps the receiver on 9600 baud NMEA
+    uint32_t gps_rate_hz{10};      // UBX navigation rate
+
+    // Geofence zones file (see navigation/Geofence.hpp), empty disables
+    std::string geofence_file;
+
+    // Control thread real-time settings
+    int rt_priority{0};            // SCHED_FIFO priority, 0 disables
+    int rt_cpu{-1};                // CPU to pin the control thread to, -1 disables
+    bool rt_lock_memory{false};    // mlockall() before entering the loop
 };
 
 } // namespace drone 
\ No newline at end of file
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "Config.hpp"
 #include "protocol/Packet.hpp"
-#include "control/FlightController.hpp"
+#include "communication/ConnectionHandshake.hpp"
+#include "runtime/Topic.hpp"
+#include "topics/Topics.hpp"
+#include <netinet/in.h>
 #include <string>
 #include <memory>
 #include <thread>
@@ -27,11 +31,15 @@ public:
     void stop();
     void update();
 
-    // Dependencies
-    void setFlightController(control::FlightController* controller);
+    // Periodic transmissions, scheduled by the caller. Telemetry is built
+    // from the latest attitude, position, actuator and battery topics.
+    void sendTelemetry();
+    void sendHeartbeat();
+    void sendSpectrum(const protocol::SpectrumData& spectrum);
 
     // Status
     bool isConnected() const;
+    ConnectionHandshake::State getConnectionState() const { return handshake_.getState(); }
     std::chrono::steady_clock::time_point getLastHeartbeat() const;
 
 private:
@@ -40,29 +48,34 @@ private:
     uint16_t gcu_port_;
     uint16_t local_port_;
     int socket_fd_;
+    mutable std::mutex endpoint_mutex_;
+    struct sockaddr_in gcu_endpoint_;
 
-    // Dependencies
-    control::FlightController* flight_controller_;
+    // Telemetry sources, read by whichever thread sends telemetry
+    runtime::Subscription<topics::AttitudeTopic> attitude_subscription_;
+    runtime::Subscription<topics::PositionTopic> position_subscription_;
+    runtime::Subscription<topics::ActuatorOutputsTopic> outputs_subscription_;
+    runtime::Subscription<topics::BatteryTopic> battery_subscription_;
+    protocol::TelemetryData telemetry_;
 
     // Threading
     std::unique_ptr<std::thread> receive_thread_;
     std::atomic<bool> running_;
     
     // Packet queues
-    std::queue<Packet> outgoing_packets_;
+    std::queue<protocol::Packet> outgoing_packets_;
     std::mutex outgoing_mutex_;
 
     // Connection state
+    ConnectionHandshake handshake_;
     std::atomic<bool> connected_;
     mutable std::mutex heartbeat_mutex_;
     std::chrono::steady_clock::time_point last_heartbeat_;
 
     // Thread functions
     void receiveLoop();
-    void handleIncomingPacket(const Packet& packet);
-    void sendPacket(const Packet& packet);
-    void sendTelemetry();
-    void sendHeartbeat();
+    void handleIncomingPacket(const protocol::Packet& packet, const struct sockaddr_in& sender);
+    void sendPacket(const protocol::Packet& packet);
 
     // Helper functions
     bool setupSocket();
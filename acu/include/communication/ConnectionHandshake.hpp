@@ -0,0 +1,77 @@
+#pragma once
+
+#include "protocol/Packet.hpp"
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace drone {
+namespace communication {
+
+// Drone side of the BEACON/SYN/ACK/SYNACK handshake.
+//
+// BEACON and SYN are sent back to back so the ground station can assign an
+// address on the first datagram it sees; the connection is up one round trip
+// after the first transmission. Retransmissions are driven by poll() from the
+// caller's loop with a short, exponentially growing interval - nothing blocks.
+class ConnectionHandshake {
+public:
+    enum class State {
+        DISCONNECTED,
+        DISCOVERY,    // BEACON + SYN outstanding
+        CONNECTED,    // ACK received, SYNACK sent, waiting for GCU traffic
+        ACTIVE        // GCU traffic seen after SYNACK
+    };
+
+    using Clock = std::chrono::steady_clock;
+    using SendFunction = std::function<void(const protocol::Packet&)>;
+
+    ConnectionHandshake(const std::string& droneId, SendFunction send);
+
+    // Start a new session (new request token) and transmit immediately
+    void reset(Clock::time_point now);
+
+    // Retransmit whatever is outstanding once its deadline has passed
+    void poll(Clock::time_point now);
+
+    // The ACK answers this drone's current request; lets the caller learn
+    // the sender's address before handleAck() transmits the SYNACK
+    bool matchesAck(const protocol::AckData& ack) const;
+
+    // Incoming packet handlers, return true if the packet was accepted
+    bool handleAck(const protocol::AckData& ack, Clock::time_point now);
+    void handlePeerTraffic();
+
+    // Status
+    State getState() const;
+    bool isConnected() const;
+    uint32_t getAssignedAddress() const;
+    uint64_t getSessionToken() const;
+
+    static std::string defaultDroneId();
+
+private:
+    static constexpr auto INITIAL_RETRY_INTERVAL = std::chrono::milliseconds(50);
+    static constexpr auto MAX_RETRY_INTERVAL = std::chrono::milliseconds(1000);
+    static constexpr uint32_t CAPABILITIES = 0x00000001;  // Fixed-wing control + telemetry
+    static constexpr uint16_t FIRMWARE_VERSION = 0x0100;
+
+    char droneId_[protocol::DRONE_ID_LENGTH];
+    SendFunction send_;
+
+    mutable std::mutex mutex_;
+    State state_;
+    uint64_t requestToken_;
+    uint64_t sessionToken_;
+    uint32_t assignedAddress_;
+    Clock::duration retryInterval_;
+    Clock::time_point nextTransmit_;
+
+    void transmitLocked(Clock::time_point now);
+    void scheduleRetryLocked(Clock::time_point now);
+    static uint64_t generateToken();
+};
+
+} // namespace communication
+} // namespace drone
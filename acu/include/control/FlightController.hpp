@@ -1,11 +1,16 @@
 #pragma once
 
 #include "Config.hpp"
+#include "control/Mixer.hpp"
 #include "control/PWMController.hpp"
-#include "sensors/SensorManager.hpp"
-#include "protocol/Packet.hpp"
+#include "control/PidBank.hpp"
+#include "runtime/Topic.hpp"
+#include "sensors/SensorSnapshot.hpp"
+#include "topics/Topics.hpp"
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <ostream>
 
 namespace drone {
 namespace control {
@@ -19,67 +24,77 @@ public:
     bool init();
     void start();
     void stop();
-    void update();
+
+    // Control loops, each run by its own scheduler task with the tick's
+    // sensor snapshot and the measured time since its previous run. Pilot
+    // commands arrive on the control_setpoint topic; the resulting PWM
+    // values go out on actuator_outputs.
+    void updateAttitude(const sensors::SensorSnapshot& snapshot, float dt);
+    void updateAltitude(const sensors::SensorSnapshot& snapshot, float dt);
+
+    // Sends the staged PWM values to the hardware; run once per PWM frame
+    // (PWMController::FRAME_RATE_HZ), armed or not
+    void commitOutputs();
 
     // Control methods
-    void setControlInputs(const protocol::ControlData& control);
     void emergencyStop();
 
     // Status
     bool isArmed() const { return armed_; }
-    protocol::TelemetryData getTelemetryData() const;
 
-    // Component setters
-    void setSensorManager(sensors::SensorManager* manager) { sensorManager_ = manager; }
+    // PID bank cost per update
+    struct PidStatistics {
+        uint64_t updates{0};
+        int64_t maxNs{0};
+        int64_t meanNs{0};
+    };
+    PidStatistics getPidStatistics() const;
+    void report(std::ostream& out) const;
 
 private:
     // Components
     std::unique_ptr<PWMController> pwm_;
-    sensors::SensorManager* sensorManager_;
+    Mixer mixer_;
+    bool airframeKnown_;
+    runtime::Subscription<topics::ControlSetpointTopic> setpointSubscription_;
 
     // State
     bool armed_;
     bool emergencyMode_;
 
-    // Control parameters
-    struct {
-        float rollKp{1.0f}, rollKi{0.0f}, rollKd{0.2f};
-        float pitchKp{1.0f}, pitchKi{0.0f}, pitchKd{0.2f};
-        float yawKp{2.0f}, yawKi{0.0f}, yawKd{0.0f};
-        float altitudeKp{1.0f}, altitudeKi{0.1f}, altitudeKd{0.1f};
-    } pid_;
-
     // Control targets
     struct {
         float roll{0}, pitch{0}, yaw{0};
-        float altitude{0};
+        float altitude{0};     // m above the takeoff ground, latched by altitude hold
         uint16_t thrust{0};
     } target_;
 
-    // PID state
-    struct PIDState {
-        float lastError{0};
-        float integral{0};
-    };
+    // Roll, pitch and yaw share one bank at the attitude rate; altitude
+    // runs alone at its own rate
+    enum : size_t { ROLL = 0, PITCH = 1, YAW = 2, ALTITUDE = 0 };
+    PidBank attitudePid_;
+    PidBank altitudePid_;
+    float thrustCorrection_;   // PWM counts from altitude hold, mixed at the attitude rate
+    bool altitudeHold_;        // target_.altitude holds the height to keep
 
-    struct {
-        PIDState roll, pitch, yaw, altitude;
-    } pidState_;
+    uint64_t pidUpdates_;
+    int64_t pidTotalNs_;
+    int64_t pidMaxNs_;
+    void recordPidTime(int64_t elapsedNs);
 
     // Thread safety
     mutable std::mutex mutex_;
 
     // Control methods
-    void updateAttitudeControl();
-    void updateAltitudeControl();
-    void applyMotorOutputs(float rollOutput, float pitchOutput, 
-                          float yawOutput, float altitudeOutput);
-
-    // PID control
-    float updatePID(PIDState& state, float error, float kp, float ki, float kd, float dt);
+    void updateAttitudeControl(const sensors::SensorSnapshot& snapshot, float dt);
+    void updateAltitudeControl(const sensors::SensorSnapshot& snapshot, float dt);
+    void applyControlSetpoint(const topics::ControlSetpoint& setpoint);
+    void applyMotorOutputs(float rollOutput, float pitchOutput,
+                          float yawOutput, float thrust);
+    void publishOutputs();
 
     // Safety checks
-    bool performSafetyChecks() const;
+    bool performSafetyChecks(const sensors::SensorSnapshot& snapshot) const;
     void handleSafetyViolation();
 };
 
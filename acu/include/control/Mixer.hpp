@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace drone {
+namespace control {
+
+// Maps roll, pitch, yaw and thrust demands onto the PWM channels of an
+// airframe. An airframe is a constexpr table: one row of axis weights per
+// output plus the output's range. Every airframe runs the same fixed-size
+// multiply-add pass, so adding one adds a table, not a branch.
+//
+// When the attitude demands would drive an output past its range, all
+// three attitude axes are scaled down together until the output fits,
+// which keeps the ratio between them (and so the direction of the
+// correction). Thrust is not scaled; it only gives way at the range end.
+class Mixer {
+public:
+    enum Axis : size_t { ROLL = 0, PITCH = 1, YAW = 2, THRUST = 3, AXES = 4 };
+    static constexpr size_t OUTPUTS = 4;   // PWM channels, in PWMController order
+
+    struct Output {
+        float weights[AXES];
+        float minimum, maximum;   // Range of the mixed value
+        float center;             // PWM counts at a mixed value of 0
+        float scale;              // PWM counts per unit of mixed value
+    };
+
+    struct Airframe {
+        const char* name;
+        Output outputs[OUTPUTS];
+    };
+
+    // Attitude demands in [-1, 1], thrust in [0, 1]
+    struct Demand {
+        float axes[AXES];
+    };
+
+    explicit Mixer(const Airframe& airframe);
+
+    // Airframe by name, nullptr if unknown
+    static const Airframe* find(const std::string& name);
+
+    const char* getName() const { return name_; }
+
+    // PWM counts (0-4095) for every output
+    void mix(const Demand& demand, std::array<uint16_t, OUTPUTS>& outputs) const;
+
+    // Outputs with no demand: surfaces centered, motor off
+    void idle(std::array<uint16_t, OUTPUTS>& outputs) const;
+
+private:
+    const char* name_;
+    Output outputs_[OUTPUTS];
+};
+
+// Airframe tables. Channel order is MOTOR, ELEVATOR, RUDDER, AILERONS as
+// wired; airframes with other surfaces reuse those channels.
+namespace airframes {
+
+constexpr Mixer::Output MOTOR_ONLY = {{0.0f, 0.0f, 0.0f, 1.0f}, 0.0f, 1.0f, 0.0f, 4095.0f};
+constexpr Mixer::Output UNUSED = {{0.0f, 0.0f, 0.0f, 0.0f}, -1.0f, 1.0f, 2048.0f, 2047.0f};
+
+constexpr Mixer::Output surface(float roll, float pitch, float yaw) {
+    return {{roll, pitch, yaw, 0.0f}, -1.0f, 1.0f, 2048.0f, 2047.0f};
+}
+
+// Ailerons, elevator and rudder, one surface per axis
+constexpr Mixer::Airframe CONVENTIONAL = {"conventional", {
+    MOTOR_ONLY,
+    surface(0.0f, 1.0f, 0.0f),
+    surface(0.0f, 0.0f, 1.0f),
+    surface(1.0f, 0.0f, 0.0f),
+}};
+
+// Left elevon on the elevator channel, right elevon on the aileron channel;
+// yaw has no surface
+constexpr Mixer::Airframe FLYING_WING = {"flying_wing", {
+    MOTOR_ONLY,
+    surface(1.0f, 1.0f, 0.0f),
+    UNUSED,
+    surface(-1.0f, 1.0f, 0.0f),
+}};
+
+// Left ruddervator on the elevator channel, right on the rudder channel
+constexpr Mixer::Airframe V_TAIL = {"v_tail", {
+    MOTOR_ONLY,
+    surface(0.0f, 1.0f, 1.0f),
+    surface(0.0f, 1.0f, -1.0f),
+    surface(1.0f, 0.0f, 0.0f),
+}};
+
+constexpr const Mixer::Airframe* ALL[] = {&CONVENTIONAL, &FLYING_WING, &V_TAIL};
+
+} // namespace airframes
+
+} // namespace control
+} // namespace drone
@@ -1,11 +1,19 @@
 #pragma once
 
+#include "Config.hpp"
+#include "hal/PwmOutput.hpp"
+#include <cstddef>
 #include <cstdint>
 #include <array>
+#include <memory>
 
 namespace drone {
 namespace control {
 
+// Servo and ESC outputs. The control loops stage values as often as they
+// run; commit() sends them to the PWM backend once per servo frame, and
+// only when a pulse width has changed, since the outputs cannot pick up a
+// new value more often than that anyway.
 class PWMController {
 public:
     // PWM channels
@@ -15,40 +23,61 @@ public:
         RUDDER = 2,
         AILERONS = 3
     };
+    static constexpr size_t CHANNELS = 4;
+    static constexpr uint32_t FRAME_RATE_HZ = 50;   // Servo frame rate
 
-    PWMController();
+    // Backend selected by config.pwm_backend
+    explicit PWMController(const Config& config);
+    explicit PWMController(std::unique_ptr<hal::PwmOutput> output);
     ~PWMController();
 
     // Initialization
     bool init();
 
-    // PWM control (input range 0-4095)
+    // PWM control (input range 0-4095). Staged until the next commit().
     void setOutput(Channel channel, uint16_t value);
     uint16_t getOutput(Channel channel) const;
 
-    // Emergency stop
+    // Every channel in one call, indexed by Channel
+    void setOutputs(const std::array<uint16_t, CHANNELS>& values);
+
+    // Writes the staged outputs as one frame if they differ from the last
+    // frame written. Call once per frame.
+    bool commit();
+
+    // All outputs off, written immediately
     void emergencyStop();
 
+    struct Statistics {
+        uint64_t commits{0};
+        uint64_t frames{0};      // Written to the backend
+        uint64_t unchanged{0};   // Skipped: same as the previous frame
+        uint64_t errors{0};
+    };
+    Statistics getStatistics() const { return stats_; }
+
 private:
-    // PWM configuration
-    static constexpr int PWM_FREQUENCY = 50;  // 50Hz for servos
-    static constexpr int PWM_RANGE = 4096;    // 12-bit resolution
-    
-    // GPIO pins for each channel
-    static constexpr std::array<int, 4> PWM_PINS = {18, 19, 20, 21};
-    
-    // Current output values
-    std::array<uint16_t, 4> currentValues_;
-    
     // Servo limits (in microseconds)
     static constexpr int SERVO_MIN_US = 1000;  // 1ms
     static constexpr int SERVO_MAX_US = 2000;  // 2ms
-    
+
+    static std::unique_ptr<hal::PwmOutput> createOutput(const Config& config);
+
+    std::unique_ptr<hal::PwmOutput> output_;
+    bool open_;
+
+    // Staged output values and their pulse widths, and the pulse widths
+    // the backend last accepted
+    std::array<uint16_t, CHANNELS> currentValues_;
+    std::array<uint16_t, CHANNELS> pulses_;
+    std::array<uint16_t, CHANNELS> written_;
+    bool frameWritten_;   // written_ holds what the hardware outputs
+
+    Statistics stats_;
+
     // Utility functions
-    void setupPWMPin(int pin);
-    uint16_t scaleToPWM(uint16_t value) const;
-    void writePWM(int pin, uint16_t value);
+    uint16_t scaleToPulse(uint16_t value) const;
 };
 
 } // namespace control
-} // namespace drone 
\ No newline at end of file
+} // namespace drone
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace drone {
+namespace control {
+
+// PID controllers for up to LANES axes that share a loop, updated together.
+// Gains and state are stored as one array per field, so update() is a
+// single fixed-length pass the compiler can keep in vector registers.
+//
+// Each lane has:
+// - derivative on measurement (no kick on setpoint steps) through a
+//   first-order low-pass
+// - conditional integration: the integrator holds while the output is
+//   saturated and the error would push it further
+// - output clamping, then a slew limit on how fast the output may move
+//
+// dt is the measured time since the previous update. Unused lanes have
+// zero gains and output zero.
+class PidBank {
+public:
+    static constexpr size_t LANES = 4;
+
+    struct Gains {
+        float kp{0}, ki{0}, kd{0};
+        float derivativeCutoffHz{20.0f};
+        float integralLimit{20.0f};     // On the integrated error
+        float outputLimit{1.0f};        // Symmetric
+        float slewRate{0.0f};           // Output units per second, 0 disables
+        float wrap{0.0f};               // Period of an angular input (360), 0 for none;
+                                        // inputs must lie within one period
+    };
+
+    PidBank();
+
+    void configure(size_t lane, const Gains& gains);
+
+    // Clears integrators and filter state; the next update starts fresh
+    void reset();
+
+    // setpoint, measurement and output hold LANES values
+    void update(const float* setpoint, const float* measurement, float dt, float* output);
+
+private:
+    static constexpr float MAX_DT = 0.1f;   // Longer gaps are treated as this
+    static constexpr float SUBNORMAL_GUARD = 1e-20f;   // Far below any real rate
+
+    alignas(16) float kp_[LANES];
+    alignas(16) float ki_[LANES];
+    alignas(16) float kd_[LANES];
+    alignas(16) float tau_[LANES];           // Derivative filter time constant
+    alignas(16) float integralLimit_[LANES];
+    alignas(16) float outputLimit_[LANES];
+    alignas(16) float slewRate_[LANES];
+    alignas(16) float wrap_[LANES];
+    alignas(16) float halfWrap_[LANES];
+
+    alignas(16) float integral_[LANES];
+    alignas(16) float derivative_[LANES];
+    alignas(16) float lastMeasurement_[LANES];
+    alignas(16) float lastOutput_[LANES];
+    bool primed_;
+};
+
+} // namespace control
+} // namespace drone
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "math/Matrix.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace drone {
+namespace estimation {
+
+// Kalman filter on the vertical channel. IMU vertical acceleration drives
+// the prediction at the IMU rate; ultrasonic range (height above the
+// takeoff ground) and GPS altitude correct it as they arrive.
+//
+// State: height above the takeoff ground, climb rate, accelerometer bias
+// and the offset between GPS altitude and that height. Near the ground the
+// range sensor pins the height and the GPS offset is learned; higher up
+// the GPS carries the height through the learned offset. The first GPS fix
+// sets the offset directly; later fixes are gated against it.
+//
+// Measurements are stamped with when they were taken. A bounded history of
+// predicted states lets a late measurement be compared against the state
+// at its own time; the correction is then applied to the current state.
+//
+// Not thread-safe; one thread predicts and fuses.
+class AltitudeEstimator {
+public:
+    struct Noise {
+        float accel{0.5f};            // m/s^2/sqrt(Hz), including airframe vibration
+        float accelBiasWalk{0.01f};   // m/s^3/sqrt(Hz)
+        float gpsOffsetWalk{0.05f};   // m/sqrt(s), slow drift of GPS altitude
+        float gps{3.0f};              // m, when the receiver reports no accuracy
+        float range{0.05f};           // m
+    };
+
+    struct Estimate {
+        float height{0};          // m above the takeoff ground
+        float climbRate{0};       // m/s, up positive
+        float altitude{0};        // m above mean sea level once GPS is fused, else height
+        float accelBias{0};       // m/s^2
+        int64_t timestampNs{0};   // Time of the last prediction
+        bool absolute{false};     // altitude is referenced to GPS
+    };
+
+    struct Statistics {
+        uint64_t gpsFused{0};
+        uint64_t gpsRejected{0};
+        uint64_t rangeFused{0};
+        uint64_t rangeRejected{0};
+        uint64_t stale{0};        // Measurements older than the history
+    };
+
+    AltitudeEstimator();
+    explicit AltitudeEstimator(const Noise& noise);
+
+    void reset();
+
+    // Propagates with one IMU sample of vertical acceleration (m/s^2, up
+    // positive, gravity removed)
+    void predict(float verticalAccel, int64_t timestampNs);
+
+    // Return false if the measurement was gated out or predates the history.
+    // accuracy <= 0 selects the default GPS noise.
+    bool fuseGps(float altitude, float accuracy, int64_t measuredNs);
+    bool fuseRange(float height, int64_t measuredNs);
+
+    Estimate getEstimate() const;
+    const Statistics& getStatistics() const { return stats_; }
+
+private:
+    using Vector4 = math::Vector<4>;
+    using Matrix4 = math::Matrix<float, 4, 4>;
+
+    enum : size_t { HEIGHT = 0, VELOCITY = 1, BIAS = 2, GPS_OFFSET = 3 };
+
+    struct HistoryEntry {
+        int64_t timestampNs;
+        float height;
+    };
+
+    static constexpr size_t HISTORY_SIZE = 512;            // 0.5s at 1kHz
+    static constexpr float GATE_SIGMA = 5.0f;
+    static constexpr int GPS_RESET_REJECTIONS = 10;        // Then re-anchor the GPS offset
+    static constexpr float MAX_PREDICT_DT = 0.05f;
+    static constexpr float INITIAL_VELOCITY_SIGMA = 0.1f;  // m/s
+    static constexpr float INITIAL_BIAS_SIGMA = 0.5f;      // m/s^2
+    static constexpr float INITIAL_OFFSET_SIGMA = 100.0f;  // m, until the first fix sets it
+
+    bool heightAt(int64_t timestampNs, float& height) const;
+    void anchorGpsOffset(float altitude, float height, float sigma);
+    bool fuse(const Vector4& observation, float innovation, float variance);
+
+    Noise noise_;
+    Vector4 state_;
+    Matrix4 covariance_;
+    int64_t lastPredictNs_;
+    bool initialized_;
+    bool absolute_;
+    int gpsRejections_;
+
+    HistoryEntry history_[HISTORY_SIZE];
+    size_t historyCount_;
+    size_t historyNext_;
+
+    Statistics stats_;
+};
+
+} // namespace estimation
+} // namespace drone
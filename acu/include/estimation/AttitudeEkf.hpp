@@ -0,0 +1,49 @@
+#pragma once
+
+#include "estimation/AttitudeEstimator.hpp"
+
+namespace drone {
+namespace estimation {
+
+// Error-state Kalman filter on attitude and gyro bias. The nominal state
+// (quaternion, bias) is propagated with the gyro; a 6-element error state
+// (small body-frame rotation, bias error) carries the covariance and is
+// folded back into the nominal state after each accelerometer update.
+// Yaw is unobservable without a heading reference and only integrates.
+class AttitudeEkf : public AttitudeEstimator {
+public:
+    struct Noise {
+        float gyro{0.005f};        // rad/s/sqrt(Hz)
+        float gyroBiasWalk{1e-4f}; // rad/s^2/sqrt(Hz)
+        float accel{0.05f};        // g, including airframe vibration
+    };
+
+    AttitudeEkf();
+    explicit AttitudeEkf(const Noise& noise);
+
+    void initialize(const math::Vector3& accel) override;
+    void update(const math::Vector3& gyro, const math::Vector3& accel, float dt) override;
+
+    math::Quaternion getAttitude() const override { return attitude_; }
+    math::Vector3 getGyroBias() const override { return bias_; }
+
+private:
+    using Matrix6 = math::Matrix<float, 6, 6>;
+    using Matrix36 = math::Matrix<float, 3, 6>;
+    using Matrix63 = math::Matrix<float, 6, 3>;
+
+    static constexpr float ACCEL_TOLERANCE = 0.15f;   // Skip updates beyond 1g +/- 15%
+    static constexpr float INITIAL_ANGLE_SIGMA = 0.1f;    // rad
+    static constexpr float INITIAL_BIAS_SIGMA = 0.05f;    // rad/s
+
+    void predict(const math::Vector3& gyro, float dt);
+    void correct(const math::Vector3& accel);
+
+    Noise noise_;
+    math::Quaternion attitude_;
+    math::Vector3 bias_;
+    Matrix6 covariance_;
+};
+
+} // namespace estimation
+} // namespace drone
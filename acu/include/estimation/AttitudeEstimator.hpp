@@ -0,0 +1,40 @@
+#pragma once
+
+#include "math/Matrix.hpp"
+#include "math/Quaternion.hpp"
+
+namespace drone {
+namespace estimation {
+
+// Fuses gyro and accelerometer samples into an attitude quaternion.
+// Gyro in rad/s, accel in g, both in the body frame.
+class AttitudeEstimator {
+public:
+    virtual ~AttitudeEstimator() = default;
+
+    // Level the estimate from a resting accelerometer reading, yaw zero
+    virtual void initialize(const math::Vector3& accel) = 0;
+    virtual void update(const math::Vector3& gyro, const math::Vector3& accel, float dt) = 0;
+
+    virtual math::Quaternion getAttitude() const = 0;
+    virtual math::Vector3 getGyroBias() const = 0;
+
+protected:
+    static math::Quaternion levelFromAccel(const math::Vector3& accel) {
+        float roll = math::fastAtan2(accel[1], accel[2]);
+        float pitch = math::fastAtan2(-accel[0],
+            std::sqrt(accel[1] * accel[1] + accel[2] * accel[2]));
+        return math::Quaternion::fromEuler(roll, pitch, 0.0f);
+    }
+
+    // Accelerometer readings far from 1g are dominated by manoeuvring and
+    // say little about the gravity direction
+    static bool isNearOneG(const math::Vector3& accel, float tolerance) {
+        float norm2 = math::dot(accel, accel);
+        return norm2 > (1.0f - tolerance) * (1.0f - tolerance) &&
+               norm2 < (1.0f + tolerance) * (1.0f + tolerance);
+    }
+};
+
+} // namespace estimation
+} // namespace drone
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "estimation/AttitudeEstimator.hpp"
+
+namespace drone {
+namespace estimation {
+
+// Mahony nonlinear complementary filter: the cross product between the
+// measured and predicted gravity directions drives a PI correction of the
+// gyro rate before it is integrated into the quaternion.
+class MahonyFilter : public AttitudeEstimator {
+public:
+    explicit MahonyFilter(float kp = 1.0f, float ki = 0.02f);
+
+    void initialize(const math::Vector3& accel) override;
+    void update(const math::Vector3& gyro, const math::Vector3& accel, float dt) override;
+
+    math::Quaternion getAttitude() const override { return attitude_; }
+    math::Vector3 getGyroBias() const override { return -integral_; }
+
+private:
+    static constexpr float ACCEL_TOLERANCE = 0.2f;  // Skip correction beyond 1g +/- 20%
+
+    const float kp_;
+    const float ki_;
+    math::Quaternion attitude_;
+    math::Vector3 integral_;
+};
+
+} // namespace estimation
+} // namespace drone
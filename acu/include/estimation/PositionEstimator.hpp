@@ -0,0 +1,122 @@
+#pragma once
+
+#include "math/Matrix.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace drone {
+namespace estimation {
+
+// Horizontal dead reckoning. Level-frame acceleration from the attitude
+// estimate drives the prediction at the IMU rate; GPS position and velocity
+// correct it at the fix rate, so navigation sees a smooth position between
+// fixes instead of a 10Hz staircase.
+//
+// North and east are independent Kalman filters on position, velocity and
+// accelerometer bias, in meters from a local origin the caller chooses.
+//
+// The attitude estimate has no heading reference, so its level frame is at
+// an unknown rotation from north. alignHeading() learns that rotation from
+// the GPS course while the airframe flies forward; until then accelerations
+// are not used and the filter runs as a constant-velocity smoother.
+//
+// Like AltitudeEstimator, fixes are compared against a history of predicted
+// states at the time they were measured. Not thread-safe.
+class PositionEstimator {
+public:
+    struct Noise {
+        float accel{0.5f};            // m/s^2/sqrt(Hz), aligned
+        float unalignedAccel{2.0f};   // m/s^2/sqrt(Hz), unmodelled manoeuvres
+        float accelBiasWalk{0.02f};   // m/s^3/sqrt(Hz), also absorbs heading error
+        float gpsPosition{3.0f};      // m, when the receiver reports no accuracy
+        float gpsVelocity{0.3f};      // m/s
+    };
+
+    struct Estimate {
+        float north{0}, east{0};                  // m from the local origin
+        float velocityNorth{0}, velocityEast{0};  // m/s
+        int64_t timestampNs{0};                   // Time of the last prediction
+        bool valid{false};                        // A fix has been fused
+        bool aligned{false};                      // Accelerations in use
+    };
+
+    struct Statistics {
+        uint64_t positionFused{0};
+        uint64_t positionRejected{0};
+        uint64_t velocityFused{0};
+        uint64_t velocityRejected{0};
+        uint64_t stale{0};        // Fixes older than the history
+        uint64_t resets{0};       // Re-initialized from GPS after persistent rejection
+    };
+
+    PositionEstimator();
+    explicit PositionEstimator(const Noise& noise);
+
+    void reset();
+
+    // Propagates with one IMU sample of horizontal acceleration in the
+    // attitude estimator's level frame (m/s^2, gravity removed)
+    void predict(float accelX, float accelY, int64_t timestampNs);
+
+    // Returns false if the fix was gated out or predates the history.
+    // accuracy <= 0 selects the default GPS noise.
+    bool fuseGps(float north, float east, float velocityNorth, float velocityEast,
+                 float accuracy, int64_t measuredNs);
+
+    // Pairs the level-frame yaw with the GPS course (both radians, course
+    // clockwise from north) while moving forward at speed
+    void alignHeading(float yaw, float course);
+
+    Estimate getEstimate() const;
+    const Statistics& getStatistics() const { return stats_; }
+
+private:
+    using Matrix3 = math::Matrix3;
+    using Vector3 = math::Vector3;
+
+    enum : size_t { NORTH = 0, EAST = 1, AXES = 2 };
+    enum : size_t { POSITION = 0, VELOCITY = 1, BIAS = 2 };
+
+    struct Axis {
+        Vector3 state;
+        Matrix3 covariance;
+    };
+
+    struct HistoryEntry {
+        int64_t timestampNs;
+        float position[AXES];
+        float velocity[AXES];
+    };
+
+    static constexpr size_t HISTORY_SIZE = 512;            // 0.5s at 1kHz
+    static constexpr float GATE_SIGMA = 5.0f;
+    static constexpr int GPS_RESET_REJECTIONS = 10;        // Then restart from the fix
+    static constexpr float MAX_PREDICT_DT = 0.05f;
+    static constexpr float INITIAL_BIAS_SIGMA = 0.3f;      // m/s^2
+    static constexpr float HEADING_ALIGN_GAIN = 0.05f;     // Per fix, smooths crab angle
+
+    void initialize(float north, float east, float velocityNorth, float velocityEast,
+                    float sigma);
+    bool stateAt(int64_t timestampNs, HistoryEntry& entry) const;
+    bool fuse(Axis& axis, size_t index, float innovation, float variance);
+
+    Noise noise_;
+    Axis axes_[AXES];
+    int64_t lastPredictNs_;
+    bool valid_;
+    int gpsRejections_;
+
+    // Level frame to north/east, as the unit vector of the rotation angle
+    bool aligned_;
+    float headingCos_;
+    float headingSin_;
+
+    HistoryEntry history_[HISTORY_SIZE];
+    size_t historyCount_;
+    size_t historyNext_;
+
+    Statistics stats_;
+};
+
+} // namespace estimation
+} // namespace drone
@@ -0,0 +1,23 @@
+#pragma once
+
+namespace drone {
+namespace filters {
+
+// Normalised biquad coefficients (a0 == 1) for the difference equation
+// y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2].
+// Designs follow the RBJ audio EQ cookbook and are computed at runtime
+// from the cutoff and the actual sample rate.
+struct BiquadCoefficients {
+    float b0{1.0f}, b1{0.0f}, b2{0.0f};
+    float a1{0.0f}, a2{0.0f};
+
+    static BiquadCoefficients passThrough() { return BiquadCoefficients(); }
+    static BiquadCoefficients lowPass(float cutoffHz, float sampleRateHz, float q = 0.70710678f);
+    static BiquadCoefficients notch(float centerHz, float sampleRateHz, float q);
+
+    // Gain at DC, used to start a filter settled on its first input
+    float dcGain() const { return (b0 + b1 + b2) / (1.0f + a1 + a2); }
+};
+
+} // namespace filters
+} // namespace drone
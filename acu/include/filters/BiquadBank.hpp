@@ -0,0 +1,58 @@
+#pragma once
+
+#include "filters/Biquad.hpp"
+#include <array>
+#include <cstddef>
+
+namespace drone {
+namespace filters {
+
+// Cascaded biquads over the six IMU channels (accel XYZ, gyro XYZ), stored
+// structure-of-arrays so each stage updates all channels with a few vector
+// operations: NEON on ARM, SSE on x86, plain loops elsewhere. Channels are
+// padded to eight lanes. Each channel can have its own coefficients.
+class BiquadBank {
+public:
+    static constexpr size_t CHANNELS = 6;
+    static constexpr size_t MAX_STAGES = 4;
+
+    enum Channel : size_t {
+        ACCEL_X = 0, ACCEL_Y, ACCEL_Z,
+        GYRO_X, GYRO_Y, GYRO_Z
+    };
+
+    BiquadBank();
+
+    // Configure one stage for channels [first, first + count). Filter state
+    // is kept, so coefficients can be retuned while running.
+    void setStage(size_t stage, size_t first, size_t count, const BiquadCoefficients& coefficients);
+    void clearStage(size_t stage);
+
+    // Settle every stage on a constant input instead of starting from zero
+    void prime(const float input[CHANNELS]);
+    void reset();
+
+    void process(const float input[CHANNELS], float output[CHANNELS]);
+
+private:
+    static constexpr size_t LANES = 8;
+
+    struct alignas(16) Stage {
+        float b0[LANES];
+        float b1[LANES];
+        float b2[LANES];
+        float a1[LANES];
+        float a2[LANES];
+        float s1[LANES];   // Transposed direct form II state
+        float s2[LANES];
+    };
+
+    void updateActiveStages();
+
+    std::array<Stage, MAX_STAGES> stages_;
+    std::array<bool, MAX_STAGES> configured_;
+    size_t activeStages_;
+};
+
+} // namespace filters
+} // namespace drone
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace drone {
+namespace filters {
+
+// Streaming gyro spectrum analyzer for dynamic notch tracking. Samples are
+// pushed at the IMU rate into per-axis capture buffers; every HOP samples
+// one axis (round robin) is transformed with a 256-point radix-2 FFT. The
+// transform is split into small steps, one per step() call, so the cost per
+// control tick stays bounded. Tables are precomputed and nothing allocates.
+class SpectrumAnalyzer {
+public:
+    static constexpr size_t AXES = 3;
+    static constexpr size_t FFT_SIZE = 256;
+    static constexpr size_t BINS = FFT_SIZE / 2;
+    static constexpr size_t HOP = 64;          // New samples between transforms
+    static constexpr size_t MAX_PEAKS = 2;
+
+    struct Peak {
+        float frequency{0.0f};   // Hz, smoothed across transforms
+        float magnitude{0.0f};
+    };
+
+    struct Result {
+        uint32_t sequence{0};              // Transforms completed for this axis
+        size_t peakCount{0};
+        std::array<Peak, MAX_PEAKS> peaks; // Frequency 0 marks an empty slot;
+                                           // a slot keeps following one peak
+        std::array<float, BINS> magnitude; // Linear, input units
+    };
+
+    SpectrumAnalyzer(float sampleRateHz, float minFrequencyHz, float maxFrequencyHz);
+
+    // Once per IMU sample, constant time
+    void push(const float gyro[AXES]);
+
+    // Advance the current transform by one step. Returns true when a
+    // transform finished; lastAxis() says which axis it was.
+    bool step();
+
+    const Result& getResult(size_t axis) const { return results_[axis]; }
+    size_t lastAxis() const { return lastAxis_; }
+
+    float getBinWidth() const { return binWidth_; }
+    size_t getMinBin() const { return minBin_; }
+    size_t getMaxBin() const { return maxBin_; }
+
+private:
+    enum class Phase {
+        IDLE,
+        BUTTERFLY,
+        ANALYZE
+    };
+
+    static constexpr size_t STAGES = 8;           // log2(FFT_SIZE)
+    static constexpr float PEAK_THRESHOLD = 3.0f; // Peak must exceed the band mean by this
+    static constexpr float SMOOTHING = 0.5f;      // Frequency tracking filter
+    static constexpr int PEAK_HOLD = 3;           // Transforms a lost peak is kept for
+    static constexpr float MATCH_TOLERANCE_HZ = 15.0f;   // Furthest a tracked peak moves per transform
+
+    void load();
+    void butterflyStage(size_t stage);
+    void analyze();
+
+    const float binWidth_;
+    const size_t minBin_;
+    const size_t maxBin_;
+
+    // Precomputed tables
+    std::array<float, FFT_SIZE> window_;
+    std::array<float, BINS> cosTable_;
+    std::array<float, BINS> sinTable_;
+    std::array<uint16_t, FFT_SIZE> bitReverse_;
+
+    // Capture
+    std::array<std::array<float, FFT_SIZE>, AXES> capture_;
+    size_t writeIndex_;
+    size_t pending_;
+
+    // Transform in progress
+    Phase phase_;
+    size_t stage_;
+    size_t axis_;
+    std::array<float, FFT_SIZE> real_;
+    std::array<float, FFT_SIZE> imag_;
+
+    std::array<Result, AXES> results_;
+    std::array<std::array<int, MAX_PEAKS>, AXES> missed_;
+    size_t lastAxis_;
+};
+
+} // namespace filters
+} // namespace drone
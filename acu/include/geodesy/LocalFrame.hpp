@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+
+namespace drone {
+namespace geodesy {
+
+// Meters east, north and up of a local origin
+struct Enu {
+    float east{0};
+    float north{0};
+    float up{0};
+};
+
+// Local tangent plane at a fixed origin (the home point) on the WGS-84
+// ellipsoid. The origin's radii of curvature are computed once, so each
+// conversion is a subtraction and a few multiply-adds with no trigonometry.
+// The east scale is corrected to first order in latitude and north for the
+// curvature of parallels, which keeps the error against the exact tangent
+// plane to about a decimeter within 10 km of home. Up is the altitude
+// difference; it ignores the 8 m the ground falls away over 10 km.
+//
+// Distances in the plane are floats: a millimeter at 10 km. Geodetic
+// coordinates stay double, as float degrees are only good to ~1 m.
+class LocalFrame {
+public:
+    LocalFrame();
+
+    void setOrigin(double latitude, double longitude, float altitude);
+    bool hasOrigin() const { return hasOrigin_; }
+    double getOriginLatitude() const { return originLatitude_; }
+    double getOriginLongitude() const { return originLongitude_; }
+    float getOriginAltitude() const { return originAltitude_; }
+
+    // Degrees and meters above mean sea level
+    Enu toEnu(double latitude, double longitude, float altitude) const {
+        const double dLat = latitude - originLatitude_;
+        const double dLon = longitude - originLongitude_;
+        Enu point;
+        point.east = static_cast<float>(dLon * (eastScale_ + eastScaleSlope_ * dLat));
+        point.north = static_cast<float>(dLat * northScale_ + dLon * dLon * northCurvature_);
+        point.up = altitude - originAltitude_;
+        return point;
+    }
+
+    void toGeodetic(const Enu& point, double& latitude, double& longitude, float& altitude) const {
+        // One fixed-point step resolves the coupling between the two terms
+        double dLat = point.north / northScale_;
+        double dLon = point.east / (eastScale_ + eastScaleSlope_ * dLat);
+        dLat = (point.north - dLon * dLon * northCurvature_) / northScale_;
+        dLon = point.east / (eastScale_ + eastScaleSlope_ * dLat);
+        latitude = originLatitude_ + dLat;
+        longitude = originLongitude_ + dLon;
+        altitude = originAltitude_ + point.up;
+    }
+
+    // Horizontal distance (m) and bearing (degrees clockwise from north,
+    // 0 to 360) from one point to each of count targets. Targets are in
+    // separate east and north arrays and the loop has no branches, so it
+    // vectorizes; one call covers a whole waypoint list.
+    static void rangeAndBearing(float east, float north, const float* targetEast,
+                                const float* targetNorth, size_t count,
+                                float* range, float* bearing);
+
+private:
+    double originLatitude_;
+    double originLongitude_;
+    float originAltitude_;
+    double northScale_;       // m per degree of latitude
+    double eastScale_;        // m per degree of longitude at the origin latitude
+    double eastScaleSlope_;   // Change of eastScale_ per degree of latitude
+    double northCurvature_;   // North offset of a parallel per squared degree of longitude
+    bool hasOrigin_;
+};
+
+} // namespace geodesy
+} // namespace drone
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace drone {
+namespace hal {
+
+// A single GPIO line. Uses the GPIO character device (v2 uAPI) when the
+// chip is available, so edges arrive as queued events carrying a kernel
+// CLOCK_MONOTONIC timestamp. Falls back to wiringPi, where edges are
+// timestamped in a wiringPiISR callback instead. Neither path blocks: edge
+// events are drained with readEvents(). The offset is a BCM GPIO number in
+// both cases, so the fallback needs wiringPi set up by wiringPiSetupGpio().
+class GpioLine {
+public:
+    enum class Edge : uint8_t {
+        RISING,
+        FALLING
+    };
+
+    struct EdgeEvent {
+        Edge edge;
+        int64_t timestampNs;   // CLOCK_MONOTONIC
+    };
+
+    GpioLine(const std::string& chipPath, unsigned int offset);
+    ~GpioLine();
+
+    GpioLine(const GpioLine&) = delete;
+    GpioLine& operator=(const GpioLine&) = delete;
+
+    // Line configuration
+    bool requestOutput(bool initialValue, const char* consumer);
+    bool requestEdgeEvents(const char* consumer);
+    void release();
+
+    // Output
+    bool setValue(bool value);
+
+    // Drain queued edge events without blocking. Returns the number written.
+    size_t readEvents(EdgeEvent* events, size_t maxEvents);
+
+    // Readable while edge events are queued, for poll() in a waiting thread
+    int getPollFd() const { return lineFd_ >= 0 ? lineFd_ : notifyFd_; }
+
+    bool usesCharacterDevice() const { return lineFd_ >= 0; }
+    uint64_t getDroppedEvents() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    enum class Mode {
+        NONE,
+        DRIVEN,
+        EVENTS
+    };
+
+    // Character device
+    int requestLine(uint64_t flags, bool initialValue, const char* consumer);
+
+    // wiringPi fallback. wiringPiISR takes a plain function pointer, so each
+    // pin gets its own trampoline that forwards to the registered line.
+    static constexpr unsigned int MAX_ISR_PINS = 64;
+    static constexpr size_t ISR_QUEUE_SIZE = 16;  // Power of two
+
+    static std::array<std::atomic<GpioLine*>, MAX_ISR_PINS> isrLines_;
+    template<unsigned int Pin> static void isrTrampoline();
+    template<unsigned int... Pins>
+    static std::array<void (*)(), sizeof...(Pins)> makeTrampolines(
+        std::integer_sequence<unsigned int, Pins...>);
+    bool attachInterrupt();
+    void detachInterrupt();
+    void onInterrupt();
+
+    const std::string chipPath_;
+    const unsigned int offset_;
+    Mode mode_;
+    int lineFd_;
+    int notifyFd_;   // eventfd signalled by the fallback interrupt handler
+
+    // Single-producer (ISR thread) / single-consumer queue for the fallback
+    std::array<EdgeEvent, ISR_QUEUE_SIZE> isrQueue_;
+    std::atomic<uint32_t> isrHead_;
+    std::atomic<uint32_t> isrTail_;
+    std::atomic<uint64_t> dropped_;
+};
+
+} // namespace hal
+} // namespace drone
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace drone {
+namespace hal {
+
+// Register-oriented access to one device on an I2C bus. Sensor drivers talk
+// to this interface so the transport can be swapped.
+class I2CDevice {
+public:
+    virtual ~I2CDevice() = default;
+
+    virtual bool open() = 0;
+    virtual void close() = 0;
+
+    virtual bool writeRegister(uint8_t reg, uint8_t value) = 0;
+
+    // Write length consecutive registers starting at reg in one transaction;
+    // the device must auto-increment its register pointer
+    virtual bool writeRegisters(uint8_t reg, const uint8_t* data, size_t length) = 0;
+
+    // Read length consecutive registers starting at reg in one transaction
+    virtual bool readRegisters(uint8_t reg, uint8_t* buffer, size_t length) = 0;
+
+    bool readRegister(uint8_t reg, uint8_t& value) {
+        return readRegisters(reg, &value, 1);
+    }
+};
+
+} // namespace hal
+} // namespace drone
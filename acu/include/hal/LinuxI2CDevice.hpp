@@ -0,0 +1,41 @@
+#pragma once
+
+#include "hal/I2CDevice.hpp"
+#include <atomic>
+#include <string>
+
+namespace drone {
+namespace hal {
+
+// I2CDevice on a Linux i2c-dev bus. Each register access is a single
+// I2C_RDWR transaction: a burst read is the register address write, a
+// repeated start and the read, with no stop in between.
+class LinuxI2CDevice : public I2CDevice {
+public:
+    LinuxI2CDevice(const std::string& busPath, uint8_t address);
+    ~LinuxI2CDevice() override;
+
+    bool open() override;
+    void close() override;
+
+    bool writeRegister(uint8_t reg, uint8_t value) override;
+    bool writeRegisters(uint8_t reg, const uint8_t* data, size_t length) override;
+    bool readRegisters(uint8_t reg, uint8_t* buffer, size_t length) override;
+
+    // Longest burst writeRegisters() accepts; it builds the message on the stack
+    static constexpr size_t MAX_WRITE_LENGTH = 256;
+
+    uint64_t getTransactions() const { return transactions_.load(std::memory_order_relaxed); }
+    uint64_t getErrors() const { return errors_.load(std::memory_order_relaxed); }
+
+private:
+    const std::string busPath_;
+    const uint8_t address_;
+    int fd_;
+
+    std::atomic<uint64_t> transactions_;
+    std::atomic<uint64_t> errors_;
+};
+
+} // namespace hal
+} // namespace drone
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "hal/PwmOutput.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace drone {
+namespace hal {
+
+// In-memory PwmOutput for running the controller without hardware. Keeps
+// the last frame written and counts frames.
+class MockPwm : public PwmOutput {
+public:
+    explicit MockPwm(size_t channels = 16)
+        : pulses_(channels, 0), frequencyHz_(0), open_(false), failNext_(false), frames_(0) {}
+
+    bool open(uint32_t frequencyHz) override {
+        frequencyHz_ = frequencyHz;
+        open_ = true;
+        return true;
+    }
+
+    void close() override { open_ = false; }
+
+    size_t channels() const override { return pulses_.size(); }
+
+    bool write(const uint16_t* pulseUs, size_t count) override {
+        if (!open_ || count > pulses_.size() || consumeFailure()) return false;
+        std::copy(pulseUs, pulseUs + count, pulses_.begin());
+        frames_++;
+        return true;
+    }
+
+    // Test control
+    void failNextWrite() { failNext_ = true; }
+
+    uint16_t getPulse(size_t channel) const { return pulses_[channel]; }
+    uint32_t getFrequency() const { return frequencyHz_; }
+    size_t getFrames() const { return frames_; }
+    bool isOpen() const { return open_; }
+
+private:
+    bool consumeFailure() {
+        bool fail = failNext_;
+        failNext_ = false;
+        return fail;
+    }
+
+    std::vector<uint16_t> pulses_;
+    uint32_t frequencyHz_;
+    bool open_;
+    bool failNext_;
+    size_t frames_;
+};
+
+} // namespace hal
+} // namespace drone
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "hal/I2CDevice.hpp"
+#include "hal/PwmOutput.hpp"
+#include <memory>
+
+namespace drone {
+namespace hal {
+
+// NXP PCA9685 16-channel, 12-bit PWM controller on I2C. The chip runs the
+// pulse timing itself; a frame is one auto-increment write covering the
+// ON/OFF registers of every channel written, and the outputs change
+// together at the stop condition.
+class Pca9685 : public PwmOutput {
+public:
+    static constexpr size_t CHANNELS = 16;
+    static constexpr uint8_t DEFAULT_ADDRESS = 0x40;
+
+    // The internal oscillator is specified at 25 MHz but individual chips
+    // are off by a few percent; pass a measured value to trim pulse widths
+    explicit Pca9685(std::unique_ptr<I2CDevice> device, float oscillatorHz = 25000000.0f);
+    ~Pca9685() override;
+
+    Pca9685(const Pca9685&) = delete;
+    Pca9685& operator=(const Pca9685&) = delete;
+
+    bool open(uint32_t frequencyHz) override;
+    void close() override;
+
+    size_t channels() const override { return CHANNELS; }
+
+    bool write(const uint16_t* pulseUs, size_t count) override;
+
+    // Frame rate after prescaler rounding
+    float getFrequency() const { return frequencyHz_; }
+
+private:
+    // Registers
+    static constexpr uint8_t MODE1 = 0x00;
+    static constexpr uint8_t MODE2 = 0x01;
+    static constexpr uint8_t LED0_ON_L = 0x06;
+    static constexpr uint8_t ALL_LED_OFF_H = 0xFD;
+    static constexpr uint8_t PRE_SCALE = 0xFE;
+
+    // MODE1 / MODE2 bits
+    static constexpr uint8_t MODE1_RESTART = 0x80;
+    static constexpr uint8_t MODE1_AI = 0x20;        // Register auto-increment
+    static constexpr uint8_t MODE1_SLEEP = 0x10;
+    static constexpr uint8_t MODE1_ALLCALL = 0x01;
+    static constexpr uint8_t MODE2_OUTDRV = 0x04;    // Totem-pole outputs
+
+    static constexpr uint8_t LED_FULL = 0x10;        // Full on/off bit in the _H registers
+    static constexpr uint16_t COUNTS = 4096;         // Counts per frame
+
+    std::unique_ptr<I2CDevice> device_;
+    const float oscillatorHz_;
+    float frequencyHz_;
+    float countsPerUs_;
+    bool open_;
+};
+
+} // namespace hal
+} // namespace drone
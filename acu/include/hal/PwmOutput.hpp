@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace drone {
+namespace hal {
+
+// A bank of servo/ESC pulse outputs that all run at the same frame rate.
+// write() hands over a whole frame of pulse widths at once so a backend
+// can send it in as few bus transactions as it needs.
+class PwmOutput {
+public:
+    virtual ~PwmOutput() = default;
+
+    virtual bool open(uint32_t frequencyHz) = 0;
+    virtual void close() = 0;
+
+    virtual size_t channels() const = 0;
+
+    // Pulse widths in microseconds for channels 0 to count - 1; 0 turns a
+    // channel's output off (no pulse) rather than sending a minimum pulse
+    virtual bool write(const uint16_t* pulseUs, size_t count) = 0;
+};
+
+} // namespace hal
+} // namespace drone
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+
+namespace drone {
+namespace hal {
+
+// Raw 8N1 serial port read with poll() and block reads. Everything waiting
+// in the driver is read into a ring buffer in one syscall, and every byte
+// gets an estimated CLOCK_MONOTONIC arrival time. wake() interrupts a
+// blocked fill() from another thread through an eventfd, so a reader
+// thread can be stopped immediately.
+//
+// fill() and read() belong to one reader thread; wake() may be called from
+// anywhere.
+class SerialPort {
+public:
+    explicit SerialPort(const std::string& devicePath);
+    ~SerialPort();
+
+    SerialPort(const SerialPort&) = delete;
+    SerialPort& operator=(const SerialPort&) = delete;
+
+    bool open(uint32_t baudRate);
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+
+    bool setBaudRate(uint32_t baudRate);
+    uint32_t getBaudRate() const { return baudRate_; }
+
+    // Waits up to timeoutMs for data, then reads all of it into the ring.
+    // Returns the number of bytes added; 0 on timeout or wake(), -1 on an
+    // error, after which the port is closed. A closed port still waits for
+    // wake() so callers can use fill() as their back-off.
+    ssize_t fill(int timeoutMs);
+
+    // Consumes up to maxLength buffered bytes. timestamps, if given, gets
+    // the estimated arrival time of each byte.
+    size_t read(uint8_t* data, size_t maxLength, int64_t* timestamps = nullptr);
+    size_t available() const { return static_cast<size_t>(head_ - tail_); }
+
+    // Blocking write of the whole buffer
+    bool write(const uint8_t* data, size_t length);
+
+    // Drops anything buffered here or in the driver
+    void flush();
+
+    void wake();
+
+    struct Statistics {
+        uint64_t bytes{0};
+        uint64_t reads{0};        // read() syscalls
+        uint64_t overruns{0};     // Fills cut short by a full ring
+        uint64_t errors{0};
+    };
+    const Statistics& getStatistics() const { return stats_; }
+
+private:
+    static constexpr size_t RING_SIZE = 4096;
+    static constexpr size_t MASK = RING_SIZE - 1;
+
+    const std::string devicePath_;
+    int fd_;
+    int wakeFd_;
+    uint32_t baudRate_;
+    int64_t byteNs_;  // Time on the wire for one 10-bit character
+
+    uint8_t ring_[RING_SIZE];
+    int64_t arrival_[RING_SIZE];
+    uint64_t head_;
+    uint64_t tail_;
+
+    Statistics stats_;
+};
+
+} // namespace hal
+} // namespace drone
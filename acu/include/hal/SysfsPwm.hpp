@@ -0,0 +1,47 @@
+#pragma once
+
+#include "hal/PwmOutput.hpp"
+#include <string>
+#include <vector>
+
+namespace drone {
+namespace hal {
+
+// Hardware PWM channels of a Linux pwmchip through sysfs
+// (/sys/class/pwm/pwmchipN). Each channel's duty_cycle file stays open and
+// takes one write per change; sysfs has no way to update several channels
+// at once, so only channels whose pulse width changed are written.
+class SysfsPwm : public PwmOutput {
+public:
+    // Uses channels 0 to channels - 1 of the chip
+    SysfsPwm(const std::string& chipPath, size_t channels);
+    ~SysfsPwm() override;
+
+    SysfsPwm(const SysfsPwm&) = delete;
+    SysfsPwm& operator=(const SysfsPwm&) = delete;
+
+    bool open(uint32_t frequencyHz) override;
+    void close() override;
+
+    size_t channels() const override { return channelCount_; }
+
+    bool write(const uint16_t* pulseUs, size_t count) override;
+
+    // duty_cycle writes issued, at most one per changed channel per frame
+    uint64_t getWrites() const { return writes_; }
+
+private:
+    std::string channelPath(size_t channel) const;
+    bool exportChannel(size_t channel);
+    bool writeDuty(size_t channel, uint16_t pulseUs);
+
+    const std::string chipPath_;
+    const size_t channelCount_;
+    std::vector<int> dutyFds_;
+    std::vector<uint16_t> pulses_;   // Last written, microseconds
+    uint32_t periodNs_;
+    uint64_t writes_;
+};
+
+} // namespace hal
+} // namespace drone
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace drone {
+namespace math {
+
+// Single-precision approximations for the estimator hot path. Accurate to
+// well under a hundredth of a degree, which is far below sensor noise.
+
+constexpr float PI = 3.14159265358979f;
+constexpr float HALF_PI = 1.57079632679490f;
+constexpr float DEG_TO_RAD = PI / 180.0f;
+constexpr float RAD_TO_DEG = 180.0f / PI;
+
+// 1/sqrt(x), bit-level seed plus two Newton steps (relative error ~5e-6)
+inline float fastInvSqrt(float x) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    bits = 0x5f3759dfu - (bits >> 1);
+    float y;
+    std::memcpy(&y, &bits, sizeof(y));
+    float half = 0.5f * x;
+    y = y * (1.5f - half * y * y);
+    y = y * (1.5f - half * y * y);
+    return y;
+}
+
+// atan(z) for |z| <= 1, minimax polynomial (error ~1e-5 rad)
+inline float fastAtanUnit(float z) {
+    float z2 = z * z;
+    return z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f +
+           z2 * (-0.11643287f + z2 * (0.05265332f + z2 * -0.01172120f)))));
+}
+
+inline float fastAtan2(float y, float x) {
+    float ax = x < 0 ? -x : x;
+    float ay = y < 0 ? -y : y;
+    if (ax == 0.0f && ay == 0.0f) {
+        return 0.0f;
+    }
+
+    // Reduce to |z| <= 1, then unfold by octant
+    float angle = ay > ax ? HALF_PI - fastAtanUnit(ax / ay) : fastAtanUnit(ay / ax);
+    if (x < 0) angle = PI - angle;
+    return y < 0 ? -angle : angle;
+}
+
+inline float fastAsin(float x) {
+    if (x >= 1.0f) return HALF_PI;
+    if (x <= -1.0f) return -HALF_PI;
+    float c2 = 1.0f - x * x;
+    return fastAtan2(x, c2 * fastInvSqrt(c2));
+}
+
+} // namespace math
+} // namespace drone
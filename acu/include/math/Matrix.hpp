@@ -0,0 +1,185 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace drone {
+namespace math {
+
+// Call f(std::integral_constant<size_t, I>) for I in [0, N). Expands to N
+// straight-line calls, so loops over fixed dimensions are unrolled by
+// construction rather than left to the optimizer.
+template<size_t N, typename F>
+inline void unroll(F&& f);
+
+namespace detail {
+    template<typename F, size_t... I>
+    inline void unroll(F&& f, std::index_sequence<I...>) {
+        (f(std::integral_constant<size_t, I>{}), ...);
+    }
+}
+
+template<size_t N, typename F>
+inline void unroll(F&& f) {
+    detail::unroll(std::forward<F>(f), std::make_index_sequence<N>{});
+}
+
+// Fixed-size, row-major matrix. Dimensions are template parameters and the
+// storage is inline, so nothing here allocates.
+template<typename T, size_t Rows, size_t Cols>
+class Matrix {
+public:
+    static constexpr size_t ROWS = Rows;
+    static constexpr size_t COLS = Cols;
+    static constexpr size_t SIZE = Rows * Cols;
+
+    constexpr Matrix() : data_{} {}
+
+    static Matrix zeros() { return Matrix(); }
+
+    static Matrix identity() {
+        static_assert(Rows == Cols, "identity() requires a square matrix");
+        Matrix result;
+        unroll<Rows>([&](auto i) { result(i, i) = T(1); });
+        return result;
+    }
+
+    // Element access
+    T& operator()(size_t row, size_t col) { return data_[row * Cols + col]; }
+    const T& operator()(size_t row, size_t col) const { return data_[row * Cols + col]; }
+
+    // Flat access, mainly for vectors
+    T& operator[](size_t index) { return data_[index]; }
+    const T& operator[](size_t index) const { return data_[index]; }
+
+    // Element-wise arithmetic
+    Matrix& operator+=(const Matrix& other) {
+        unroll<SIZE>([&](auto i) { data_[i] += other.data_[i]; });
+        return *this;
+    }
+
+    Matrix& operator-=(const Matrix& other) {
+        unroll<SIZE>([&](auto i) { data_[i] -= other.data_[i]; });
+        return *this;
+    }
+
+    Matrix& operator*=(T scalar) {
+        unroll<SIZE>([&](auto i) { data_[i] *= scalar; });
+        return *this;
+    }
+
+    Matrix operator+(const Matrix& other) const { Matrix result(*this); return result += other; }
+    Matrix operator-(const Matrix& other) const { Matrix result(*this); return result -= other; }
+    Matrix operator*(T scalar) const { Matrix result(*this); return result *= scalar; }
+    Matrix operator-() const { return *this * T(-1); }
+
+    // Matrix product
+    template<size_t K>
+    Matrix<T, Rows, K> operator*(const Matrix<T, Cols, K>& other) const {
+        Matrix<T, Rows, K> result;
+        unroll<Rows>([&](auto r) {
+            unroll<K>([&](auto c) {
+                T sum = T(0);
+                unroll<Cols>([&](auto k) { sum += (*this)(r, k) * other(k, c); });
+                result(r, c) = sum;
+            });
+        });
+        return result;
+    }
+
+    Matrix<T, Cols, Rows> transposed() const {
+        Matrix<T, Cols, Rows> result;
+        unroll<Rows>([&](auto r) {
+            unroll<Cols>([&](auto c) { result(c, r) = (*this)(r, c); });
+        });
+        return result;
+    }
+
+    // Sub-matrix at (Row, Col)
+    template<size_t R, size_t C, size_t Row, size_t Col>
+    Matrix<T, R, C> block() const {
+        static_assert(Row + R <= Rows && Col + C <= Cols, "block out of range");
+        Matrix<T, R, C> result;
+        unroll<R>([&](auto r) {
+            unroll<C>([&](auto c) { result(r, c) = (*this)(Row + r, Col + c); });
+        });
+        return result;
+    }
+
+    template<size_t Row, size_t Col, size_t R, size_t C>
+    void setBlock(const Matrix<T, R, C>& value) {
+        static_assert(Row + R <= Rows && Col + C <= Cols, "block out of range");
+        unroll<R>([&](auto r) {
+            unroll<C>([&](auto c) { (*this)(Row + r, Col + c) = value(r, c); });
+        });
+    }
+
+private:
+    std::array<T, SIZE> data_;
+};
+
+template<typename T, size_t Rows, size_t Cols>
+inline Matrix<T, Rows, Cols> operator*(T scalar, const Matrix<T, Rows, Cols>& matrix) {
+    return matrix * scalar;
+}
+
+template<size_t N>
+using Vector = Matrix<float, N, 1>;
+
+using Vector3 = Vector<3>;
+using Matrix3 = Matrix<float, 3, 3>;
+
+inline Vector3 makeVector3(float x, float y, float z) {
+    Vector3 v;
+    v[0] = x;
+    v[1] = y;
+    v[2] = z;
+    return v;
+}
+
+inline float dot(const Vector3& a, const Vector3& b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+inline Vector3 cross(const Vector3& a, const Vector3& b) {
+    return makeVector3(a[1] * b[2] - a[2] * b[1],
+                       a[2] * b[0] - a[0] * b[2],
+                       a[0] * b[1] - a[1] * b[0]);
+}
+
+// [v]x such that skew(a) * b == cross(a, b)
+inline Matrix3 skew(const Vector3& v) {
+    Matrix3 m;
+    m(0, 1) = -v[2]; m(0, 2) = v[1];
+    m(1, 0) = v[2];  m(1, 2) = -v[0];
+    m(2, 0) = -v[1]; m(2, 1) = v[0];
+    return m;
+}
+
+// Closed-form 3x3 inverse. Returns false if the matrix is singular.
+inline bool inverse(const Matrix3& m, Matrix3& result) {
+    float c00 = m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1);
+    float c01 = m(1, 2) * m(2, 0) - m(1, 0) * m(2, 2);
+    float c02 = m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0);
+    float det = m(0, 0) * c00 + m(0, 1) * c01 + m(0, 2) * c02;
+    if (det > -1e-12f && det < 1e-12f) {
+        return false;
+    }
+
+    float invDet = 1.0f / det;
+    result(0, 0) = c00 * invDet;
+    result(0, 1) = (m(0, 2) * m(2, 1) - m(0, 1) * m(2, 2)) * invDet;
+    result(0, 2) = (m(0, 1) * m(1, 2) - m(0, 2) * m(1, 1)) * invDet;
+    result(1, 0) = c01 * invDet;
+    result(1, 1) = (m(0, 0) * m(2, 2) - m(0, 2) * m(2, 0)) * invDet;
+    result(1, 2) = (m(0, 2) * m(1, 0) - m(0, 0) * m(1, 2)) * invDet;
+    result(2, 0) = c02 * invDet;
+    result(2, 1) = (m(0, 1) * m(2, 0) - m(0, 0) * m(2, 1)) * invDet;
+    result(2, 2) = (m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0)) * invDet;
+    return true;
+}
+
+} // namespace math
+} // namespace drone
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "math/FastMath.hpp"
+#include "math/Matrix.hpp"
+#include <cmath>
+
+namespace drone {
+namespace math {
+
+// Unit quaternion rotating body-frame vectors into the world frame
+// (world z up). Hamilton convention, w first.
+struct Quaternion {
+    float w{1.0f}, x{0.0f}, y{0.0f}, z{0.0f};
+
+    static Quaternion fromEuler(float roll, float pitch, float yaw) {
+        float cr = std::cos(roll * 0.5f), sr = std::sin(roll * 0.5f);
+        float cp = std::cos(pitch * 0.5f), sp = std::sin(pitch * 0.5f);
+        float cy = std::cos(yaw * 0.5f), sy = std::sin(yaw * 0.5f);
+        return {cr * cp * cy + sr * sp * sy,
+                sr * cp * cy - cr * sp * sy,
+                cr * sp * cy + sr * cp * sy,
+                cr * cp * sy - sr * sp * cy};
+    }
+
+    Quaternion operator*(const Quaternion& q) const {
+        return {w * q.w - x * q.x - y * q.y - z * q.z,
+                w * q.x + x * q.w + y * q.z - z * q.y,
+                w * q.y - x * q.z + y * q.w + z * q.x,
+                w * q.z + x * q.y - y * q.x + z * q.w};
+    }
+
+    Quaternion conjugate() const { return {w, -x, -y, -z}; }
+
+    void normalize() {
+        float scale = fastInvSqrt(w * w + x * x + y * y + z * z);
+        w *= scale;
+        x *= scale;
+        y *= scale;
+        z *= scale;
+    }
+
+    // Apply a small body-frame rotation (first-order exponential map)
+    void rotateBy(const Vector3& angle) {
+        Quaternion delta{1.0f, 0.5f * angle[0], 0.5f * angle[1], 0.5f * angle[2]};
+        *this = *this * delta;
+        normalize();
+    }
+
+    // Body-frame vector expressed in the world frame
+    Vector3 rotate(const Vector3& v) const {
+        return makeVector3(
+            (1.0f - 2.0f * (y * y + z * z)) * v[0] + 2.0f * (x * y - w * z) * v[1] + 2.0f * (x * z + w * y) * v[2],
+            2.0f * (x * y + w * z) * v[0] + (1.0f - 2.0f * (x * x + z * z)) * v[1] + 2.0f * (y * z - w * x) * v[2],
+            2.0f * (x * z - w * y) * v[0] + 2.0f * (y * z + w * x) * v[1] + (1.0f - 2.0f * (x * x + y * y)) * v[2]);
+    }
+
+    // World z axis expressed in the body frame (the direction of gravity
+    // reaction an accelerometer sees at rest)
+    Vector3 worldUpInBody() const {
+        return makeVector3(2.0f * (x * z - w * y),
+                           2.0f * (w * x + y * z),
+                           w * w - x * x - y * y + z * z);
+    }
+
+    // ZYX Euler angles in radians
+    float roll() const { return fastAtan2(2.0f * (w * x + y * z), 1.0f - 2.0f * (x * x + y * y)); }
+    float pitch() const { return fastAsin(2.0f * (w * y - z * x)); }
+    float yaw() const { return fastAtan2(2.0f * (w * z + x * y), 1.0f - 2.0f * (y * y + z * z)); }
+};
+
+} // namespace math
+} // namespace drone
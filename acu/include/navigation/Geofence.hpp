@@ -0,0 +1,125 @@
+#pragma once
+
+#include "geodesy/LocalFrame.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace drone {
+namespace navigation {
+
+// Polygonal inclusion and exclusion zones, checked against the fused
+// position every control tick.
+//
+// Zones are given in latitude/longitude and rasterized once the home point
+// is known into a grid of ENU cells over the fence. Each cell records
+// whether it is allowed and how far (in cells) it is from the nearest cell
+// an edge passes near. Cells clear of every edge answer from the grid
+// alone. Cells near an edge keep a short list of those edges plus which
+// zones contain the cell center, so the exact answer is a parity walk from
+// the center to the point over a handful of edges. Either way the cost of
+// check() does not depend on the size of the fence.
+//
+// A position is allowed when it is inside some inclusion zone (or there
+// are none) and inside no exclusion zone.
+class Geofence {
+public:
+    enum class ZoneType { INCLUSION, EXCLUSION };
+
+    struct Vertex {
+        double latitude;
+        double longitude;
+    };
+
+    struct Status {
+        bool inside{true};
+        float distance{0};   // m to the nearest fence edge; exact within one cell
+                             // of it, a lower bound further away
+    };
+
+    struct Statistics {
+        uint64_t checks{0};
+        uint64_t exactChecks{0};     // Answered from a boundary cell's edges
+        size_t columns{0};
+        size_t rows{0};
+        float cellSize{0};           // m
+        size_t boundaryCells{0};
+    };
+
+    static constexpr size_t MAX_ZONES = 32;
+    static constexpr size_t MAX_VERTICES = 256;   // Per zone
+
+    Geofence();
+
+    // One zone per block: a line "inclusion" or "exclusion" followed by
+    // "latitude longitude" vertex lines. '#' starts a comment.
+    bool load(const std::string& path);
+    bool addZone(ZoneType type, const std::vector<Vertex>& vertices);
+    bool hasZones() const { return !zones_.empty(); }
+
+    // Rasterizes the zones around frame's origin, once; later calls do
+    // nothing. Allocates and takes milliseconds, so it runs on its own
+    // thread while check() keeps answering "allowed" from the control
+    // thread until the finished grid is published. Zones must not change
+    // after building starts.
+    bool build(const geodesy::LocalFrame& frame);
+    bool isBuilt() const { return built_.load(std::memory_order_acquire); }
+
+    // Allowed for every position until built
+    Status check(float east, float north) const;
+    const Statistics& getStatistics() const { return stats_; }
+
+private:
+    struct Zone {
+        ZoneType type;
+        std::vector<Vertex> vertices;
+    };
+
+    struct Edge {
+        float ax, ay, bx, by;
+        uint32_t zoneBit;
+    };
+
+    struct BoundaryCell {
+        uint32_t centerZones;   // Bit per zone containing the cell center
+        uint32_t firstEdge;     // Into cellEdges_
+        uint32_t edgeCount;
+    };
+
+    // Cell word: allowed flag, boundary flag, then either the chamfer
+    // distance to the nearest boundary cell or the boundary cell index
+    static constexpr uint32_t CELL_ALLOWED = 0x80000000u;
+    static constexpr uint32_t CELL_BOUNDARY = 0x40000000u;
+    static constexpr uint32_t CELL_VALUE = 0x3FFFFFFFu;
+
+    // 5/7 chamfer weights approximate Euclidean distance to within 2%
+    static constexpr uint32_t CHAMFER_STRAIGHT = 5;
+    static constexpr uint32_t CHAMFER_DIAGONAL = 7;
+
+    static constexpr size_t MAX_GRID_SIDE = 512;   // Cells per axis
+    static constexpr float MIN_CELL_SIZE = 2.0f;   // m
+    static constexpr size_t MARGIN_CELLS = 2;      // Around the fence bounds
+
+    bool allowed(uint32_t zones) const;
+    float edgeDistance(const BoundaryCell& cell, float east, float north) const;
+
+    std::vector<Zone> zones_;
+    uint32_t inclusionZones_;   // Bit per inclusion zone
+    uint32_t exclusionZones_;
+
+    std::atomic<bool> built_;   // Publishes the grid to check()
+    float minEast_, minNorth_;
+    float cellSize_;
+    size_t columns_, rows_;
+    std::vector<uint32_t> cells_;
+    std::vector<BoundaryCell> boundary_;
+    std::vector<uint32_t> cellEdges_;
+    std::vector<Edge> edges_;
+
+    mutable Statistics stats_;
+};
+
+} // namespace navigation
+} // namespace drone
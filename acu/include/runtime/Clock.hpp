@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <time.h>
+
+namespace drone {
+namespace runtime {
+
+// CLOCK_MONOTONIC in nanoseconds; the common time base for the control
+// loop, sensor timestamps and kernel event timestamps
+inline int64_t monotonicNanoseconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+} // namespace runtime
+} // namespace drone
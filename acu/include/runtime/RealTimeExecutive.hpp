@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <time.h>
+
+namespace drone {
+namespace runtime {
+
+// Periodic executive for the control thread. Sleeps with
+// clock_nanosleep(TIMER_ABSTIME) on absolute deadlines, so the period never
+// accumulates the execution time or the sleep overshoot, and measures how
+// late every wake-up is.
+class RealTimeExecutive {
+public:
+    struct Options {
+        std::chrono::nanoseconds period{std::chrono::milliseconds(5)};
+        int priority{0};                // SCHED_FIFO priority (1-99), 0 keeps SCHED_OTHER
+        bool lockMemory{false};         // mlockall() current and future pages
+        size_t prefaultStackBytes{0};   // Touch this much stack before running
+        int cpu{-1};                    // Pin to this CPU, -1 to leave unpinned
+        std::chrono::seconds reportInterval{0};  // Periodic report to stdout, 0 disables
+    };
+
+    struct Statistics {
+        uint64_t cycles{0};
+        uint64_t overruns{0};           // Cycles that ran past the next deadline
+        int64_t minLatencyNs{0};        // Wake-up latency relative to the deadline
+        int64_t maxLatencyNs{0};
+        int64_t meanLatencyNs{0};
+        int64_t maxExecutionNs{0};      // Cycle body execution time
+    };
+
+    explicit RealTimeExecutive(const Options& options);
+
+    // Apply scheduling policy, memory locking and affinity to the calling
+    // thread. Failures are reported and the executive keeps running with
+    // whatever could be applied.
+    bool configure();
+
+    // Run cycle() once per period until keepRunning() returns false
+    void run(const std::function<bool()>& keepRunning, const std::function<void()>& cycle);
+
+    Statistics getStatistics() const;
+    void resetStatistics();
+    void report(std::ostream& out) const;
+
+    std::chrono::nanoseconds getPeriod() const { return options_.period; }
+
+private:
+    Options options_;
+
+    // Written by the control thread, readable from anywhere
+    std::atomic<uint64_t> cycles_;
+    std::atomic<uint64_t> overruns_;
+    std::atomic<int64_t> minLatencyNs_;
+    std::atomic<int64_t> maxLatencyNs_;
+    std::atomic<int64_t> totalLatencyNs_;
+    std::atomic<int64_t> maxExecutionNs_;
+
+    void recordCycle(int64_t latencyNs, int64_t executionNs);
+    static void prefaultStack(size_t bytes);
+    static void addNanoseconds(struct timespec& ts, int64_t ns);
+    static int64_t toNanoseconds(const struct timespec& ts);
+};
+
+} // namespace runtime
+} // namespace drone
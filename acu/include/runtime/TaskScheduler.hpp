@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace drone {
+namespace runtime {
+
+// Rate-group scheduler driven once per base tick by the RealTimeExecutive.
+// Each task runs at an integer divisor of the base rate, offset by a phase
+// so slow groups do not all land on the same tick. Within a tick tasks run
+// in priority order. Non-critical tasks are shed while the loop is over
+// budget, so the critical groups keep their rate.
+class TaskScheduler {
+public:
+    struct TaskContext {
+        uint64_t tick;        // Base tick counter
+        int64_t nowNs;        // Monotonic time at task start
+        float dt;             // Measured seconds since this task last ran
+        float period;         // Nominal period in seconds
+    };
+
+    using TaskFunction = std::function<void(const TaskContext&)>;
+
+    struct TaskConfig {
+        std::string name;
+        uint32_t rateHz;
+        uint32_t phase;                     // Offset in base ticks
+        int priority;                       // Lower runs first within a tick
+        std::chrono::microseconds budget;   // Worst-case execution time allowed
+        bool critical;                      // Never shed
+        TaskFunction function;
+    };
+
+    struct TaskStatistics {
+        std::string name;
+        uint32_t rateHz{0};
+        uint64_t runs{0};
+        uint64_t shed{0};             // Skipped to protect critical tasks
+        uint64_t budgetOverruns{0};   // Runs longer than the task budget
+        int64_t maxExecutionNs{0};
+    };
+
+    explicit TaskScheduler(uint32_t baseRateHz);
+
+    // Returns false if the rate does not divide the base rate
+    bool addTask(const TaskConfig& config);
+
+    // Run every task due on the current tick, then advance
+    void runTick();
+
+    uint32_t getBaseRate() const { return baseRateHz_; }
+    std::vector<TaskStatistics> getStatistics() const;
+    void report(std::ostream& out) const;
+
+private:
+    struct Task {
+        TaskConfig config;
+        uint32_t divider;
+        int64_t lastRunNs;
+        TaskStatistics stats;
+    };
+
+    // Fraction of the base period after which non-critical work is dropped
+    static constexpr double SHED_THRESHOLD = 0.8;
+    // Ticks to keep shedding after a tick overran its period
+    static constexpr uint32_t SHED_HOLD_TICKS = 20;
+
+    const uint32_t baseRateHz_;
+    const int64_t basePeriodNs_;
+    std::vector<Task> tasks_;
+    uint64_t tick_;
+    uint32_t shedTicksRemaining_;
+};
+
+} // namespace runtime
+} // namespace drone
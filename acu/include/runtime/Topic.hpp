@@ -0,0 +1,266 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace drone {
+namespace runtime {
+
+// Wakes subscribers blocked on a topic. Each waiting subscription owns one
+// of a fixed set of slots with its own eventfd, so publishing never
+// allocates or takes a lock. An eventfd write costs about a microsecond,
+// so the publisher skips it while an earlier wake-up is still pending.
+// A released slot keeps its eventfd open until the notifier is destroyed:
+// the publisher may still hold the fd, and a late write to it is harmless.
+class TopicNotifier {
+public:
+    static constexpr size_t MAX_WAITERS = 8;
+
+    TopicNotifier();
+    ~TopicNotifier();
+
+    TopicNotifier(const TopicNotifier&) = delete;
+    TopicNotifier& operator=(const TopicNotifier&) = delete;
+
+    // Claims a slot; returns its index, or -1 when all slots are taken or
+    // the eventfd cannot be created
+    int attach();
+    void detach(int waiter);
+    int fd(int waiter) const;
+
+    // Publisher side: at most one eventfd write per attached waiter
+    void notify();
+
+    // Waiter side: arm() asks for a wake-up on the next publish. Check for
+    // new data after arming, then wait() until the eventfd is signalled or
+    // the timeout (ms, -1 for none) expires.
+    void arm(int waiter);
+    bool wait(int waiter, int timeoutMs) const;
+
+private:
+    struct Waiter {
+        std::atomic<bool> active{false};
+        std::atomic<bool> claimed{false};
+        std::atomic<bool> pending{false};   // Signalled and not yet armed again
+        int fd{-1};
+    };
+    std::array<Waiter, MAX_WAITERS> waiters_;
+    std::atomic<int> attached_;   // Lets notify() skip the scan when nobody waits
+};
+
+// Single-publisher, multi-subscriber topic holding the last Slots messages
+// of a trivially copyable type. Each slot is guarded by its own sequence
+// stamp, as in SeqLock, so publishing is a fixed number of stores and a
+// read is one copy plus a stamp check; neither side ever waits for the
+// other. A reader the publisher laps sees the stamp change and skips ahead.
+template<typename T, size_t Slots>
+class Topic {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Topic requires a trivially copyable message");
+    static_assert(Slots >= 2 && (Slots & (Slots - 1)) == 0,
+                  "Topic slot count must be a power of two");
+
+public:
+    enum class ReadResult {
+        OK,
+        NOT_PUBLISHED,   // That message has not been published yet
+        OVERWRITTEN      // The publisher has reused its slot
+    };
+
+    using Message = T;
+    static constexpr size_t SLOTS = Slots;
+
+    explicit Topic(const char* name) : name_(name), generation_(0) {
+        for (auto& slot : slots_) {
+            slot.stamp.store(0, std::memory_order_relaxed);
+            for (auto& word : slot.words) {
+                word.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    Topic(const Topic&) = delete;
+    Topic& operator=(const Topic&) = delete;
+
+    const char* name() const { return name_; }
+
+    // Publisher side (one thread only)
+    void publish(const T& message) {
+        uint64_t buffer[WORD_COUNT] = {};
+        std::memcpy(buffer, &message, sizeof(T));
+
+        const uint64_t generation = generation_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[generation & MASK];
+        slot.stamp.store(2 * generation + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < WORD_COUNT; ++i) {
+            slot.words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+
+        slot.stamp.store(2 * generation + 2, std::memory_order_release);
+        generation_.store(generation + 1, std::memory_order_release);
+        notifier_.notify();
+    }
+
+    // Number of messages published so far; message n is generation n - 1
+    uint64_t generation() const {
+        return generation_.load(std::memory_order_acquire);
+    }
+
+    ReadResult read(uint64_t generation, T& message) const {
+        const Slot& slot = slots_[generation & MASK];
+        const uint64_t expected = 2 * generation + 2;
+        const uint64_t before = slot.stamp.load(std::memory_order_acquire);
+        if (before != expected) {
+            return before < expected ? ReadResult::NOT_PUBLISHED : ReadResult::OVERWRITTEN;
+        }
+
+        uint64_t buffer[WORD_COUNT];
+        for (size_t i = 0; i < WORD_COUNT; ++i) {
+            buffer[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.stamp.load(std::memory_order_relaxed) != expected) {
+            return ReadResult::OVERWRITTEN;
+        }
+        std::memcpy(&message, buffer, sizeof(T));
+        return ReadResult::OK;
+    }
+
+    TopicNotifier& notifier() const { return notifier_; }
+
+private:
+    static constexpr uint64_t MASK = Slots - 1;
+    static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // Slots on their own cache lines, so a reader copying one does not
+    // contend with the publisher writing the next
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> stamp;
+        std::array<std::atomic<uint64_t>, WORD_COUNT> words;
+    };
+
+    const char* name_;
+    std::array<Slot, Slots> slots_;
+    alignas(64) std::atomic<uint64_t> generation_;
+    mutable TopicNotifier notifier_;
+};
+
+// One reader's view of a topic. Each subscription keeps its own position,
+// so any number of them can read the same topic from different threads.
+// A subscription itself belongs to one thread.
+template<typename TopicType>
+class Subscription {
+    using T = typename TopicType::Message;
+    static constexpr size_t Slots = TopicType::SLOTS;
+
+public:
+    // With notify set, the publisher signals an eventfd on every message,
+    // for wait() or the caller's own poll() on fd()
+    explicit Subscription(const TopicType& topic, bool notify = false)
+        : topic_(topic)
+        , next_(topic.generation())
+        , lost_(0)
+        , waiter_(notify ? topic.notifier().attach() : -1) {}
+
+    ~Subscription() {
+        if (waiter_ >= 0) {
+            topic_.notifier().detach(waiter_);
+        }
+    }
+
+    Subscription(const Subscription&) = delete;
+    Subscription& operator=(const Subscription&) = delete;
+
+    // Something was published since this subscription last read
+    bool updated() const { return topic_.generation() != next_; }
+
+    // Newest message, if there is one; marks everything up to it as read
+    bool latest(T& message) {
+        for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+            const uint64_t generation = topic_.generation();
+            if (generation == 0) {
+                return false;
+            }
+            if (topic_.read(generation - 1, message) == TopicType::ReadResult::OK) {
+                next_ = generation;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Newest message only if it has not been read yet
+    bool update(T& message) {
+        return updated() && latest(message);
+    }
+
+    // Next unread message in publish order. Messages the publisher
+    // overwrote before they were read are skipped and counted in lost().
+    bool pop(T& message) {
+        for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+            const uint64_t generation = topic_.generation();
+            if (next_ == generation) {
+                return false;
+            }
+            switch (topic_.read(next_, message)) {
+                case TopicType::ReadResult::OK:
+                    next_++;
+                    return true;
+                case TopicType::ReadResult::NOT_PUBLISHED:
+                    return false;
+                case TopicType::ReadResult::OVERWRITTEN: {
+                    // Resume at the oldest slot the publisher is not writing
+                    const uint64_t oldest = topic_.generation() - Slots + 1;
+                    lost_ += oldest - next_;
+                    next_ = oldest;
+                    break;
+                }
+            }
+        }
+        return false;
+    }
+
+    uint64_t lost() const { return lost_; }
+
+    // eventfd signalled on publish, -1 without notification
+    int fd() const { return waiter_ >= 0 ? topic_.notifier().fd(waiter_) : -1; }
+
+    // Returns as soon as there is something unread, otherwise blocks on
+    // the eventfd for up to timeoutMs (-1 for no limit)
+    bool wait(int timeoutMs) {
+        if (updated()) {
+            return true;
+        }
+        if (waiter_ < 0) {
+            return false;
+        }
+        // A publish between the two checks either shows up in the second
+        // or signals the freshly armed eventfd
+        topic_.notifier().arm(waiter_);
+        if (updated()) {
+            return true;
+        }
+        topic_.notifier().wait(waiter_, timeoutMs);
+        return updated();
+    }
+
+private:
+    // A read only fails when the publisher laps it mid-copy, which takes
+    // Slots publishes; a few attempts bound the worst case
+    static constexpr int MAX_ATTEMPTS = 4;
+
+    const TopicType& topic_;
+    uint64_t next_;   // Generation of the next unread message
+    uint64_t lost_;
+    int waiter_;
+};
+
+} // namespace runtime
+} // namespace drone
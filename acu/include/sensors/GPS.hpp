@@ -1,61 +1,94 @@
 #pragma once
 
+#include "hal/SerialPort.hpp"
+#include "sensors/NmeaParser.hpp"
+#include "sensors/UbxParser.hpp"
+#include "utils/SeqLock.hpp"
 #include <string>
 #include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <thread>
-#include <mutex>
 
 namespace drone {
 namespace sensors {
 
 class GPS {
 public:
-    explicit GPS(const std::string& device = "/dev/ttyAMA0");
+    // NMEA takes the receiver's 9600 baud default output as it is. UBX finds
+    // the receiver's baud rate, moves it to 115200 and switches it to binary
+    // NAV-PVT output at navRateHz.
+    enum class Protocol { NMEA, UBX };
+
+    explicit GPS(const std::string& device = "/dev/ttyAMA0", Protocol protocol = Protocol::NMEA,
+                 uint32_t navRateHz = 10);
     ~GPS();
 
-    // Lifecycle methods
+    // Lifecycle methods. init() runs the receiver configuration, if any.
     bool init();
     void start();
     void stop();
 
-    // Data access
-    struct GPSData {
-        double latitude{0};
-        double longitude{0};
-        float altitude{0};
-        float speed{0};
-        int satellites{0};
-        bool fix{false};
-        float hdop{0};  // Horizontal dilution of precision
-    };
+    // Data access. Each snapshot is one complete receiver epoch. Never
+    // waits: if the read thread is mid-update, getData() returns an empty
+    // fix and getStatistics() zeros, and the caller tries again next cycle.
+    using GPSData = GpsFix;
 
     GPSData getData() const;
-    bool hasFix() const { return data_.fix; }
+    bool hasFix() const { return getData().fix; }
+
+    // Serial and parser counters and the CPU time spent parsing
+    struct Statistics {
+        hal::SerialPort::Statistics serial;
+        NmeaParser::Statistics parser;
+        UbxParser::Statistics ubx;
+        int64_t parseNs{0};
+    };
+    Statistics getStatistics() const;
 
 private:
-    // Serial port
-    std::string devicePath_;
-    int serialFd_;
+    // Serial port. GT-U7 modules boot at 9600 baud NMEA.
+    static constexpr uint32_t NMEA_BAUD_RATE = 9600;
+    static constexpr uint32_t UBX_BAUD_RATE = 115200;
+    static constexpr uint32_t AUTOBAUD_RATES[] = {9600, 115200, 38400, 57600, 19200, 4800};
+    static constexpr int AUTOBAUD_TIMEOUT_MS = 300;
+    static constexpr int ACK_TIMEOUT_MS = 500;
+    static constexpr int CONFIG_ATTEMPTS = 3;
+    static constexpr int POLL_TIMEOUT_MS = 1000;  // Also the reopen interval
+    static constexpr int UBX_SILENCE_TIMEOUT_MS = 3000;
+    hal::SerialPort serial_;
+    const Protocol protocol_;
+    const uint32_t navRateHz_;
+
+    // Receiver setup
+    bool openReceiver();
+    bool configureUblox();
+    bool detectBaudRate();
+    bool probe(uint32_t baudRate);
+    bool sendUbx(uint8_t messageClass, uint8_t messageId, const uint8_t* payload, uint16_t length);
+    bool sendUbxWithAck(uint8_t messageClass, uint8_t messageId, const uint8_t* payload,
+                        uint16_t length);
+    bool pumpUntil(int timeoutMs, const std::function<bool()>& done);
 
-    // GPS data
-    mutable std::mutex dataMutex_;
-    GPSData data_;
+    // GPS data, written by the read thread only
+    utils::SeqLock<GPSData> data_;
+    utils::SeqLock<Statistics> statistics_;
 
     // Background reading
     std::atomic<bool> running_{false};
+    std::atomic<bool> stopping_{false};  // Abandons a configuration in progress
     std::unique_ptr<std::thread> readThread_;
     void readLoop();
 
-    // NMEA parsing
-    void parseNMEA(const std::string& sentence);
-    void parseGGA(const std::string& sentence);
-    void parseRMC(const std::string& sentence);
-    double parseLatLon(const std::string& value, char direction);
-
-    // Utility functions
-    bool openSerial();
-    void closeSerial();
-    std::string readLine();
+    // Parsing
+    static constexpr size_t READ_CHUNK = 256;
+    NmeaParser parser_;
+    UbxParser ubx_;
+    int64_t parseNs_;
+    uint32_t sequence_;   // Of the last published fix
+    bool configuring_;  // NMEA output also proves the baud rate while probing
+    bool consumeInput();
 };
 
 } // namespace sensors
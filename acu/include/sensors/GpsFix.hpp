@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+namespace drone {
+namespace sensors {
+
+// One receiver navigation epoch, whichever protocol it was decoded from
+struct GpsFix {
+    double latitude{0};          // Degrees, north positive
+    double longitude{0};         // Degrees, east positive
+    float altitude{0};           // Meters above mean sea level
+    float speed{0};              // m/s over ground
+    float course{0};             // Degrees from true north
+    float velocityNorth{0};      // m/s
+    float velocityEast{0};       // m/s
+    float velocityDown{0};       // m/s, 0 when the receiver does not report it
+    float horizontalAccuracy{0}; // Meters, 0 when unknown
+    float verticalAccuracy{0};   // Meters, 0 when unknown
+    int satellites{0};
+    bool fix{false};
+    float hdop{0};               // Horizontal dilution of precision
+    uint32_t timeOfDayMs{0};     // UTC
+    int64_t timestampNs{0};      // Arrival of the first byte of the epoch's first message
+    uint32_t sequence{0};        // Consecutive per published epoch, from 1
+};
+
+} // namespace sensors
+} // namespace drone
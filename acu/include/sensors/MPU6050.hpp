@@ -1,25 +1,54 @@
 #pragma once
 
+#include "hal/GpioLine.hpp"
+#include "hal/I2CDevice.hpp"
+#include "utils/SpscRing.hpp"
 #include <cstdint>
 #include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
 
 namespace drone {
 namespace sensors {
 
 class MPU6050 {
 public:
-    MPU6050();
+    // Uses /dev/i2c-1 unless a transport is supplied. interruptPin is the
+    // GPIO wired to INT; without it the sampling thread polls the FIFO.
+    explicit MPU6050(std::unique_ptr<hal::I2CDevice> device = nullptr, int interruptPin = -1);
     ~MPU6050();
 
     // Initialization and calibration
     bool init();
     bool calibrate();
 
-    // Data reading
-    bool update();
-    float getRoll() const { return roll_; }
-    float getPitch() const { return pitch_; }
-    float getYaw() const { return yaw_; }
+    // Sampling thread. Drains the FIFO on each data-ready interrupt and
+    // publishes timestamped samples to the ring. priority > 0 requests
+    // SCHED_FIFO.
+    bool start(int priority = 0);
+    void stop();
+
+    // One calibrated sample, timestamped on the sensor clock
+    struct ImuSample {
+        int64_t timestampNs;   // CLOCK_MONOTONIC
+        uint32_t sequence;     // Consecutive per sample; gaps mean lost samples
+        float ax, ay, az;      // g
+        float gx, gy, gz;      // deg/s
+    };
+
+    struct Statistics {
+        uint64_t samples{0};
+        uint64_t fifoOverflows{0};
+        uint64_t ringDrops{0};
+        uint64_t clockResyncs{0};
+        uint64_t readErrors{0};
+    };
+
+    // Consumer side, one thread only
+    bool readSample(ImuSample& sample) { return samples_.pop(sample); }
+
+    Statistics getStatistics() const;
 
     // Raw data access
     struct RawData {
@@ -29,42 +58,74 @@ public:
     };
     RawData getRawData() const { return rawData_; }
 
+    static constexpr uint32_t SAMPLE_RATE_HZ = 1000;
+
 private:
     // I2C communication
     static constexpr uint8_t MPU6050_ADDR = 0x68;
-    int i2cFd_;
+    std::unique_ptr<hal::I2CDevice> device_;
     bool writeReg(uint8_t reg, uint8_t value);
-    uint8_t readReg(uint8_t reg);
     bool readRegs(uint8_t reg, uint8_t* buffer, size_t length);
 
     // Sensor registers
-    static constexpr uint8_t ACCEL_XOUT_H = 0x3B;
-    static constexpr uint8_t GYRO_XOUT_H = 0x43;
-    static constexpr uint8_t PWR_MGMT_1 = 0x6B;
+    static constexpr uint8_t SMPLRT_DIV = 0x19;
     static constexpr uint8_t CONFIG = 0x1A;
     static constexpr uint8_t GYRO_CONFIG = 0x1B;
     static constexpr uint8_t ACCEL_CONFIG = 0x1C;
+    static constexpr uint8_t FIFO_EN = 0x23;
+    static constexpr uint8_t INT_PIN_CFG = 0x37;
+    static constexpr uint8_t INT_ENABLE = 0x38;
+    static constexpr uint8_t ACCEL_XOUT_H = 0x3B;
+    static constexpr uint8_t GYRO_XOUT_H = 0x43;
+    static constexpr uint8_t USER_CTRL = 0x6A;
+    static constexpr uint8_t PWR_MGMT_1 = 0x6B;
+    static constexpr uint8_t FIFO_COUNT_H = 0x72;
+    static constexpr uint8_t FIFO_R_W = 0x74;
+
+    // FIFO layout: accel XYZ then gyro XYZ, big-endian, no temperature
+    static constexpr size_t FIFO_SIZE = 1024;
+    static constexpr size_t FIFO_SAMPLE_BYTES = 12;
+    static constexpr size_t FIFO_BURST_SAMPLES = 16;  // Samples per I2C read
+    static constexpr int POLL_TIMEOUT_MS = 5;         // FIFO check without INT
 
     // Data processing
-    void processIMUData();
-    void updateAttitude(float dt);
+    bool readRawData();
+
+    // Sampling thread
+    bool resetFifo();
+    void samplingLoop();
+    void drainFifo(int64_t edgeNs, uint32_t edges);
+    int64_t timestampSample(uint32_t sequence) const;
+    void correctClock(uint32_t sequence, int64_t observedNs);
+
+    std::unique_ptr<hal::GpioLine> interrupt_;
+    std::unique_ptr<std::thread> samplingThread_;
+    std::atomic<bool> running_{false};
+    int stopFd_;
+
+    utils::SpscRing<ImuSample, 256> samples_;
+
+    // Sensor clock model: sample n was taken at anchorNs_ + (n - anchorSeq_) * periodNs_
+    bool clockAnchored_;
+    uint32_t anchorSeq_;
+    double anchorNs_;
+    double periodNs_;
+    uint32_t nextSequence_;
+
+    std::atomic<uint64_t> sampleCount_{0};
+    std::atomic<uint64_t> fifoOverflows_{0};
+    std::atomic<uint64_t> clockResyncs_{0};
+    std::atomic<uint64_t> readErrors_{0};
 
     // Sensor data
     RawData rawData_;
-    float roll_{0}, pitch_{0}, yaw_{0};
-    
+
     // Calibration offsets
     struct {
         float ax{0}, ay{0}, az{0};
         float gx{0}, gy{0}, gz{0};
     } offsets_;
-
-    // Complementary filter coefficient
-    static constexpr float ALPHA = 0.96f;
-
-    // Previous update timestamp for dt calculation
-    uint64_t lastUpdate_{0};
 };
 
 } // namespace sensors
-} // namespace drone 
\ No newline at end of file
+} // namespace drone
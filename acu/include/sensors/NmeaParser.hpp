@@ -0,0 +1,120 @@
+#pragma once
+
+#include "sensors/GpsFix.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace drone {
+namespace sensors {
+
+// Byte-driven NMEA 0183 parser. Fields are decoded as their characters
+// arrive and the checksum is accumulated on the fly; a sentence only
+// changes the fix once its checksum matches. GGA and RMC sentences with the
+// same UTC time are merged into one epoch, which is published as a whole.
+// Nothing allocates and nothing throws.
+class NmeaParser {
+public:
+    using Fix = GpsFix;
+
+    struct Statistics {
+        uint64_t bytes{0};
+        uint64_t sentences{0};       // Sentences with a valid checksum
+        uint64_t checksumErrors{0};
+        uint64_t malformed{0};       // Overlong, truncated or unparseable
+        uint64_t fixes{0};           // Epochs published
+    };
+
+    NmeaParser();
+
+    // Returns true if these bytes completed at least one epoch; the latest
+    // is available from getFix(). Timestamps are CLOCK_MONOTONIC arrival
+    // times, either per byte or one for the whole block.
+    bool feed(const uint8_t* data, const int64_t* timestamps, size_t length);
+    bool feed(const uint8_t* data, size_t length, int64_t timestampNs);
+    bool feed(char c, int64_t timestampNs);
+
+    const Fix& getFix() const { return fix_; }
+    const Statistics& getStatistics() const { return stats_; }
+    void reset();
+
+private:
+    enum class State { WAIT_START, BODY, CHECKSUM_HIGH, CHECKSUM_LOW };
+    enum class Sentence { UNKNOWN, GGA, RMC };
+
+    // Fixed-point accumulator for the field being received: the value is
+    // mantissa / 10^decimals
+    struct Field {
+        int64_t mantissa;
+        uint8_t decimals;
+        uint8_t digits;
+        uint8_t length;
+        bool negative;
+        bool point;
+        bool valid;
+        char first;
+    };
+
+    // Values decoded from the current sentence, committed on a good checksum
+    struct Pending {
+        uint32_t present;  // Bit per field index
+        uint32_t timeOfDayMs;
+        double latitude;
+        double longitude;
+        float altitude;
+        float hdop;
+        float speed;
+        float course;
+        int quality;
+        int satellites;
+        char status;
+    };
+
+    static constexpr size_t MAX_SENTENCE_LENGTH = 96;
+    static constexpr size_t MAX_FIELD_LENGTH = 20;
+    static constexpr size_t MAX_FIELDS = 32;
+    static constexpr uint8_t MAX_DECIMALS = 9;
+    static constexpr uint32_t TIME_UNKNOWN = 0xFFFFFFFF;
+
+    void beginSentence();
+    void beginField();
+    void accumulate(char c);
+    void endField();
+    bool endSentence();
+
+    bool commitGga();
+    bool commitRmc();
+    bool startEpoch(uint32_t timeOfDayMs);
+    bool publish();
+
+    static bool parseTime(const Field& field, uint32_t& timeOfDayMs);
+    static double toDegrees(const Field& field);
+    static float toFloat(const Field& field);
+    static int hexValue(char c);
+
+    bool has(size_t index) const { return (pending_.present >> index) & 1u; }
+
+    // Sentence framing
+    State state_;
+    Sentence sentence_;
+    size_t length_;
+    size_t fieldIndex_;
+    uint8_t checksum_;
+    uint8_t expected_;
+    int64_t sentenceStartNs_;
+    char address_[5];
+    Field field_;
+    Pending pending_;
+
+    // Epoch being assembled from GGA and RMC
+    Fix epoch_;
+    uint32_t epochTime_;
+    bool epochHasGga_;
+    bool epochHasRmc_;
+    bool epochPublished_;
+
+    Fix fix_;
+    Statistics stats_;
+};
+
+} // namespace sensors
+} // namespace drone
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace drone {
+namespace sensors {
+
+// The last Size samples of one sensor in capture order, for lining up
+// measurements taken at different times. T needs int64_t timestampNs and
+// uint32_t sequence members; at() also needs an
+// interpolate(const T&, const T&, float) found by argument-dependent lookup.
+//
+// Lookups are binary searches on the timestamps, so they cost the same
+// whatever the history length. Not thread-safe: a history belongs to the
+// thread that pushes to it, like the estimators it feeds.
+template<typename T, size_t Size>
+class SampleHistory {
+    static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "SampleHistory size must be a power of two");
+
+public:
+    SampleHistory() : next_(0), count_(0), gaps_(0), outOfOrder_(0) {}
+
+    // Samples must arrive in timestamp order; an older one is dropped
+    bool push(const T& sample) {
+        if (count_ > 0) {
+            const T& last = newest();
+            if (sample.timestampNs < last.timestampNs) {
+                outOfOrder_++;
+                return false;
+            }
+            if (sample.sequence != last.sequence + 1) {
+                gaps_++;
+            }
+        }
+        buffer_[next_ & MASK] = sample;
+        next_++;
+        if (count_ < Size) {
+            count_++;
+        }
+        return true;
+    }
+
+    void clear() { count_ = 0; }
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    // index 0 is the oldest held; only valid below size()
+    const T& operator[](size_t index) const { return buffer_[(next_ - count_ + index) & MASK]; }
+    const T& newest() const { return buffer_[(next_ - 1) & MASK]; }
+    const T& oldest() const { return (*this)[0]; }
+
+    // Value at timestampNs, interpolated between the samples either side.
+    // Fails outside the span held: no extrapolation.
+    bool at(int64_t timestampNs, T& sample) const {
+        if (count_ == 0 || timestampNs < oldest().timestampNs ||
+            timestampNs > newest().timestampNs) {
+            return false;
+        }
+
+        const size_t after = firstAtOrAfter(timestampNs);
+        const T& next = (*this)[after];
+        if (next.timestampNs == timestampNs || after == 0) {
+            sample = next;
+            return true;
+        }
+
+        const T& previous = (*this)[after - 1];
+        const float fraction = static_cast<float>(timestampNs - previous.timestampNs) /
+                               static_cast<float>(next.timestampNs - previous.timestampNs);
+        sample = interpolate(previous, next, fraction);
+        sample.timestampNs = timestampNs;
+        sample.sequence = previous.sequence;
+        return true;
+    }
+
+    // Copies the samples taken after timestampNs, oldest first, up to
+    // maxSamples of them; returns how many were copied
+    size_t since(int64_t timestampNs, T* samples, size_t maxSamples) const {
+        size_t index = firstAtOrAfter(timestampNs + 1);
+        size_t copied = 0;
+        while (index < count_ && copied < maxSamples) {
+            samples[copied++] = (*this)[index++];
+        }
+        return copied;
+    }
+
+    // Sequence jumps between consecutive samples: samples the driver lost
+    uint64_t gaps() const { return gaps_; }
+    uint64_t outOfOrder() const { return outOfOrder_; }
+
+private:
+    static constexpr size_t MASK = Size - 1;
+
+    // Index of the first held sample at or after timestampNs, size() if none
+    size_t firstAtOrAfter(int64_t timestampNs) const {
+        size_t low = 0;
+        size_t high = count_;
+        while (low < high) {
+            size_t middle = (low + high) / 2;
+            if ((*this)[middle].timestampNs < timestampNs) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    std::array<T, Size> buffer_;
+    size_t next_;    // Total pushed; the slot after the newest
+    size_t count_;
+    uint64_t gaps_;
+    uint64_t outOfOrder_;
+};
+
+} // namespace sensors
+} // namespace drone
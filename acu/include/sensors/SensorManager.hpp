@@ -1,11 +1,24 @@
 #pragma once
 
+#include "Config.hpp"
 #include "sensors/MPU6050.hpp"
 #include "sensors/GPS.hpp"
+#include "sensors/SampleHistory.hpp"
+#include "sensors/SensorSamples.hpp"
+#include "sensors/SensorSnapshot.hpp"
 #include "sensors/Ultrasonic.hpp"
+#include "estimation/AltitudeEstimator.hpp"
+#include "estimation/AttitudeEstimator.hpp"
+#include "estimation/PositionEstimator.hpp"
+#include "filters/BiquadBank.hpp"
+#include "geodesy/LocalFrame.hpp"
+#include "filters/SpectrumAnalyzer.hpp"
 #include "protocol/Packet.hpp"
+#include "topics/Topics.hpp"
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <ostream>
 
 namespace drone {
 namespace sensors {
@@ -18,13 +31,52 @@ public:
     // Lifecycle methods
     bool start();
     void stop();
-    void update();
+
+    // Per-sensor updates, scheduled individually at each sensor's own rate.
+    // updateIMU() integrates whatever the IMU sampling thread has queued.
+    void updateIMU();
+    void updateGPS();
+    void updateUltrasonic(int64_t nowNs);
+    void updateBatteryVoltage();
+
+    // Everything the control tick needs, under one lock. Taken once per
+    // tick and passed to each consumer; the accessors below are for
+    // callers outside the tick.
+    SensorSnapshot snapshot(int64_t nowNs) const;
 
     // Sensor data accessors
-    protocol::TelemetryData getTelemetryData();
     bool isCalibrated() const { return isCalibrated_; }
-    float getAltitude() const;
+    float getAltitude() const;     // m above mean sea level, fused
+    float getHeight() const;       // m above the takeoff ground, fused
+    float getClimbRate() const;    // m/s, up positive
+    geodesy::Enu getLocalPosition() const;    // Fused, from home; zero until the first fix
+    geodesy::LocalFrame getLocalFrame() const;
     float getBatteryVoltage() const;
+    protocol::SpectrumData getSpectrumData(size_t axis) const;
+
+    // Recent timestamped samples per sensor, for the value at a given time
+    // or everything since it. Scheduler thread only, like the updates that
+    // fill them. 256 IMU samples span 256 ms, well past the GPS latency.
+    using ImuHistory = SampleHistory<MPU6050::ImuSample, 256>;
+    using AttitudeHistory = SampleHistory<AttitudeSample, 256>;
+    using GpsHistory = SampleHistory<GpsFix, 16>;
+    using RangeHistory = SampleHistory<Ultrasonic::Measurement, 32>;
+    using BatteryHistory = SampleHistory<topics::Battery, 16>;
+    const ImuHistory& getImuHistory() const { return imuHistory_; }
+    const AttitudeHistory& getAttitudeHistory() const { return attitudeHistory_; }
+    const GpsHistory& getGpsHistory() const { return gpsHistory_; }
+    const RangeHistory& getRangeHistory() const { return rangeHistory_; }
+    const BatteryHistory& getBatteryHistory() const { return batteryHistory_; }
+
+    // Attitude estimator cost per IMU sample
+    struct EstimatorStatistics {
+        uint64_t updates{0};
+        uint64_t overBudget{0};
+        int64_t maxNs{0};
+        int64_t meanNs{0};
+    };
+    EstimatorStatistics getEstimatorStatistics() const;
+    void report(std::ostream& out) const;
 
 private:
     // Sensor instances
@@ -35,6 +87,55 @@ private:
     // Calibration
     bool performCalibration();
     bool isCalibrated_;
+    int imuPriority_;
+
+    // IMU filtering: stage 0 low-passes every channel, the next stages are
+    // gyro notches that follow the vibration peaks found by the analyzer
+    static constexpr size_t LOW_PASS_STAGE = 0;
+    static constexpr size_t NOTCH_STAGE = 1;
+    static constexpr float NOTCH_Q = 3.0f;
+    static constexpr float NOTCH_MIN_HZ = 60.0f;
+    static constexpr float NOTCH_MAX_HZ = 450.0f;
+    filters::BiquadBank imuFilter_;
+    filters::SpectrumAnalyzer spectrum_;
+    void retuneNotches(size_t axis);
+
+    // Attitude estimation, fed from the filtered IMU samples
+    std::unique_ptr<estimation::AttitudeEstimator> estimator_;
+    bool estimatorInitialized_;
+    int64_t lastImuSampleNs_;
+
+    // Vertical channel, predicted with every IMU sample
+    estimation::AltitudeEstimator altitudeEstimator_;
+    float tiltCosine_;          // Body z axis against vertical, for the range sensor
+    int64_t lastGpsFixNs_;
+    static constexpr float GRAVITY = 9.80665f;
+    static constexpr int64_t GPS_LATENCY_NS = 50000000;  // Solution age at its first byte
+    static constexpr float RANGE_MIN = 0.05f;            // Usable ultrasonic span, m
+    static constexpr float RANGE_MAX = 4.0f;
+    static constexpr float RANGE_MIN_TILT_COSINE = 0.87f;  // Within 30 degrees of level
+
+    // Horizontal channel, predicted with every IMU sample in meters north
+    // and east of home, the first fix
+    estimation::PositionEstimator positionEstimator_;
+    geodesy::LocalFrame localFrame_;
+    static constexpr float ALIGN_MIN_SPEED = 5.0f;          // m/s, course tracks heading
+    static constexpr float ALIGN_MIN_TILT_COSINE = 0.94f;   // Within 20 degrees, not turning hard
+
+    ImuHistory imuHistory_;
+    AttitudeHistory attitudeHistory_;
+    GpsHistory gpsHistory_;
+    RangeHistory rangeHistory_;
+    BatteryHistory batteryHistory_;
+    uint32_t batterySequence_;
+    AttitudeSample attitudeAt(int64_t timestampNs) const;
+
+    // A 1kHz IMU leaves the estimator a slice of the 1ms tick
+    static constexpr int64_t ESTIMATOR_BUDGET_NS = 100000;
+    uint64_t estimatorUpdates_;
+    uint64_t estimatorOverBudget_;
+    int64_t estimatorMaxNs_;
+    int64_t estimatorTotalNs_;
 
     // Thread safety
     mutable std::mutex dataMutex_;
@@ -42,21 +143,20 @@ private:
     // Sensor data cache
     struct {
         float roll{0}, pitch{0}, yaw{0};
-        float latitude{0}, longitude{0}, altitude{0};
+        double latitude{0}, longitude{0};
+        float altitude{0};
+        float east{0}, north{0};
+        float height{0}, climbRate{0};
         float ultrasonicDistance{0};
         float batteryVoltage{0};
+        int64_t attitudeNs{0}, gpsNs{0}, rangeNs{0}, batteryNs{0};   // Capture times
     } sensorData_;
+    protocol::SpectrumData spectrumData_[filters::SpectrumAnalyzer::AXES]{};
 
     // Battery monitoring
     static constexpr float BATTERY_VOLTAGE_PIN = 4;  // ADC pin for battery voltage
     static constexpr float VOLTAGE_DIVIDER_RATIO = 11.0f;  // For 4S LiPo
     float readBatteryVoltage();
-
-    // Update methods
-    void updateIMU();
-    void updateGPS();
-    void updateUltrasonic();
-    void updateBatteryVoltage();
 };
 
 } // namespace sensors
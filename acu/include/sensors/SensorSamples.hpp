@@ -0,0 +1,62 @@
+#pragma once
+
+#include "math/FastMath.hpp"
+#include "sensors/MPU6050.hpp"
+#include "sensors/Ultrasonic.hpp"
+#include <cstdint>
+
+namespace drone {
+namespace sensors {
+
+// Attitude estimate after one IMU sample
+struct AttitudeSample {
+    int64_t timestampNs{0};      // Of the IMU sample
+    uint32_t sequence{0};        // Of the IMU sample
+    float roll{0}, pitch{0}, yaw{0};   // Radians
+    float tiltCosine{1};         // Body z axis against vertical
+};
+
+// Linear interpolation between two samples for SampleHistory::at()
+
+inline float interpolateAngle(float a, float b, float fraction) {
+    // The short way round, for angles within (-pi, pi]
+    float difference = b - a;
+    if (difference > math::PI) difference -= 2.0f * math::PI;
+    if (difference < -math::PI) difference += 2.0f * math::PI;
+    float angle = a + fraction * difference;
+    if (angle > math::PI) angle -= 2.0f * math::PI;
+    if (angle <= -math::PI) angle += 2.0f * math::PI;
+    return angle;
+}
+
+inline AttitudeSample interpolate(const AttitudeSample& a, const AttitudeSample& b, float fraction) {
+    AttitudeSample sample = a;
+    sample.roll = interpolateAngle(a.roll, b.roll, fraction);
+    sample.pitch = a.pitch + fraction * (b.pitch - a.pitch);
+    sample.yaw = interpolateAngle(a.yaw, b.yaw, fraction);
+    sample.tiltCosine = a.tiltCosine + fraction * (b.tiltCosine - a.tiltCosine);
+    return sample;
+}
+
+inline MPU6050::ImuSample interpolate(const MPU6050::ImuSample& a, const MPU6050::ImuSample& b,
+                                      float fraction) {
+    MPU6050::ImuSample sample = a;
+    sample.ax = a.ax + fraction * (b.ax - a.ax);
+    sample.ay = a.ay + fraction * (b.ay - a.ay);
+    sample.az = a.az + fraction * (b.az - a.az);
+    sample.gx = a.gx + fraction * (b.gx - a.gx);
+    sample.gy = a.gy + fraction * (b.gy - a.gy);
+    sample.gz = a.gz + fraction * (b.gz - a.gz);
+    return sample;
+}
+
+inline Ultrasonic::Measurement interpolate(const Ultrasonic::Measurement& a,
+                                           const Ultrasonic::Measurement& b, float fraction) {
+    Ultrasonic::Measurement sample = a;
+    sample.distance = a.distance + fraction * (b.distance - a.distance);
+    sample.valid = a.valid && b.valid;
+    return sample;
+}
+
+} // namespace sensors
+} // namespace drone
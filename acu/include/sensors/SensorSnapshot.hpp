@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+namespace drone {
+namespace sensors {
+
+// Everything the control and safety logic reads about the vehicle, copied
+// out of the SensorManager under one lock at the start of a control tick.
+// Every consumer in the tick sees the same values.
+struct SensorSnapshot {
+    int64_t timestampNs{0};      // Monotonic time of the capture
+    bool calibrated{false};
+
+    // Attitude, degrees
+    float roll{0}, pitch{0}, yaw{0};
+
+    // Fused position
+    double latitude{0}, longitude{0};
+    float altitude{0};           // m above mean sea level
+    float height{0};             // m above the takeoff ground
+    float climbRate{0};          // m/s, up positive
+    bool hasHome{false};         // east/north are meaningful
+    float east{0}, north{0};     // m from home
+
+    float batteryVoltage{0};
+
+    // When each source last measured, 0 before its first sample. The
+    // attitude and fused position are as of the IMU sample at attitudeNs.
+    int64_t attitudeNs{0};
+    int64_t gpsNs{0};
+    int64_t rangeNs{0};
+    int64_t batteryNs{0};
+};
+
+} // namespace sensors
+} // namespace drone
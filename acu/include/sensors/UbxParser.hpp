@@ -0,0 +1,97 @@
+#pragma once
+
+#include "sensors/GpsFix.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace drone {
+namespace sensors {
+
+// Byte-driven decoder for the u-blox UBX binary protocol. Frames are
+// sync (0xB5 0x62), class, id, little-endian length, payload and an 8-bit
+// Fletcher checksum over everything between sync and checksum. NAV-PVT
+// frames become fixes; ACK/NAK frames are recorded for the configuration
+// handshake. Fixed-layout payloads are decoded by offset; nothing
+// allocates.
+class UbxParser {
+public:
+    // Message classes and ids used by the driver
+    static constexpr uint8_t CLASS_NAV = 0x01;
+    static constexpr uint8_t CLASS_ACK = 0x05;
+    static constexpr uint8_t CLASS_CFG = 0x06;
+    static constexpr uint8_t CLASS_MON = 0x0A;
+    static constexpr uint8_t NAV_PVT = 0x07;
+    static constexpr uint8_t ACK_NAK = 0x00;
+    static constexpr uint8_t ACK_ACK = 0x01;
+    static constexpr uint8_t CFG_PRT = 0x00;
+    static constexpr uint8_t CFG_MSG = 0x01;
+    static constexpr uint8_t CFG_RATE = 0x08;
+    static constexpr uint8_t MON_VER = 0x04;
+
+    static constexpr size_t NAV_PVT_LENGTH = 92;
+    static constexpr size_t FRAME_OVERHEAD = 8;
+
+    struct Ack {
+        uint8_t messageClass{0};
+        uint8_t messageId{0};
+        bool accepted{false};
+    };
+
+    struct Statistics {
+        uint64_t bytes{0};
+        uint64_t frames{0};          // Frames with a valid checksum
+        uint64_t checksumErrors{0};
+        uint64_t oversized{0};       // Valid frames too long to decode
+        uint64_t fixes{0};           // NAV-PVT epochs published
+        uint64_t acks{0};            // ACK and NAK frames
+    };
+
+    UbxParser();
+
+    // Returns true if these bytes completed a NAV-PVT epoch; the latest is
+    // available from getFix(). Timestamps are CLOCK_MONOTONIC arrival times.
+    bool feed(const uint8_t* data, const int64_t* timestamps, size_t length);
+    bool feed(uint8_t byte, int64_t timestampNs);
+
+    const GpsFix& getFix() const { return fix_; }
+    const Ack& getLastAck() const { return lastAck_; }
+    const Statistics& getStatistics() const { return stats_; }
+    void reset();
+
+    // Writes a complete frame to out and returns its length, or 0 if it
+    // does not fit in capacity
+    static size_t encode(uint8_t messageClass, uint8_t messageId, const uint8_t* payload,
+                         uint16_t length, uint8_t* out, size_t capacity);
+
+private:
+    enum class State { SYNC1, SYNC2, CLASS, ID, LENGTH_LOW, LENGTH_HIGH, PAYLOAD, CHECK_A, CHECK_B };
+
+    static constexpr uint8_t SYNC_CHAR_1 = 0xB5;
+    static constexpr uint8_t SYNC_CHAR_2 = 0x62;
+    static constexpr size_t MAX_PAYLOAD = 128;
+
+    void checksum(uint8_t byte) {
+        checkA_ = static_cast<uint8_t>(checkA_ + byte);
+        checkB_ = static_cast<uint8_t>(checkB_ + checkA_);
+    }
+
+    bool endFrame();
+    bool decodeNavPvt();
+
+    State state_;
+    uint8_t class_;
+    uint8_t id_;
+    uint16_t length_;
+    uint16_t received_;
+    uint8_t checkA_;
+    uint8_t checkB_;
+    int64_t frameStartNs_;
+    uint8_t payload_[MAX_PAYLOAD];
+
+    GpsFix fix_;
+    Ack lastAck_;
+    Statistics stats_;
+};
+
+} // namespace sensors
+} // namespace drone
@@ -1,46 +1,93 @@
 #pragma once
 
+#include "hal/GpioLine.hpp"
+#include "utils/SeqLock.hpp"
+#include <array>
 #include <cstdint>
-#include <chrono>
 
 namespace drone {
 namespace sensors {
 
+// HC-SR04 style ranger driven as a non-blocking state machine. trigger()
+// fires a ping, the echo pulse is timed from GPIO edge timestamps, and
+// poll() turns completed echoes into filtered measurements. Neither call
+// waits on the sensor.
 class Ultrasonic {
 public:
+    struct Measurement {
+        float distance{0.0f};     // Filtered distance in meters
+        int64_t timestampNs{0};   // Echo start, CLOCK_MONOTONIC
+        uint32_t sequence{0};     // Consecutive per published measurement, from 1
+        bool valid{false};
+    };
+
+    struct Statistics {
+        uint64_t pings{0};
+        uint64_t echoes{0};
+        uint64_t timeouts{0};
+        uint64_t outOfRange{0};
+        uint64_t outliers{0};
+    };
+
     Ultrasonic(int triggerPin, int echoPin);
     ~Ultrasonic();
 
     // Initialization
     bool init();
 
-    // Measurement
-    float getDistance();  // Returns distance in meters
-    bool isInRange() const { return lastDistance_ >= MIN_DISTANCE && lastDistance_ <= MAX_DISTANCE; }
+    // Measurement cycle, called from the scheduler: poll() the previous
+    // ping, then trigger() the next one
+    void trigger(int64_t nowNs);
+    bool poll(int64_t nowNs);   // True when a new measurement was published
+
+    // Latest filtered measurement, safe to read from any thread
+    Measurement getMeasurement() const;
+    float getDistance() const { return getMeasurement().distance; }
+    bool isInRange() const { return getMeasurement().valid; }
+    Statistics getStatistics() const { return stats_; }
 
 private:
-    // GPIO pins
-    const int triggerPin_;
-    const int echoPin_;
+    enum class State {
+        IDLE,
+        WAITING_FOR_RISE,
+        WAITING_FOR_FALL
+    };
 
     // Constants
     static constexpr float SPEED_OF_SOUND = 343.0f;  // meters per second at 20°C
     static constexpr float MIN_DISTANCE = 0.02f;     // 2cm minimum range
     static constexpr float MAX_DISTANCE = 4.0f;      // 4m maximum range
-    static constexpr float TIMEOUT_SECONDS = 0.025f; // 25ms timeout
+    static constexpr int64_t ECHO_TIMEOUT_NS = 25000000;   // 25ms, past max range
+    static constexpr int64_t TRIGGER_PULSE_NS = 10000;     // 10us trigger pulse
+    static constexpr float OUTLIER_THRESHOLD = 0.3f;       // Meters from the median
+    static constexpr int OUTLIER_ACCEPT_COUNT = 3;         // Consecutive rejects taken as a real step
+    static constexpr size_t MEDIAN_WINDOW = 5;
+
+    // GPIO lines
+    hal::GpioLine trigger_;
+    hal::GpioLine echo_;
+
+    // Ping state
+    State state_;
+    int64_t triggerNs_;
+    int64_t echoStartNs_;
 
-    // Last measurement
-    float lastDistance_;
+    // Median/outlier filter
+    std::array<float, MEDIAN_WINDOW> window_;
+    size_t windowCount_;
+    size_t windowNext_;
+    int consecutiveOutliers_;
+    uint32_t sequence_;
 
-    // GPIO operations
-    bool setupGPIO();
-    void cleanup();
-    void sendTrigger();
-    std::chrono::microseconds waitForEcho();
+    utils::SeqLock<Measurement> measurement_;
+    Statistics stats_;
 
-    // Utility functions
-    float calculateDistance(std::chrono::microseconds echoTime);
+    // Helpers
+    void drainEvents();
+    bool filter(float distance, float& filtered);
+    float median() const;
+    static float calculateDistance(int64_t echoNs);
 };
 
 } // namespace sensors
-} // namespace drone 
\ No newline at end of file
+} // namespace drone
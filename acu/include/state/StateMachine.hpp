@@ -2,7 +2,9 @@
 
 #include "control/FlightController.hpp"
 #include "sensors/SensorManager.hpp"
+#include "sensors/SensorSnapshot.hpp"
 #include "communication/CommunicationManager.hpp"
+#include "navigation/Geofence.hpp"
 #include <chrono>
 
 namespace drone {
@@ -24,8 +26,8 @@ public:
     StateMachine();
     ~StateMachine();
 
-    // State management
-    void update();
+    // State management, from the control tick's sensor snapshot
+    void update(const sensors::SensorSnapshot& snapshot);
     State getState() const { return currentState_; }
     
     // Component setters
@@ -38,12 +40,16 @@ public:
     void setCommunicationManager(communication::CommunicationManager* manager) {
         commManager_ = manager;
     }
+    void setGeofence(navigation::Geofence* geofence) {
+        geofence_ = geofence;
+    }
 
 private:
     // Components
     control::FlightController* flightController_;
     sensors::SensorManager* sensorManager_;
     communication::CommunicationManager* commManager_;
+    navigation::Geofence* geofence_;
 
     // State tracking
     State currentState_;
@@ -57,24 +63,27 @@ private:
 
     // State handlers
     void handleInitializing();
-    void handleCalibrating();
+    void handleCalibrating(const sensors::SensorSnapshot& snapshot);
     void handleIdle();
     void handleArmed();
     void handleFlying();
-    void handleEmergency();
+    void handleEmergency(const sensors::SensorSnapshot& snapshot);
     void handleError();
 
     // Safety checks
-    bool checkSensors() const;
+    bool checkSensors(const sensors::SensorSnapshot& snapshot) const;
     bool checkCommunication() const;
-    bool checkBattery() const;
-    bool checkAttitude() const;
+    bool checkBattery(const sensors::SensorSnapshot& snapshot) const;
+    bool checkAttitude(const sensors::SensorSnapshot& snapshot) const;
+    bool checkGeofence(const sensors::SensorSnapshot& snapshot);
 
     // Constants
     static constexpr auto HEARTBEAT_TIMEOUT = std::chrono::milliseconds(500);
     static constexpr auto EMERGENCY_RECOVERY_TIME = std::chrono::seconds(5);
     static constexpr float MIN_BATTERY_VOLTAGE = 14.0f;  // 4S LiPo minimum
     static constexpr float MAX_SAFE_ANGLE = 45.0f;       // Maximum safe tilt angle
+    static constexpr float GEOFENCE_WARNING_DISTANCE = 50.0f;  // m inside the fence
+    bool geofenceWarned_;
 };
 
 } // namespace state
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "runtime/Topic.hpp"
+#include "sensors/GpsFix.hpp"
+#include <cstdint>
+
+namespace drone {
+namespace topics {
+
+// Messages passed between ACU components through the topic bus. Each
+// topic has one publisher; anyone may subscribe. Timestamps are
+// runtime::monotonicNanoseconds().
+
+// One MPU6050 sample as read, before filtering
+struct ImuRaw {
+    int64_t timestampNs{0};
+    uint32_t sequence{0};
+    float accel[3]{};     // g, body axes
+    float gyro[3]{};      // deg/s
+};
+
+struct Attitude {
+    int64_t timestampNs{0};
+    float roll{0}, pitch{0}, yaw{0};   // Degrees
+};
+
+// Fused position from the vertical and horizontal estimators
+struct Position {
+    int64_t timestampNs{0};
+    double latitude{0}, longitude{0};
+    float altitude{0};           // m above mean sea level
+    float height{0};             // m above the takeoff ground
+    float climbRate{0};          // m/s, up positive
+    float east{0}, north{0};     // m from home, zero until the first fix
+};
+
+// Pilot command from the ground station, in raw link units (0-4095)
+struct ControlSetpoint {
+    int64_t timestampNs{0};
+    uint16_t thrust{0};
+    uint16_t elevator{0};
+    uint16_t rudder{0};
+    uint16_t ailerons{0};
+};
+
+// PWM values sent to the outputs (0-4095)
+struct ActuatorOutputs {
+    int64_t timestampNs{0};
+    uint16_t motor{0};
+    uint16_t elevator{0};
+    uint16_t rudder{0};
+    uint16_t ailerons{0};
+};
+
+struct Battery {
+    int64_t timestampNs{0};
+    uint32_t sequence{0};   // Consecutive per reading
+    float voltage{0};
+};
+
+// The topics. Slot counts cover the slowest queued reader: imu_raw keeps
+// 32 ms of samples, the rest only ever need the latest few.
+using ImuRawTopic = runtime::Topic<ImuRaw, 32>;
+using AttitudeTopic = runtime::Topic<Attitude, 4>;
+using PositionTopic = runtime::Topic<Position, 4>;
+using GpsFixTopic = runtime::Topic<sensors::GpsFix, 4>;
+using ControlSetpointTopic = runtime::Topic<ControlSetpoint, 4>;
+using ActuatorOutputsTopic = runtime::Topic<ActuatorOutputs, 4>;
+using BatteryTopic = runtime::Topic<Battery, 4>;
+
+extern ImuRawTopic imuRaw;
+extern AttitudeTopic attitude;
+extern PositionTopic position;
+extern GpsFixTopic gpsFix;
+extern ControlSetpointTopic controlSetpoint;
+extern ActuatorOutputsTopic actuatorOutputs;
+extern BatteryTopic battery;
+
+} // namespace topics
+} // namespace drone
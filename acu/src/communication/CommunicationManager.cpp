@@ -1,11 +1,12 @@
 #include "communication/CommunicationManager.hpp"
 #include "protocol/Packet.hpp"
-#include "control/FlightController.hpp"
+#include "runtime/Clock.hpp"
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <errno.h>
 #include <cstring>
 #include <iostream>
@@ -18,10 +19,9 @@ namespace communication {
 using namespace protocol;  // Add access to protocol types
 
 namespace {
-    constexpr auto TELEMETRY_INTERVAL = std::chrono::milliseconds(50);  // 20Hz
-    constexpr auto HEARTBEAT_INTERVAL = std::chrono::milliseconds(100); // 10Hz
     constexpr auto HEARTBEAT_TIMEOUT = std::chrono::milliseconds(500);  // 2Hz minimum
     constexpr size_t MAX_PACKET_SIZE = 1024;
+    constexpr int RECEIVE_POLL_TIMEOUT_MS = 50;  // Bounds shutdown latency only
 }
 
 CommunicationManager::CommunicationManager(const struct Config& config)
@@ -29,9 +29,16 @@ CommunicationManager::CommunicationManager(const struct Config& config)
     , gcu_port_(config.gcu_port)
     , local_port_(config.local_port)
     , socket_fd_(-1)
-    , flight_controller_(nullptr)
+    , attitude_subscription_(topics::attitude)
+    , position_subscription_(topics::position)
+    , outputs_subscription_(topics::actuatorOutputs)
+    , battery_subscription_(topics::battery)
+    , telemetry_{}
     , running_(false)
+    , handshake_(config.drone_id.empty() ? ConnectionHandshake::defaultDroneId() : config.drone_id,
+                 [this](const Packet& packet) { sendPacket(packet); })
     , connected_(false) {
+    std::memset(&gcu_endpoint_, 0, sizeof(gcu_endpoint_));
 }
 
 CommunicationManager::~CommunicationManager() {
@@ -43,6 +50,12 @@ bool CommunicationManager::init() {
         std::cerr << "Failed to setup UDP socket" << std::endl;
         return false;
     }
+
+    // Configured GCU address, replaced by the ACK sender once connected
+    std::lock_guard<std::mutex> lock(endpoint_mutex_);
+    gcu_endpoint_.sin_family = AF_INET;
+    gcu_endpoint_.sin_port = htons(gcu_port_);
+    inet_pton(AF_INET, gcu_address_.c_str(), &gcu_endpoint_.sin_addr);
     return true;
 }
 
@@ -51,6 +64,9 @@ void CommunicationManager::start() {
     
     running_ = true;
     receive_thread_ = std::make_unique<std::thread>(&CommunicationManager::receiveLoop, this);
+
+    // Announce ourselves straight away rather than waiting for the first tick
+    handshake_.reset(std::chrono::steady_clock::now());
 }
 
 void CommunicationManager::stop() {
@@ -64,22 +80,8 @@ void CommunicationManager::stop() {
 }
 
 void CommunicationManager::update() {
-    static auto last_telemetry = std::chrono::steady_clock::now();
-    static auto last_heartbeat = std::chrono::steady_clock::now();
-    
-    auto now = std::chrono::steady_clock::now();
-    
-    // Send telemetry at regular intervals
-    if (now - last_telemetry >= TELEMETRY_INTERVAL) {
-        sendTelemetry();
-        last_telemetry = now;
-    }
-    
-    // Send heartbeat at regular intervals
-    if (now - last_heartbeat >= HEARTBEAT_INTERVAL) {
-        sendHeartbeat();
-        last_heartbeat = now;
-    }
+    // Drive handshake retransmissions
+    handshake_.poll(std::chrono::steady_clock::now());
     
     // Check connection status
     validateConnection();
@@ -121,39 +123,74 @@ void CommunicationManager::closeSocket() {
 void CommunicationManager::receiveLoop() {
     std::vector<uint8_t> buffer(MAX_PACKET_SIZE);
     struct sockaddr_in sender_addr;
-    socklen_t sender_len = sizeof(sender_addr);
+    struct pollfd pfd = {socket_fd_, POLLIN, 0};
     
     while (running_) {
-        ssize_t bytes_received = recvfrom(socket_fd_, buffer.data(), buffer.size(), 0,
-                                        (struct sockaddr*)&sender_addr, &sender_len);
-                                        
-        if (bytes_received > 0) {
-            try {
-                Packet packet = Packet::deserialize(buffer.data(), bytes_received);
-                if (packet.validate()) {
-                    handleIncomingPacket(packet);
+        // Sleep in the kernel until a datagram arrives instead of spinning
+        int ready = poll(&pfd, 1, RECEIVE_POLL_TIMEOUT_MS);
+        if (ready <= 0) {
+            if (ready < 0 && errno != EINTR) {
+                std::cerr << "Error polling socket: " << strerror(errno) << std::endl;
+            }
+            continue;
+        }
+
+        // Drain everything that is queued
+        while (running_) {
+            socklen_t sender_len = sizeof(sender_addr);
+            ssize_t bytes_received = recvfrom(socket_fd_, buffer.data(), buffer.size(), 0,
+                                            (struct sockaddr*)&sender_addr, &sender_len);
+            if (bytes_received > 0) {
+                try {
+                    Packet packet = Packet::deserialize(buffer.data(), bytes_received);
+                    if (packet.validate()) {
+                        handleIncomingPacket(packet, sender_addr);
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error processing received packet: " << e.what() << std::endl;
                 }
-            } catch (const std::exception& e) {
-                std::cerr << "Error processing received packet: " << e.what() << std::endl;
+            } else {
+                if (bytes_received < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                    std::cerr << "Error receiving data: " << strerror(errno) << std::endl;
+                }
+                break;
             }
-        } else if (bytes_received < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
-            std::cerr << "Error receiving data: " << strerror(errno) << std::endl;
         }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
 }
 
-void CommunicationManager::handleIncomingPacket(const Packet& packet) {
+void CommunicationManager::handleIncomingPacket(const Packet& packet,
+                                                const struct sockaddr_in& sender) {
     switch (packet.getType()) {
+        case PacketType::ACK:
+            if (handshake_.matchesAck(packet.getAckData())) {
+                // Talk to whichever ground station answered, starting with
+                // the SYNACK handleAck() sends
+                {
+                    std::lock_guard<std::mutex> lock(endpoint_mutex_);
+                    gcu_endpoint_ = sender;
+                }
+                handshake_.handleAck(packet.getAckData(), std::chrono::steady_clock::now());
+            }
+            break;
+
         case PacketType::CONTROL:
-            if (flight_controller_) {
+            handshake_.handlePeerTraffic();
+            {
+                // The receive thread is the only publisher of pilot commands
                 const auto& control_data = packet.getControlData();
-                flight_controller_->setControlInputs(control_data);
+                topics::ControlSetpoint setpoint;
+                setpoint.timestampNs = runtime::monotonicNanoseconds();
+                setpoint.thrust = control_data.thrust;
+                setpoint.elevator = control_data.elevator;
+                setpoint.rudder = control_data.rudder;
+                setpoint.ailerons = control_data.ailerons;
+                topics::controlSetpoint.publish(setpoint);
             }
             break;
             
         case PacketType::HEARTBEAT:
+            handshake_.handlePeerTraffic();
             {
                 std::lock_guard<std::mutex> lock(heartbeat_mutex_);
                 last_heartbeat_ = std::chrono::steady_clock::now();
@@ -175,26 +212,52 @@ void CommunicationManager::sendPacket(const Packet& packet) {
     std::vector<uint8_t> buffer = packet.serialize();
     
     struct sockaddr_in dest_addr;
-    dest_addr.sin_family = AF_INET;
-    dest_addr.sin_port = htons(gcu_port_);
-    inet_pton(AF_INET, gcu_address_.c_str(), &dest_addr.sin_addr);
+    {
+        std::lock_guard<std::mutex> lock(endpoint_mutex_);
+        dest_addr = gcu_endpoint_;
+    }
     
     sendto(socket_fd_, buffer.data(), buffer.size(), 0,
            (struct sockaddr*)&dest_addr, sizeof(dest_addr));
 }
 
 void CommunicationManager::sendTelemetry() {
-    if (!flight_controller_) return;
-    
-    protocol::TelemetryData telemetry;
-    // Populate telemetry data from flight controller
-    // flight_controller_->getTelemetryData(&telemetry);
-    
-    auto packet = Packet::createTelemetry(telemetry);
+    if (!handshake_.isConnected()) return;
+
+    // Each field keeps its last value until its topic publishes again
+    topics::Attitude attitude;
+    if (attitude_subscription_.update(attitude)) {
+        telemetry_.roll = attitude.roll;
+        telemetry_.pitch = attitude.pitch;
+        telemetry_.yaw = attitude.yaw;
+    }
+    topics::Position position;
+    if (position_subscription_.update(position)) {
+        telemetry_.latitude = position.latitude;
+        telemetry_.longitude = position.longitude;
+        telemetry_.altitude = position.altitude;
+        telemetry_.relative_alt = position.height;
+    }
+    topics::ActuatorOutputs outputs;
+    if (outputs_subscription_.update(outputs)) {
+        telemetry_.thrust_actual = outputs.motor;
+        telemetry_.elevator_actual = outputs.elevator;
+        telemetry_.rudder_actual = outputs.rudder;
+        telemetry_.ailerons_actual = outputs.ailerons;
+    }
+    topics::Battery battery;
+    if (battery_subscription_.update(battery)) {
+        telemetry_.battery_voltage = battery.voltage;
+    }
+
+    auto packet = Packet::createTelemetry(telemetry_);
     sendPacket(packet);
 }
 
 void CommunicationManager::sendHeartbeat() {
+    // The GCU drops traffic from drones without a session
+    if (!handshake_.isConnected()) return;
+
     protocol::HeartbeatData heartbeat;
     heartbeat.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::system_clock::now().time_since_epoch()
@@ -204,21 +267,26 @@ void CommunicationManager::sendHeartbeat() {
     sendPacket(packet);
 }
 
+void CommunicationManager::sendSpectrum(const protocol::SpectrumData& spectrum) {
+    if (!handshake_.isConnected()) return;
+
+    sendPacket(Packet::createSpectrum(spectrum));
+}
+
 bool CommunicationManager::validateConnection() {
     std::lock_guard<std::mutex> lock(heartbeat_mutex_);
     auto now = std::chrono::steady_clock::now();
     
-    if (now - last_heartbeat_ > HEARTBEAT_TIMEOUT) {
+    if (connected_ && now - last_heartbeat_ > HEARTBEAT_TIMEOUT) {
         connected_ = false;
+
+        // GCU went away (or rebooted): start over immediately
+        handshake_.reset(now);
     }
     
     return connected_;
 }
 
-void CommunicationManager::setFlightController(control::FlightController* controller) {
-    flight_controller_ = controller;
-}
-
 bool CommunicationManager::isConnected() const {
     return connected_;
 }
@@ -0,0 +1,161 @@
+#include "communication/ConnectionHandshake.hpp"
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+namespace drone {
+namespace communication {
+
+using namespace protocol;
+
+ConnectionHandshake::ConnectionHandshake(const std::string& droneId, SendFunction send)
+    : send_(std::move(send))
+    , state_(State::DISCONNECTED)
+    , requestToken_(0)
+    , sessionToken_(0)
+    , assignedAddress_(0)
+    , retryInterval_(INITIAL_RETRY_INTERVAL) {
+    std::memset(droneId_, 0, sizeof(droneId_));
+    std::memcpy(droneId_, droneId.data(), std::min(droneId.size(), sizeof(droneId_)));
+}
+
+void ConnectionHandshake::reset(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state_ = State::DISCOVERY;
+    requestToken_ = generateToken();
+    sessionToken_ = 0;
+    assignedAddress_ = 0;
+    retryInterval_ = INITIAL_RETRY_INTERVAL;
+    transmitLocked(now);
+}
+
+void ConnectionHandshake::poll(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ == State::DISCOVERY || state_ == State::CONNECTED) {
+        if (now >= nextTransmit_) {
+            transmitLocked(now);
+        }
+    }
+}
+
+bool ConnectionHandshake::matchesAck(const AckData& ack) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::memcmp(ack.drone_id, droneId_, sizeof(droneId_)) == 0 &&
+           ack.request_token == requestToken_;
+}
+
+bool ConnectionHandshake::handleAck(const AckData& ack, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (std::memcmp(ack.drone_id, droneId_, sizeof(droneId_)) != 0 ||
+        ack.request_token != requestToken_) {
+        return false;
+    }
+
+    if (state_ == State::DISCOVERY) {
+        sessionToken_ = ack.session_token;
+        assignedAddress_ = ack.assigned_address;
+        state_ = State::CONNECTED;
+        retryInterval_ = INITIAL_RETRY_INTERVAL;
+    }
+
+    // Duplicate ACKs mean our SYNACK was lost, so answer every one
+    if (state_ != State::DISCONNECTED) {
+        transmitLocked(now);
+    }
+    return true;
+}
+
+void ConnectionHandshake::handlePeerTraffic() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ == State::CONNECTED) {
+        state_ = State::ACTIVE;
+    }
+}
+
+ConnectionHandshake::State ConnectionHandshake::getState() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_;
+}
+
+bool ConnectionHandshake::isConnected() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_ == State::CONNECTED || state_ == State::ACTIVE;
+}
+
+uint32_t ConnectionHandshake::getAssignedAddress() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return assignedAddress_;
+}
+
+uint64_t ConnectionHandshake::getSessionToken() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessionToken_;
+}
+
+void ConnectionHandshake::transmitLocked(Clock::time_point now) {
+    switch (state_) {
+        case State::DISCOVERY: {
+            BeaconData beacon = {};
+            std::memcpy(beacon.drone_id, droneId_, sizeof(droneId_));
+            beacon.capabilities = CAPABILITIES;
+            beacon.version = FIRMWARE_VERSION;
+            beacon.signal_strength = 0;
+
+            SynData syn = {};
+            std::memcpy(syn.drone_id, droneId_, sizeof(droneId_));
+            syn.request_token = requestToken_;
+            syn.capabilities = CAPABILITIES;
+            syn.version = FIRMWARE_VERSION;
+            syn.preferred_channel = 0;
+
+            // Pipelined: SYN does not wait for the beacon to be answered
+            send_(Packet::createBeacon(beacon));
+            send_(Packet::createSyn(syn));
+            break;
+        }
+        case State::CONNECTED:
+        case State::ACTIVE: {
+            SynAckData synack = {};
+            std::memcpy(synack.drone_id, droneId_, sizeof(droneId_));
+            synack.address = assignedAddress_;
+            synack.session_token = sessionToken_;
+            send_(Packet::createSynAck(synack));
+            break;
+        }
+        default:
+            return;
+    }
+    scheduleRetryLocked(now);
+}
+
+void ConnectionHandshake::scheduleRetryLocked(Clock::time_point now) {
+    nextTransmit_ = now + retryInterval_;
+    retryInterval_ = std::min<Clock::duration>(retryInterval_ * 2, MAX_RETRY_INTERVAL);
+}
+
+std::string ConnectionHandshake::defaultDroneId() {
+    // Prefer the machine id, it survives reboots and hostname changes
+    std::ifstream machineId("/etc/machine-id");
+    std::string id;
+    if (machineId && std::getline(machineId, id) && !id.empty()) {
+        return id.substr(0, protocol::DRONE_ID_LENGTH);
+    }
+
+    char hostname[64] = {};
+    if (gethostname(hostname, sizeof(hostname) - 1) == 0) {
+        return std::string(hostname).substr(0, protocol::DRONE_ID_LENGTH);
+    }
+    return "acu";
+}
+
+uint64_t ConnectionHandshake::generateToken() {
+    static std::random_device rd;
+    static std::mt19937_64 gen(rd());
+    static std::uniform_int_distribution<uint64_t> dis;
+    return dis(gen);
+}
+
+} // namespace communication
+} // namespace drone
@@ -1,6 +1,10 @@
 #include "control/FlightController.hpp"
+#include "runtime/Clock.hpp"
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cmath>
+#include <iostream>
 
 namespace drone {
 namespace control {
@@ -9,15 +13,58 @@ namespace {
     constexpr float MAX_SAFE_ANGLE = 45.0f;  // Maximum safe tilt angle in degrees
     constexpr float MIN_SAFE_VOLTAGE = 14.0f; // Minimum safe battery voltage for 4S LiPo
     constexpr float MAX_INTEGRAL = 20.0f;     // Maximum integral term for PID
-    constexpr float CONTROL_RATE = 200.0f;    // Control loop rate in Hz
-    constexpr float DT = 1.0f / CONTROL_RATE; // Control loop period in seconds
+
+    // PID outputs are offsets in PWM counts
+    constexpr float OUTPUT_LIMIT = 2047.0f;
+    constexpr float SURFACE_SLEW_RATE = 40000.0f;   // Counts/s, full travel in 0.1s
+    constexpr float THRUST_SLEW_RATE = 8000.0f;     // Counts/s, full range in 0.5s
+    constexpr float ATTITUDE_DERIVATIVE_CUTOFF_HZ = 30.0f;
+    constexpr float ALTITUDE_DERIVATIVE_CUTOFF_HZ = 5.0f;
+
+    PidBank::Gains makeGains(float kp, float ki, float kd, float cutoffHz, float slewRate) {
+        PidBank::Gains gains;
+        gains.kp = kp;
+        gains.ki = ki;
+        gains.kd = kd;
+        gains.derivativeCutoffHz = cutoffHz;
+        gains.integralLimit = MAX_INTEGRAL;
+        gains.outputLimit = OUTPUT_LIMIT;
+        gains.slewRate = slewRate;
+        return gains;
+    }
+
+    static_assert(Mixer::OUTPUTS == PWMController::CHANNELS, "Mixer outputs are the PWM channels");
+
+    const Mixer::Airframe& airframeOrDefault(const std::string& name) {
+        const Mixer::Airframe* airframe = Mixer::find(name);
+        return airframe ? *airframe : airframes::CONVENTIONAL;
+    }
 }
 
 FlightController::FlightController(const Config& config)
-    : sensorManager_(nullptr)
+    : mixer_(airframeOrDefault(config.airframe))
+    , airframeKnown_(Mixer::find(config.airframe) != nullptr)
+    , setpointSubscription_(topics::controlSetpoint)
     , armed_(false)
-    , emergencyMode_(false) {
-    pwm_ = std::make_unique<PWMController>();
+    , emergencyMode_(false)
+    , thrustCorrection_(0.0f)
+    , altitudeHold_(false)
+    , pidUpdates_(0)
+    , pidTotalNs_(0)
+    , pidMaxNs_(0) {
+    pwm_ = std::make_unique<PWMController>(config);
+
+    attitudePid_.configure(ROLL, makeGains(config.pid_roll_p, config.pid_roll_i, config.pid_roll_d,
+                                           ATTITUDE_DERIVATIVE_CUTOFF_HZ, SURFACE_SLEW_RATE));
+    attitudePid_.configure(PITCH, makeGains(config.pid_pitch_p, config.pid_pitch_i, config.pid_pitch_d,
+                                            ATTITUDE_DERIVATIVE_CUTOFF_HZ, SURFACE_SLEW_RATE));
+    PidBank::Gains yaw = makeGains(config.pid_yaw_p, config.pid_yaw_i, config.pid_yaw_d,
+                                   ATTITUDE_DERIVATIVE_CUTOFF_HZ, SURFACE_SLEW_RATE);
+    yaw.wrap = 360.0f;
+    attitudePid_.configure(YAW, yaw);
+    altitudePid_.configure(ALTITUDE, makeGains(config.pid_altitude_p, config.pid_altitude_i,
+                                               config.pid_altitude_d, ALTITUDE_DERIVATIVE_CUTOFF_HZ,
+                                               THRUST_SLEW_RATE));
 }
 
 FlightController::~FlightController() {
@@ -25,12 +72,32 @@ FlightController::~FlightController() {
 }
 
 bool FlightController::init() {
+    if (!airframeKnown_) {
+        std::cerr << "Unknown airframe, expected conventional, flying_wing or v_tail" << std::endl;
+        return false;
+    }
+    std::cout << "Airframe: " << mixer_.getName() << std::endl;
     return pwm_->init();
 }
 
 void FlightController::start() {
     std::lock_guard<std::mutex> lock(mutex_);
     if (!armed_ && !emergencyMode_) {
+        // Nothing carries over from a previous flight, and commands sent
+        // before arming are not acted on
+        attitudePid_.reset();
+        altitudePid_.reset();
+        thrustCorrection_ = 0.0f;
+        altitudeHold_ = false;
+        topics::ControlSetpoint stale;
+        setpointSubscription_.latest(stale);
+
+        // Minimum throttle arms the ESC and the surfaces center until the
+        // attitude loop takes over
+        std::array<uint16_t, Mixer::OUTPUTS> outputs;
+        mixer_.idle(outputs);
+        pwm_->setOutputs(outputs);
+        publishOutputs();
         armed_ = true;
     }
 }
@@ -41,147 +108,162 @@ void FlightController::stop() {
     emergencyStop();
 }
 
-void FlightController::update() {
+void FlightController::updateAttitude(const sensors::SensorSnapshot& snapshot, float dt) {
     std::lock_guard<std::mutex> lock(mutex_);
 
     if (!armed_ || emergencyMode_) {
         return;
     }
 
+    topics::ControlSetpoint setpoint;
+    if (setpointSubscription_.update(setpoint)) {
+        applyControlSetpoint(setpoint);
+    }
+
     // Perform safety checks
-    if (!performSafetyChecks()) {
+    if (!performSafetyChecks(snapshot)) {
         handleSafetyViolation();
         return;
     }
 
-    // Update control loops
-    updateAttitudeControl();
-    updateAltitudeControl();
+    updateAttitudeControl(snapshot, dt);
 }
 
-void FlightController::setControlInputs(const protocol::ControlData& control) {
+void FlightController::updateAltitude(const sensors::SensorSnapshot& snapshot, float dt) {
     std::lock_guard<std::mutex> lock(mutex_);
 
     if (!armed_ || emergencyMode_) {
         return;
     }
 
+    updateAltitudeControl(snapshot, dt);
+}
+
+void FlightController::applyControlSetpoint(const topics::ControlSetpoint& setpoint) {
     // Convert control inputs from raw values to physical units
-    target_.roll = (control.ailerons - 2048) * (MAX_SAFE_ANGLE / 2048.0f);
-    target_.pitch = (control.elevator - 2048) * (MAX_SAFE_ANGLE / 2048.0f);
-    target_.yaw = (control.rudder - 2048) * (180.0f / 2048.0f);
-    target_.thrust = control.thrust;
+    target_.roll = (setpoint.ailerons - 2048) * (MAX_SAFE_ANGLE / 2048.0f);
+    target_.pitch = (setpoint.elevator - 2048) * (MAX_SAFE_ANGLE / 2048.0f);
+    target_.yaw = (setpoint.rudder - 2048) * (180.0f / 2048.0f);
+    target_.thrust = setpoint.thrust;
+}
+
+void FlightController::commitOutputs() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pwm_->commit();
 }
 
 void FlightController::emergencyStop() {
     pwm_->emergencyStop();
     emergencyMode_ = true;
     armed_ = false;
+    publishOutputs();
 }
 
-protocol::TelemetryData FlightController::getTelemetryData() const {
-    if (sensorManager_) {
-        auto telemetry = sensorManager_->getTelemetryData();
-        
-        // Add control surface positions
-        telemetry.thrust_actual = pwm_->getOutput(PWMController::Channel::MOTOR);
-        telemetry.elevator_actual = pwm_->getOutput(PWMController::Channel::ELEVATOR);
-        telemetry.rudder_actual = pwm_->getOutput(PWMController::Channel::RUDDER);
-        telemetry.ailerons_actual = pwm_->getOutput(PWMController::Channel::AILERONS);
-        
-        return telemetry;
-    }
-    return protocol::TelemetryData{};
+void FlightController::publishOutputs() {
+    topics::ActuatorOutputs outputs;
+    outputs.timestampNs = runtime::monotonicNanoseconds();
+    outputs.motor = pwm_->getOutput(PWMController::Channel::MOTOR);
+    outputs.elevator = pwm_->getOutput(PWMController::Channel::ELEVATOR);
+    outputs.rudder = pwm_->getOutput(PWMController::Channel::RUDDER);
+    outputs.ailerons = pwm_->getOutput(PWMController::Channel::AILERONS);
+    topics::actuatorOutputs.publish(outputs);
 }
 
-void FlightController::updateAttitudeControl() {
-    auto telemetry = sensorManager_->getTelemetryData();
+void FlightController::updateAttitudeControl(const sensors::SensorSnapshot& snapshot, float dt) {
+    // All three axes in one pass
+    float setpoint[PidBank::LANES] = {target_.roll, target_.pitch, target_.yaw, 0.0f};
+    float measurement[PidBank::LANES] = {snapshot.roll, snapshot.pitch, snapshot.yaw, 0.0f};
+    float output[PidBank::LANES];
 
-    // Calculate errors
-    float rollError = target_.roll - telemetry.roll;
-    float pitchError = target_.pitch - telemetry.pitch;
-    float yawError = target_.yaw - telemetry.yaw;
-
-    // Update PID controllers
-    float rollOutput = updatePID(pidState_.roll, rollError, 
-                               pid_.rollKp, pid_.rollKi, pid_.rollKd, DT);
-    float pitchOutput = updatePID(pidState_.pitch, pitchError,
-                                pid_.pitchKp, pid_.pitchKi, pid_.pitchKd, DT);
-    float yawOutput = updatePID(pidState_.yaw, yawError,
-                              pid_.yawKp, pid_.yawKi, pid_.yawKd, DT);
+    int64_t start = runtime::monotonicNanoseconds();
+    attitudePid_.update(setpoint, measurement, dt, output);
+    recordPidTime(runtime::monotonicNanoseconds() - start);
 
     // Apply outputs
-    applyMotorOutputs(rollOutput, pitchOutput, yawOutput, target_.thrust);
+    applyMotorOutputs(output[ROLL], output[PITCH], output[YAW], target_.thrust + thrustCorrection_);
+    publishOutputs();
 }
 
-void FlightController::updateAltitudeControl() {
+void FlightController::updateAltitudeControl(const sensors::SensorSnapshot& snapshot, float dt) {
     if (target_.thrust < 100) {  // Below minimum throttle, disable altitude hold
+        thrustCorrection_ = 0.0f;
+        altitudeHold_ = false;
         return;
     }
 
-    float currentAlt = sensorManager_->getAltitude();
-    float altError = target_.altitude - currentAlt;
+    // Hold the height the aircraft is at when the throttle comes up; no
+    // correction until then
+    if (!altitudeHold_) {
+        target_.altitude = snapshot.height;
+        altitudePid_.reset();
+        altitudeHold_ = true;
+    }
+
+    // Fused height, fresh every IMU sample rather than stepping with GPS
+    float setpoint[PidBank::LANES] = {target_.altitude};
+    float measurement[PidBank::LANES] = {snapshot.height};
+    float output[PidBank::LANES];
 
-    float altitudeOutput = updatePID(pidState_.altitude, altError,
-                                   pid_.altitudeKp, pid_.altitudeKi, pid_.altitudeKd, DT);
+    int64_t start = runtime::monotonicNanoseconds();
+    altitudePid_.update(setpoint, measurement, dt, output);
+    recordPidTime(runtime::monotonicNanoseconds() - start);
 
-    // Adjust thrust based on altitude control
-    uint16_t adjustedThrust = static_cast<uint16_t>(target_.thrust + altitudeOutput);
-    adjustedThrust = std::min<uint16_t>(adjustedThrust, 4095);
-    pwm_->setOutput(PWMController::Channel::MOTOR, adjustedThrust);
+    // Applied by the attitude loop, which owns the outputs; writing the
+    // motor here would be overwritten on its next tick
+    thrustCorrection_ = output[ALTITUDE];
 }
 
-float FlightController::updatePID(PIDState& state, float error, 
-                                float kp, float ki, float kd, float dt) {
-    // Proportional term
-    float p = kp * error;
+void FlightController::recordPidTime(int64_t elapsedNs) {
+    pidUpdates_++;
+    pidTotalNs_ += elapsedNs;
+    pidMaxNs_ = std::max(pidMaxNs_, elapsedNs);
+}
 
-    // Integral term with anti-windup
-    state.integral += error * dt;
-    state.integral = std::max(-MAX_INTEGRAL, std::min(MAX_INTEGRAL, state.integral));
-    float i = ki * state.integral;
+FlightController::PidStatistics FlightController::getPidStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PidStatistics stats;
+    stats.updates = pidUpdates_;
+    stats.maxNs = pidMaxNs_;
+    if (pidUpdates_ > 0) {
+        stats.meanNs = pidTotalNs_ / static_cast<int64_t>(pidUpdates_);
+    }
+    return stats;
+}
 
-    // Derivative term
-    float d = kd * (error - state.lastError) / dt;
-    state.lastError = error;
+void FlightController::report(std::ostream& out) const {
+    auto pid = getPidStatistics();
+    out << "PID banks: " << pid.updates << " updates, mean/max "
+        << pid.meanNs << "/" << pid.maxNs << " ns" << std::endl;
 
-    return p + i + d;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto pwm = pwm_->getStatistics();
+    out << "PWM: " << pwm.frames << " frames written, " << pwm.unchanged << " unchanged, "
+        << pwm.errors << " failed of " << pwm.commits << " commits" << std::endl;
 }
 
 void FlightController::applyMotorOutputs(float rollOutput, float pitchOutput,
                                        float yawOutput, float thrust) {
-    // Convert control outputs to servo positions (centered at 2048)
-    uint16_t ailerons = static_cast<uint16_t>(2048 + rollOutput);
-    uint16_t elevator = static_cast<uint16_t>(2048 + pitchOutput);
-    uint16_t rudder = static_cast<uint16_t>(2048 + yawOutput);
-
-    // Clamp values to valid range
-    ailerons = std::min<uint16_t>(std::max<uint16_t>(ailerons, 0), 4095);
-    elevator = std::min<uint16_t>(std::max<uint16_t>(elevator, 0), 4095);
-    rudder = std::min<uint16_t>(std::max<uint16_t>(rudder, 0), 4095);
-
-    // Apply outputs
-    pwm_->setOutput(PWMController::Channel::AILERONS, ailerons);
-    pwm_->setOutput(PWMController::Channel::ELEVATOR, elevator);
-    pwm_->setOutput(PWMController::Channel::RUDDER, rudder);
-    pwm_->setOutput(PWMController::Channel::MOTOR, static_cast<uint16_t>(thrust));
+    // PID outputs are counts from center; the mixer works in unit demands
+    Mixer::Demand demand;
+    demand.axes[Mixer::ROLL] = rollOutput / OUTPUT_LIMIT;
+    demand.axes[Mixer::PITCH] = pitchOutput / OUTPUT_LIMIT;
+    demand.axes[Mixer::YAW] = yawOutput / OUTPUT_LIMIT;
+    demand.axes[Mixer::THRUST] = thrust / 4095.0f;
+
+    std::array<uint16_t, Mixer::OUTPUTS> outputs;
+    mixer_.mix(demand, outputs);
+    pwm_->setOutputs(outputs);
 }
 
-bool FlightController::performSafetyChecks() const {
-    if (!sensorManager_) {
-        return false;
-    }
-
-    auto telemetry = sensorManager_->getTelemetryData();
-
+bool FlightController::performSafetyChecks(const sensors::SensorSnapshot& snapshot) const {
     // Check battery voltage
-    if (telemetry.battery_voltage < MIN_SAFE_VOLTAGE) {
+    if (snapshot.batteryVoltage < MIN_SAFE_VOLTAGE) {
         return false;
     }
 
     // Check attitude limits
-    if (std::abs(telemetry.roll) > MAX_SAFE_ANGLE ||
-        std::abs(telemetry.pitch) > MAX_SAFE_ANGLE) {
+    if (std::abs(snapshot.roll) > MAX_SAFE_ANGLE ||
+        std::abs(snapshot.pitch) > MAX_SAFE_ANGLE) {
         return false;
     }
 
@@ -0,0 +1,65 @@
+#include "control/Mixer.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace drone {
+namespace control {
+
+Mixer::Mixer(const Airframe& airframe) : name_(airframe.name) {
+    std::copy(airframe.outputs, airframe.outputs + OUTPUTS, outputs_);
+}
+
+const Mixer::Airframe* Mixer::find(const std::string& name) {
+    for (const Airframe* airframe : airframes::ALL) {
+        if (name == airframe->name) {
+            return airframe;
+        }
+    }
+    return nullptr;
+}
+
+void Mixer::mix(const Demand& demand, std::array<uint16_t, OUTPUTS>& outputs) const {
+    float axes[AXES];
+    for (size_t axis = 0; axis < THRUST; ++axis) {
+        axes[axis] = std::max(-1.0f, std::min(1.0f, demand.axes[axis]));
+    }
+    axes[THRUST] = std::max(0.0f, std::min(1.0f, demand.axes[THRUST]));
+
+    // Thrust and attitude parts of each output, kept apart so only the
+    // attitude part is scaled
+    float thrust[OUTPUTS];
+    float attitude[OUTPUTS];
+    for (size_t i = 0; i < OUTPUTS; ++i) {
+        const Output& output = outputs_[i];
+        thrust[i] = output.weights[THRUST] * axes[THRUST];
+        attitude[i] = output.weights[ROLL] * axes[ROLL] + output.weights[PITCH] * axes[PITCH] +
+                      output.weights[YAW] * axes[YAW];
+    }
+
+    // Largest common attitude scale, up to 1, that keeps every output in
+    // range on top of its thrust
+    float scale = 1.0f;
+    for (size_t i = 0; i < OUTPUTS; ++i) {
+        const Output& output = outputs_[i];
+        if (attitude[i] > 0.0f) {
+            scale = std::min(scale, (output.maximum - thrust[i]) / attitude[i]);
+        } else if (attitude[i] < 0.0f) {
+            scale = std::min(scale, (output.minimum - thrust[i]) / attitude[i]);
+        }
+    }
+    scale = std::max(0.0f, scale);
+
+    for (size_t i = 0; i < OUTPUTS; ++i) {
+        const Output& output = outputs_[i];
+        float value = std::max(output.minimum, std::min(output.maximum, thrust[i] + scale * attitude[i]));
+        float counts = std::round(output.center + output.scale * value);
+        outputs[i] = static_cast<uint16_t>(std::max(0.0f, std::min(4095.0f, counts)));
+    }
+}
+
+void Mixer::idle(std::array<uint16_t, OUTPUTS>& outputs) const {
+    mix(Demand{}, outputs);
+}
+
+} // namespace control
+} // namespace drone
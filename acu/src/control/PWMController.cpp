@@ -1,74 +1,128 @@
 #include "control/PWMController.hpp"
-#include <wiringPi.h>
+#include "hal/LinuxI2CDevice.hpp"
+#include "hal/MockPwm.hpp"
+#include "hal/Pca9685.hpp"
+#include "hal/SysfsPwm.hpp"
 #include <algorithm>
+#include <iostream>
 
 namespace drone {
 namespace control {
 
-PWMController::PWMController() {
+PWMController::PWMController(const Config& config)
+    : PWMController(createOutput(config)) {
+}
+
+PWMController::PWMController(std::unique_ptr<hal::PwmOutput> output)
+    : output_(std::move(output))
+    , open_(false)
+    , frameWritten_(false) {
     currentValues_.fill(0);
+    pulses_.fill(0);
+    written_.fill(0);
 }
 
 PWMController::~PWMController() {
     emergencyStop();
+    if (open_) {
+        output_->close();
+    }
+}
+
+std::unique_ptr<hal::PwmOutput> PWMController::createOutput(const Config& config) {
+    if (config.pwm_backend == "pca9685") {
+        return std::make_unique<hal::Pca9685>(
+            std::make_unique<hal::LinuxI2CDevice>(config.pwm_i2c_bus, config.pwm_i2c_address));
+    }
+    if (config.pwm_backend == "sysfs") {
+        return std::make_unique<hal::SysfsPwm>(config.pwm_chip, CHANNELS);
+    }
+    if (config.pwm_backend == "mock") {
+        return std::make_unique<hal::MockPwm>(CHANNELS);
+    }
+    return nullptr;
 }
 
 bool PWMController::init() {
-    // Setup all PWM pins
-    for (int pin : PWM_PINS) {
-        setupPWMPin(pin);
+    // The state machine initializes the flight controller again on entering
+    // INITIALIZING; reopening would restart the chip and leak descriptors
+    if (open_) {
+        return true;
+    }
+    if (!output_) {
+        std::cerr << "Unknown PWM backend, expected pca9685, sysfs or mock" << std::endl;
+        return false;
+    }
+    if (output_->channels() < CHANNELS) {
+        std::cerr << "PWM backend has " << output_->channels() << " channels, "
+                  << CHANNELS << " needed" << std::endl;
+        return false;
+    }
+    if (!output_->open(FRAME_RATE_HZ)) {
+        std::cerr << "Failed to open PWM backend" << std::endl;
+        return false;
     }
-    
+    open_ = true;
+
     // Initialize all outputs to zero
     emergencyStop();
-    
-    return true;
-}
 
-void PWMController::setupPWMPin(int pin) {
-    pinMode(pin, PWM_OUTPUT);
-    pwmSetMode(PWM_MODE_MS);  // Mark-Space mode
-    pwmSetRange(PWM_RANGE);
-    pwmSetClock(19200000 / (PWM_RANGE * PWM_FREQUENCY));  // 19.2MHz clock
+    return true;
 }
 
 void PWMController::setOutput(Channel channel, uint16_t value) {
     // Clamp input value
     value = std::min<uint16_t>(value, 4095);
-    
+
     // Store current value
     int channelIdx = static_cast<int>(channel);
     currentValues_[channelIdx] = value;
-    
-    // Convert to PWM value and write
-    uint16_t pwmValue = scaleToPWM(value);
-    writePWM(PWM_PINS[channelIdx], pwmValue);
+    pulses_[channelIdx] = scaleToPulse(value);
+}
+
+void PWMController::setOutputs(const std::array<uint16_t, CHANNELS>& values) {
+    for (size_t i = 0; i < CHANNELS; ++i) {
+        currentValues_[i] = std::min<uint16_t>(values[i], 4095);
+        pulses_[i] = scaleToPulse(currentValues_[i]);
+    }
 }
 
 uint16_t PWMController::getOutput(Channel channel) const {
     return currentValues_[static_cast<int>(channel)];
 }
 
-void PWMController::emergencyStop() {
-    // Set all outputs to zero
-    for (size_t i = 0; i < PWM_PINS.size(); ++i) {
-        currentValues_[i] = 0;
-        writePWM(PWM_PINS[i], 0);
+bool PWMController::commit() {
+    if (!open_) return false;
+
+    stats_.commits++;
+    if (frameWritten_ && pulses_ == written_) {
+        stats_.unchanged++;
+        return true;
     }
+
+    // A failed frame is sent again on the next commit
+    if (!output_->write(pulses_.data(), CHANNELS)) {
+        stats_.errors++;
+        frameWritten_ = false;
+        return false;
+    }
+    written_ = pulses_;
+    frameWritten_ = true;
+    stats_.frames++;
+    return true;
 }
 
-uint16_t PWMController::scaleToPWM(uint16_t value) const {
-    // Scale from 0-4095 to SERVO_MIN_US-SERVO_MAX_US
-    float scaled = SERVO_MIN_US + (value / 4095.0f) * (SERVO_MAX_US - SERVO_MIN_US);
-    
-    // Convert microseconds to PWM value
-    // PWM period is 20ms (50Hz), so scale accordingly
-    return static_cast<uint16_t>((scaled / 20000.0f) * PWM_RANGE);
+void PWMController::emergencyStop() {
+    // No pulse at all on any output, rather than the minimum pulse
+    currentValues_.fill(0);
+    pulses_.fill(0);
+    commit();
 }
 
-void PWMController::writePWM(int pin, uint16_t value) {
-    pwmWrite(pin, value);
+uint16_t PWMController::scaleToPulse(uint16_t value) const {
+    // Scale from 0-4095 to SERVO_MIN_US-SERVO_MAX_US
+    return static_cast<uint16_t>(SERVO_MIN_US + (value * (SERVO_MAX_US - SERVO_MIN_US) + 2047) / 4095);
 }
 
 } // namespace control
-} // namespace drone 
\ No newline at end of file
+} // namespace drone
@@ -0,0 +1,115 @@
+#include "control/PidBank.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace drone {
+namespace control {
+
+PidBank::PidBank() {
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        configure(lane, Gains{});
+    }
+    reset();
+}
+
+void PidBank::configure(size_t lane, const Gains& gains) {
+    if (lane >= LANES) {
+        return;
+    }
+    kp_[lane] = gains.kp;
+    ki_[lane] = gains.ki;
+    kd_[lane] = gains.kd;
+    tau_[lane] = gains.derivativeCutoffHz > 0.0f ? 1.0f / (2.0f * 3.14159265f * gains.derivativeCutoffHz) : 0.0f;
+    integralLimit_[lane] = gains.integralLimit;
+    outputLimit_[lane] = gains.outputLimit;
+    slewRate_[lane] = gains.slewRate > 0.0f ? gains.slewRate : INFINITY;
+    wrap_[lane] = gains.wrap;
+    halfWrap_[lane] = 0.5f * gains.wrap;
+}
+
+void PidBank::reset() {
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        integral_[lane] = 0.0f;
+        derivative_[lane] = 0.0f;
+        lastMeasurement_[lane] = 0.0f;
+        lastOutput_[lane] = 0.0f;
+    }
+    primed_ = false;
+}
+
+void PidBank::update(const float* setpoint, const float* measurement, float dt, float* output) {
+    if (!(dt > 0.0f)) {
+        std::copy(lastOutput_, lastOutput_ + LANES, output);
+        return;
+    }
+    dt = std::min(dt, MAX_DT);
+
+    // The first update has no previous measurement or output to difference
+    // against; scalars here keep the lane loop free of branches
+    const float history = primed_ ? 1.0f : 0.0f;
+    const float slewScale = primed_ ? 1.0f : INFINITY;
+    const float inverseDt = 1.0f / dt;
+    primed_ = true;
+
+    // Local copies tell the compiler the caller's arrays cannot alias the
+    // bank's own, which it needs to vectorize the loop
+    alignas(16) float target[LANES];
+    alignas(16) float current[LANES];
+    alignas(16) float result[LANES];
+    std::copy(setpoint, setpoint + LANES, target);
+    std::copy(measurement, measurement + LANES, current);
+
+    for (size_t i = 0; i < LANES; ++i) {
+        // Angular lanes take the short way round. Differences of in-range
+        // angles are within one period of zero, so one step is enough.
+        // Conditions enter as 0/1 multipliers: GCC will not turn float
+        // selects into vector blends under the default -ftrapping-math.
+        const float wrap = wrap_[i];
+        const float halfWrap = halfWrap_[i];
+        float error = target[i] - current[i];
+        error -= wrap * (static_cast<float>(error > halfWrap) - static_cast<float>(error < -halfWrap));
+        float change = current[i] - lastMeasurement_[i];
+        change -= wrap * (static_cast<float>(change > halfWrap) - static_cast<float>(change < -halfWrap));
+        lastMeasurement_[i] = current[i];
+
+        // Derivative of the measurement, not the error, so setpoint steps
+        // do not kick the output; low-passed against sensor noise. A steady
+        // measurement decays the filter toward subnormals, which are many
+        // times slower to compute with; adding and removing a small offset
+        // rounds them to zero without a compare.
+        const float alpha = dt / (dt + tau_[i]);
+        float derivative = derivative_[i] + alpha * (-change * history * inverseDt - derivative_[i]);
+        derivative += SUBNORMAL_GUARD;
+        derivative -= SUBNORMAL_GUARD;
+        derivative_[i] = derivative;
+
+        const float p = kp_[i] * error;
+        const float d = kd_[i] * derivative;
+        const float limit = outputLimit_[i];
+
+        // Integrate unless saturated with the error pushing further out.
+        // Clamps work on local copies: std::min/max of two members returns
+        // a reference to one of them, which defeats the vectorizer.
+        const float integralLimit = integralLimit_[i];
+        float integral = integral_[i];
+        const float unsaturated = p + ki_[i] * integral + d;
+        const float hold = static_cast<float>(((unsaturated >= limit) & (error > 0.0f)) |
+                                              ((unsaturated <= -limit) & (error < 0.0f)));
+        integral += (1.0f - hold) * error * dt;
+        integral = std::max(-integralLimit, std::min(integralLimit, integral));
+        integral_[i] = integral;
+
+        float out = p + ki_[i] * integral + d;
+        out = std::max(-limit, std::min(limit, out));
+
+        const float lastOutput = lastOutput_[i];
+        const float step = slewRate_[i] * dt * slewScale;
+        out = std::max(lastOutput - step, std::min(lastOutput + step, out));
+        lastOutput_[i] = out;
+        result[i] = out;
+    }
+    std::copy(result, result + LANES, output);
+}
+
+} // namespace control
+} // namespace drone
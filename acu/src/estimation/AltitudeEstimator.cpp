@@ -0,0 +1,189 @@
+#include "estimation/AltitudeEstimator.hpp"
+
+namespace drone {
+namespace estimation {
+
+AltitudeEstimator::AltitudeEstimator()
+    : AltitudeEstimator(Noise{}) {
+}
+
+AltitudeEstimator::AltitudeEstimator(const Noise& noise)
+    : noise_(noise) {
+    reset();
+}
+
+void AltitudeEstimator::reset() {
+    state_ = Vector4::zeros();
+    covariance_ = Matrix4::zeros();
+    covariance_(HEIGHT, HEIGHT) = noise_.range * noise_.range;
+    covariance_(VELOCITY, VELOCITY) = INITIAL_VELOCITY_SIGMA * INITIAL_VELOCITY_SIGMA;
+    covariance_(BIAS, BIAS) = INITIAL_BIAS_SIGMA * INITIAL_BIAS_SIGMA;
+    covariance_(GPS_OFFSET, GPS_OFFSET) = INITIAL_OFFSET_SIGMA * INITIAL_OFFSET_SIGMA;
+
+    lastPredictNs_ = 0;
+    initialized_ = false;
+    absolute_ = false;
+    gpsRejections_ = 0;
+    historyCount_ = 0;
+    historyNext_ = 0;
+    stats_ = Statistics{};
+}
+
+void AltitudeEstimator::predict(float verticalAccel, int64_t timestampNs) {
+    if (!initialized_) {
+        initialized_ = true;
+        lastPredictNs_ = timestampNs;
+        return;
+    }
+
+    float dt = (timestampNs - lastPredictNs_) * 1e-9f;
+    lastPredictNs_ = timestampNs;
+    if (dt <= 0.0f || dt > MAX_PREDICT_DT) {
+        return;
+    }
+
+    // Constant acceleration over the sample, bias-corrected
+    const float accel = verticalAccel - state_[BIAS];
+    state_[HEIGHT] += state_[VELOCITY] * dt + 0.5f * accel * dt * dt;
+    state_[VELOCITY] += accel * dt;
+
+    Matrix4 transition = Matrix4::identity();
+    transition(HEIGHT, VELOCITY) = dt;
+    transition(HEIGHT, BIAS) = -0.5f * dt * dt;
+    transition(VELOCITY, BIAS) = -dt;
+
+    // White acceleration noise integrated into height and velocity, random
+    // walks on the bias and the GPS offset
+    const float qa = noise_.accel * noise_.accel;
+    Matrix4 process = Matrix4::zeros();
+    process(HEIGHT, HEIGHT) = qa * dt * dt * dt / 3.0f;
+    process(HEIGHT, VELOCITY) = process(VELOCITY, HEIGHT) = qa * dt * dt / 2.0f;
+    process(VELOCITY, VELOCITY) = qa * dt;
+    process(BIAS, BIAS) = noise_.accelBiasWalk * noise_.accelBiasWalk * dt;
+    process(GPS_OFFSET, GPS_OFFSET) = noise_.gpsOffsetWalk * noise_.gpsOffsetWalk * dt;
+
+    covariance_ = transition * covariance_ * transition.transposed() + process;
+
+    history_[historyNext_] = {timestampNs, state_[HEIGHT]};
+    historyNext_ = (historyNext_ + 1) % HISTORY_SIZE;
+    if (historyCount_ < HISTORY_SIZE) {
+        historyCount_++;
+    }
+}
+
+bool AltitudeEstimator::fuseGps(float altitude, float accuracy, int64_t measuredNs) {
+    float height;
+    if (!heightAt(measuredNs, height)) {
+        stats_.stale++;
+        return false;
+    }
+
+    const float sigma = accuracy > 0.0f ? accuracy : noise_.gps;
+
+    // The first fix sets the offset outright: the site's elevation is
+    // unknown, so there is nothing to gate it against
+    if (!absolute_) {
+        anchorGpsOffset(altitude, height, sigma);
+        absolute_ = true;
+        stats_.gpsFused++;
+        return true;
+    }
+
+    const float innovation = altitude - (height + state_[GPS_OFFSET]);
+
+    Vector4 observation;
+    observation[HEIGHT] = 1.0f;
+    observation[GPS_OFFSET] = 1.0f;
+
+    if (fuse(observation, innovation, sigma * sigma)) {
+        absolute_ = true;
+        gpsRejections_ = 0;
+        stats_.gpsFused++;
+        return true;
+    }
+
+    // A persistent disagreement is a GPS altitude jump (new constellation,
+    // receiver restart); take the new level rather than ignoring GPS forever
+    stats_.gpsRejected++;
+    if (++gpsRejections_ >= GPS_RESET_REJECTIONS) {
+        anchorGpsOffset(altitude, height, sigma);
+    }
+    return false;
+}
+
+void AltitudeEstimator::anchorGpsOffset(float altitude, float height, float sigma) {
+    state_[GPS_OFFSET] = altitude - height;
+    for (size_t i = 0; i < 4; ++i) {
+        covariance_(GPS_OFFSET, i) = covariance_(i, GPS_OFFSET) = 0.0f;
+    }
+    covariance_(GPS_OFFSET, GPS_OFFSET) = sigma * sigma;
+    gpsRejections_ = 0;
+}
+
+bool AltitudeEstimator::fuseRange(float height, int64_t measuredNs) {
+    float predicted;
+    if (!heightAt(measuredNs, predicted)) {
+        stats_.stale++;
+        return false;
+    }
+
+    Vector4 observation;
+    observation[HEIGHT] = 1.0f;
+
+    if (fuse(observation, height - predicted, noise_.range * noise_.range)) {
+        stats_.rangeFused++;
+        return true;
+    }
+    stats_.rangeRejected++;
+    return false;
+}
+
+AltitudeEstimator::Estimate AltitudeEstimator::getEstimate() const {
+    Estimate estimate;
+    estimate.height = state_[HEIGHT];
+    estimate.climbRate = state_[VELOCITY];
+    estimate.altitude = absolute_ ? state_[HEIGHT] + state_[GPS_OFFSET] : state_[HEIGHT];
+    estimate.accelBias = state_[BIAS];
+    estimate.timestampNs = lastPredictNs_;
+    estimate.absolute = absolute_;
+    return estimate;
+}
+
+bool AltitudeEstimator::heightAt(int64_t timestampNs, float& height) const {
+    // Measurements from the future (clock jitter) are taken as current
+    if (historyCount_ == 0 || timestampNs >= lastPredictNs_) {
+        height = state_[HEIGHT];
+        return true;
+    }
+
+    // Newest entry at or before the measurement, searching backwards
+    for (size_t i = 1; i <= historyCount_; ++i) {
+        const HistoryEntry& entry = history_[(historyNext_ + HISTORY_SIZE - i) % HISTORY_SIZE];
+        if (entry.timestampNs <= timestampNs) {
+            height = entry.height;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AltitudeEstimator::fuse(const Vector4& observation, float innovation, float variance) {
+    // Scalar update: S = H P H' + R, K = P H' / S
+    const Vector4 ph = covariance_ * observation;
+    const float s = (observation.transposed() * ph)[0] + variance;
+    if (s <= 0.0f || innovation * innovation > GATE_SIGMA * GATE_SIGMA * s) {
+        return false;
+    }
+
+    const Vector4 gain = ph * (1.0f / s);
+    state_ += gain * innovation;
+
+    // Joseph form keeps the covariance symmetric and positive
+    Matrix4 correction = Matrix4::identity() - gain * observation.transposed();
+    covariance_ = correction * covariance_ * correction.transposed() +
+                  (gain * gain.transposed()) * variance;
+    return true;
+}
+
+} // namespace estimation
+} // namespace drone
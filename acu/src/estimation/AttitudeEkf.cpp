@@ -0,0 +1,89 @@
+#include "estimation/AttitudeEkf.hpp"
+
+namespace drone {
+namespace estimation {
+
+AttitudeEkf::AttitudeEkf()
+    : AttitudeEkf(Noise()) {
+}
+
+AttitudeEkf::AttitudeEkf(const Noise& noise)
+    : noise_(noise) {
+    initialize(math::makeVector3(0.0f, 0.0f, 1.0f));
+}
+
+void AttitudeEkf::initialize(const math::Vector3& accel) {
+    attitude_ = levelFromAccel(accel);
+    bias_ = math::Vector3::zeros();
+
+    covariance_ = Matrix6::zeros();
+    for (size_t i = 0; i < 3; ++i) {
+        covariance_(i, i) = INITIAL_ANGLE_SIGMA * INITIAL_ANGLE_SIGMA;
+        covariance_(i + 3, i + 3) = INITIAL_BIAS_SIGMA * INITIAL_BIAS_SIGMA;
+    }
+}
+
+void AttitudeEkf::update(const math::Vector3& gyro, const math::Vector3& accel, float dt) {
+    predict(gyro, dt);
+    if (isNearOneG(accel, ACCEL_TOLERANCE)) {
+        correct(accel);
+    }
+}
+
+void AttitudeEkf::predict(const math::Vector3& gyro, float dt) {
+    math::Vector3 rate = gyro - bias_;
+    attitude_.rotateBy(rate * dt);
+
+    // Error dynamics: d(dtheta) = -[w]x dtheta - dbias, d(dbias) = 0
+    Matrix6 transition = Matrix6::identity();
+    transition.setBlock<0, 0>(math::Matrix3::identity() - math::skew(rate) * dt);
+    transition.setBlock<0, 3>(math::Matrix3::identity() * -dt);
+
+    covariance_ = transition * covariance_ * transition.transposed();
+
+    float angleNoise = noise_.gyro * noise_.gyro * dt;
+    float biasNoise = noise_.gyroBiasWalk * noise_.gyroBiasWalk * dt;
+    for (size_t i = 0; i < 3; ++i) {
+        covariance_(i, i) += angleNoise;
+        covariance_(i + 3, i + 3) += biasNoise;
+    }
+}
+
+void AttitudeEkf::correct(const math::Vector3& accel) {
+    // The accelerometer sees world-up in the body frame. For a body-frame
+    // error rotation dtheta, h(dtheta) ~ h + [h]x dtheta.
+    math::Vector3 predicted = attitude_.worldUpInBody();
+    math::Vector3 innovation = accel - predicted;
+
+    Matrix36 jacobian;
+    jacobian.setBlock<0, 0>(math::skew(predicted));
+
+    Matrix63 pht = covariance_ * jacobian.transposed();
+    math::Matrix3 innovationCovariance = jacobian * pht;
+    float accelVariance = noise_.accel * noise_.accel;
+    for (size_t i = 0; i < 3; ++i) {
+        innovationCovariance(i, i) += accelVariance;
+    }
+
+    math::Matrix3 inverse;
+    if (!math::inverse(innovationCovariance, inverse)) {
+        return;
+    }
+
+    Matrix63 gain = pht * inverse;
+    math::Vector<6> error = gain * innovation;
+
+    // Fold the error state into the nominal state; it is zero again after
+    attitude_.rotateBy(error.block<3, 1, 0, 0>());
+    bias_ += error.block<3, 1, 3, 0>();
+
+    covariance_ -= gain * (jacobian * covariance_);
+
+    // Keep the covariance symmetric against rounding drift
+    Matrix6 transposed = covariance_.transposed();
+    covariance_ += transposed;
+    covariance_ *= 0.5f;
+}
+
+} // namespace estimation
+} // namespace drone
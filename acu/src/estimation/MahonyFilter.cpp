@@ -0,0 +1,31 @@
+#include "estimation/MahonyFilter.hpp"
+
+namespace drone {
+namespace estimation {
+
+MahonyFilter::MahonyFilter(float kp, float ki)
+    : kp_(kp)
+    , ki_(ki) {
+}
+
+void MahonyFilter::initialize(const math::Vector3& accel) {
+    attitude_ = levelFromAccel(accel);
+    integral_ = math::Vector3::zeros();
+}
+
+void MahonyFilter::update(const math::Vector3& gyro, const math::Vector3& accel, float dt) {
+    math::Vector3 rate = gyro;
+
+    if (isNearOneG(accel, ACCEL_TOLERANCE)) {
+        math::Vector3 measured = accel * math::fastInvSqrt(math::dot(accel, accel));
+        math::Vector3 error = math::cross(measured, attitude_.worldUpInBody());
+
+        integral_ += error * (ki_ * dt);
+        rate += error * kp_ + integral_;
+    }
+
+    attitude_.rotateBy(rate * dt);
+}
+
+} // namespace estimation
+} // namespace drone
@@ -0,0 +1,240 @@
+#include "estimation/PositionEstimator.hpp"
+#include <cmath>
+
+namespace drone {
+namespace estimation {
+
+PositionEstimator::PositionEstimator()
+    : PositionEstimator(Noise{}) {
+}
+
+PositionEstimator::PositionEstimator(const Noise& noise)
+    : noise_(noise) {
+    reset();
+}
+
+void PositionEstimator::reset() {
+    for (Axis& axis : axes_) {
+        axis.state = Vector3::zeros();
+        axis.covariance = Matrix3::zeros();
+    }
+
+    lastPredictNs_ = 0;
+    valid_ = false;
+    gpsRejections_ = 0;
+    aligned_ = false;
+    headingCos_ = 1.0f;
+    headingSin_ = 0.0f;
+    historyCount_ = 0;
+    historyNext_ = 0;
+    stats_ = Statistics{};
+}
+
+void PositionEstimator::initialize(float north, float east, float velocityNorth,
+                                   float velocityEast, float sigma) {
+    const float position[AXES] = {north, east};
+    const float velocity[AXES] = {velocityNorth, velocityEast};
+    for (size_t i = 0; i < AXES; ++i) {
+        Axis& axis = axes_[i];
+        axis.state[POSITION] = position[i];
+        axis.state[VELOCITY] = velocity[i];
+        axis.state[BIAS] = 0.0f;
+        axis.covariance = Matrix3::zeros();
+        axis.covariance(POSITION, POSITION) = sigma * sigma;
+        axis.covariance(VELOCITY, VELOCITY) = noise_.gpsVelocity * noise_.gpsVelocity;
+        axis.covariance(BIAS, BIAS) = INITIAL_BIAS_SIGMA * INITIAL_BIAS_SIGMA;
+    }
+
+    // Older states describe a trajectory that no longer applies
+    historyCount_ = 0;
+    historyNext_ = 0;
+    gpsRejections_ = 0;
+    valid_ = true;
+}
+
+void PositionEstimator::predict(float accelX, float accelY, int64_t timestampNs) {
+    if (lastPredictNs_ == 0) {
+        lastPredictNs_ = timestampNs;
+        return;
+    }
+
+    float dt = (timestampNs - lastPredictNs_) * 1e-9f;
+    lastPredictNs_ = timestampNs;
+    if (!valid_ || dt <= 0.0f || dt > MAX_PREDICT_DT) {
+        return;
+    }
+
+    // Level frame to north/east. Unaligned, the filter coasts on velocity
+    // and the bias is left alone since nothing makes it observable.
+    float accel[AXES] = {0.0f, 0.0f};
+    if (aligned_) {
+        accel[NORTH] = accelX * headingCos_ + accelY * headingSin_;
+        accel[EAST] = accelX * headingSin_ - accelY * headingCos_;
+    }
+    const float sigma = aligned_ ? noise_.accel : noise_.unalignedAccel;
+    const float qa = sigma * sigma;
+    const float biasCoupling = aligned_ ? 1.0f : 0.0f;
+
+    Matrix3 transition = Matrix3::identity();
+    transition(POSITION, VELOCITY) = dt;
+    transition(POSITION, BIAS) = -0.5f * dt * dt * biasCoupling;
+    transition(VELOCITY, BIAS) = -dt * biasCoupling;
+
+    Matrix3 process = Matrix3::zeros();
+    process(POSITION, POSITION) = qa * dt * dt * dt / 3.0f;
+    process(POSITION, VELOCITY) = process(VELOCITY, POSITION) = qa * dt * dt / 2.0f;
+    process(VELOCITY, VELOCITY) = qa * dt;
+    process(BIAS, BIAS) = noise_.accelBiasWalk * noise_.accelBiasWalk * dt * biasCoupling;
+
+    HistoryEntry& entry = history_[historyNext_];
+    entry.timestampNs = timestampNs;
+    for (size_t i = 0; i < AXES; ++i) {
+        Axis& axis = axes_[i];
+        const float a = aligned_ ? accel[i] - axis.state[BIAS] : 0.0f;
+        axis.state[POSITION] += axis.state[VELOCITY] * dt + 0.5f * a * dt * dt;
+        axis.state[VELOCITY] += a * dt;
+        axis.covariance = transition * axis.covariance * transition.transposed() + process;
+
+        entry.position[i] = axis.state[POSITION];
+        entry.velocity[i] = axis.state[VELOCITY];
+    }
+
+    historyNext_ = (historyNext_ + 1) % HISTORY_SIZE;
+    if (historyCount_ < HISTORY_SIZE) {
+        historyCount_++;
+    }
+}
+
+bool PositionEstimator::fuseGps(float north, float east, float velocityNorth,
+                                float velocityEast, float accuracy, int64_t measuredNs) {
+    const float sigma = accuracy > 0.0f ? accuracy : noise_.gpsPosition;
+    if (!valid_) {
+        initialize(north, east, velocityNorth, velocityEast, sigma);
+        stats_.positionFused++;
+        return true;
+    }
+
+    HistoryEntry past;
+    if (!stateAt(measuredNs, past)) {
+        stats_.stale++;
+        return false;
+    }
+
+    const float position[AXES] = {north, east};
+    const float velocity[AXES] = {velocityNorth, velocityEast};
+    bool positionFused = true;
+    for (size_t i = 0; i < AXES; ++i) {
+        Axis& axis = axes_[i];
+
+        // The position correction also moves the velocity; the velocity
+        // innovation must see that or it corrects the same error twice
+        const float velocityBefore = axis.state[VELOCITY];
+        if (fuse(axis, POSITION, position[i] - past.position[i], sigma * sigma)) {
+            stats_.positionFused++;
+        } else {
+            stats_.positionRejected++;
+            positionFused = false;
+        }
+
+        const float innovation = velocity[i] - past.velocity[i] -
+                                 (axis.state[VELOCITY] - velocityBefore);
+        if (fuse(axis, VELOCITY, innovation, noise_.gpsVelocity * noise_.gpsVelocity)) {
+            stats_.velocityFused++;
+        } else {
+            stats_.velocityRejected++;
+        }
+    }
+
+    if (positionFused) {
+        gpsRejections_ = 0;
+        return true;
+    }
+
+    // Persistent disagreement means the dead reckoning has run away (long
+    // outage, bad alignment); restart from the receiver
+    if (++gpsRejections_ >= GPS_RESET_REJECTIONS) {
+        initialize(north, east, velocityNorth, velocityEast, sigma);
+        stats_.resets++;
+    }
+    return false;
+}
+
+void PositionEstimator::alignHeading(float yaw, float course) {
+    // Level-frame x axis heading: the airframe points along its course
+    const float angle = course + yaw;
+    if (!aligned_) {
+        headingCos_ = std::cos(angle);
+        headingSin_ = std::sin(angle);
+        aligned_ = true;
+        return;
+    }
+
+    // Average as a unit vector so the angle wraps cleanly
+    float c = headingCos_ + HEADING_ALIGN_GAIN * (std::cos(angle) - headingCos_);
+    float s = headingSin_ + HEADING_ALIGN_GAIN * (std::sin(angle) - headingSin_);
+    float norm = std::sqrt(c * c + s * s);
+    if (norm > 1e-3f) {
+        headingCos_ = c / norm;
+        headingSin_ = s / norm;
+    }
+}
+
+PositionEstimator::Estimate PositionEstimator::getEstimate() const {
+    Estimate estimate;
+    estimate.north = axes_[NORTH].state[POSITION];
+    estimate.east = axes_[EAST].state[POSITION];
+    estimate.velocityNorth = axes_[NORTH].state[VELOCITY];
+    estimate.velocityEast = axes_[EAST].state[VELOCITY];
+    estimate.timestampNs = lastPredictNs_;
+    estimate.valid = valid_;
+    estimate.aligned = aligned_;
+    return estimate;
+}
+
+bool PositionEstimator::stateAt(int64_t timestampNs, HistoryEntry& entry) const {
+    // Measurements from the future (clock jitter) are taken as current
+    if (historyCount_ == 0 || timestampNs >= lastPredictNs_) {
+        entry.timestampNs = lastPredictNs_;
+        for (size_t i = 0; i < AXES; ++i) {
+            entry.position[i] = axes_[i].state[POSITION];
+            entry.velocity[i] = axes_[i].state[VELOCITY];
+        }
+        return true;
+    }
+
+    // Newest entry at or before the measurement, searching backwards
+    for (size_t i = 1; i <= historyCount_; ++i) {
+        const HistoryEntry& past = history_[(historyNext_ + HISTORY_SIZE - i) % HISTORY_SIZE];
+        if (past.timestampNs <= timestampNs) {
+            entry = past;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PositionEstimator::fuse(Axis& axis, size_t index, float innovation, float variance) {
+    // Scalar update on one state: S = P(i,i) + R, K = P(:,i) / S
+    const float s = axis.covariance(index, index) + variance;
+    if (s <= 0.0f || innovation * innovation > GATE_SIGMA * GATE_SIGMA * s) {
+        return false;
+    }
+
+    Vector3 gain;
+    for (size_t row = 0; row < 3; ++row) {
+        gain[row] = axis.covariance(row, index) / s;
+    }
+    axis.state += gain * innovation;
+
+    // Joseph form keeps the covariance symmetric and positive
+    Matrix3 correction = Matrix3::identity();
+    for (size_t row = 0; row < 3; ++row) {
+        correction(row, index) -= gain[row];
+    }
+    axis.covariance = correction * axis.covariance * correction.transposed() +
+                      (gain * gain.transposed()) * variance;
+    return true;
+}
+
+} // namespace estimation
+} // namespace drone
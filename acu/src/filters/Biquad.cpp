@@ -0,0 +1,49 @@
+#include "filters/Biquad.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace drone {
+namespace filters {
+
+namespace {
+    constexpr float PI = 3.14159265358979f;
+
+    // Keep designs below Nyquist where the bilinear transform is defined
+    float normalizedOmega(float frequencyHz, float sampleRateHz) {
+        float limited = std::min(frequencyHz, 0.45f * sampleRateHz);
+        return 2.0f * PI * std::max(limited, 0.001f) / sampleRateHz;
+    }
+}
+
+BiquadCoefficients BiquadCoefficients::lowPass(float cutoffHz, float sampleRateHz, float q) {
+    float omega = normalizedOmega(cutoffHz, sampleRateHz);
+    float cosOmega = std::cos(omega);
+    float alpha = std::sin(omega) / (2.0f * q);
+    float a0 = 1.0f + alpha;
+
+    BiquadCoefficients c;
+    c.b0 = (1.0f - cosOmega) * 0.5f / a0;
+    c.b1 = (1.0f - cosOmega) / a0;
+    c.b2 = c.b0;
+    c.a1 = -2.0f * cosOmega / a0;
+    c.a2 = (1.0f - alpha) / a0;
+    return c;
+}
+
+BiquadCoefficients BiquadCoefficients::notch(float centerHz, float sampleRateHz, float q) {
+    float omega = normalizedOmega(centerHz, sampleRateHz);
+    float cosOmega = std::cos(omega);
+    float alpha = std::sin(omega) / (2.0f * q);
+    float a0 = 1.0f + alpha;
+
+    BiquadCoefficients c;
+    c.b0 = 1.0f / a0;
+    c.b1 = -2.0f * cosOmega / a0;
+    c.b2 = c.b0;
+    c.a1 = c.b1;
+    c.a2 = (1.0f - alpha) / a0;
+    return c;
+}
+
+} // namespace filters
+} // namespace drone
@@ -0,0 +1,155 @@
+#include "filters/BiquadBank.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BIQUAD_BANK_NEON 1
+#elif defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define BIQUAD_BANK_SSE 1
+#endif
+
+namespace drone {
+namespace filters {
+
+BiquadBank::BiquadBank()
+    : configured_{}
+    , activeStages_(0) {
+    for (size_t stage = 0; stage < MAX_STAGES; ++stage) {
+        clearStage(stage);
+    }
+    reset();
+}
+
+void BiquadBank::setStage(size_t stage, size_t first, size_t count,
+                          const BiquadCoefficients& coefficients) {
+    if (stage >= MAX_STAGES || first >= CHANNELS) return;
+
+    Stage& s = stages_[stage];
+    size_t last = std::min(first + count, CHANNELS);
+    for (size_t lane = first; lane < last; ++lane) {
+        s.b0[lane] = coefficients.b0;
+        s.b1[lane] = coefficients.b1;
+        s.b2[lane] = coefficients.b2;
+        s.a1[lane] = coefficients.a1;
+        s.a2[lane] = coefficients.a2;
+    }
+
+    configured_[stage] = true;
+    updateActiveStages();
+}
+
+void BiquadBank::clearStage(size_t stage) {
+    if (stage >= MAX_STAGES) return;
+
+    // Pass-through on every lane, including the two padding lanes
+    Stage& s = stages_[stage];
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        s.b0[lane] = 1.0f;
+        s.b1[lane] = 0.0f;
+        s.b2[lane] = 0.0f;
+        s.a1[lane] = 0.0f;
+        s.a2[lane] = 0.0f;
+    }
+
+    configured_[stage] = false;
+    updateActiveStages();
+}
+
+void BiquadBank::prime(const float input[CHANNELS]) {
+    float x[LANES] = {};
+    std::memcpy(x, input, CHANNELS * sizeof(float));
+
+    // Steady state of the transposed direct form for a constant input
+    for (size_t stage = 0; stage < activeStages_; ++stage) {
+        Stage& s = stages_[stage];
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            BiquadCoefficients c;
+            c.b0 = s.b0[lane];
+            c.b1 = s.b1[lane];
+            c.b2 = s.b2[lane];
+            c.a1 = s.a1[lane];
+            c.a2 = s.a2[lane];
+
+            float y = x[lane] * c.dcGain();
+            s.s2[lane] = c.b2 * x[lane] - c.a2 * y;
+            s.s1[lane] = c.b1 * x[lane] - c.a1 * y + s.s2[lane];
+            x[lane] = y;
+        }
+    }
+}
+
+void BiquadBank::reset() {
+    for (auto& stage : stages_) {
+        std::fill(std::begin(stage.s1), std::end(stage.s1), 0.0f);
+        std::fill(std::begin(stage.s2), std::end(stage.s2), 0.0f);
+    }
+}
+
+void BiquadBank::process(const float input[CHANNELS], float output[CHANNELS]) {
+    alignas(16) float x[LANES] = {};
+    std::memcpy(x, input, CHANNELS * sizeof(float));
+
+    // y = b0 x + s1;  s1 = b1 x - a1 y + s2;  s2 = b2 x - a2 y
+    for (size_t index = 0; index < activeStages_; ++index) {
+        Stage& s = stages_[index];
+
+#if defined(BIQUAD_BANK_NEON)
+        for (size_t lane = 0; lane < LANES; lane += 4) {
+            float32x4_t in = vld1q_f32(&x[lane]);
+            float32x4_t s1 = vld1q_f32(&s.s1[lane]);
+            float32x4_t s2 = vld1q_f32(&s.s2[lane]);
+
+            float32x4_t y = vmlaq_f32(s1, vld1q_f32(&s.b0[lane]), in);
+            s1 = vmlaq_f32(s2, vld1q_f32(&s.b1[lane]), in);
+            s1 = vmlsq_f32(s1, vld1q_f32(&s.a1[lane]), y);
+            s2 = vmulq_f32(vld1q_f32(&s.b2[lane]), in);
+            s2 = vmlsq_f32(s2, vld1q_f32(&s.a2[lane]), y);
+
+            vst1q_f32(&s.s1[lane], s1);
+            vst1q_f32(&s.s2[lane], s2);
+            vst1q_f32(&x[lane], y);
+        }
+#elif defined(BIQUAD_BANK_SSE)
+        for (size_t lane = 0; lane < LANES; lane += 4) {
+            __m128 in = _mm_load_ps(&x[lane]);
+            __m128 s1 = _mm_load_ps(&s.s1[lane]);
+            __m128 s2 = _mm_load_ps(&s.s2[lane]);
+
+            __m128 y = _mm_add_ps(_mm_mul_ps(_mm_load_ps(&s.b0[lane]), in), s1);
+            s1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_load_ps(&s.b1[lane]), in),
+                                       _mm_mul_ps(_mm_load_ps(&s.a1[lane]), y)), s2);
+            s2 = _mm_sub_ps(_mm_mul_ps(_mm_load_ps(&s.b2[lane]), in),
+                            _mm_mul_ps(_mm_load_ps(&s.a2[lane]), y));
+
+            _mm_store_ps(&s.s1[lane], s1);
+            _mm_store_ps(&s.s2[lane], s2);
+            _mm_store_ps(&x[lane], y);
+        }
+#else
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            float in = x[lane];
+            float y = s.b0[lane] * in + s.s1[lane];
+            s.s1[lane] = s.b1[lane] * in - s.a1[lane] * y + s.s2[lane];
+            s.s2[lane] = s.b2[lane] * in - s.a2[lane] * y;
+            x[lane] = y;
+        }
+#endif
+    }
+
+    std::memcpy(output, x, CHANNELS * sizeof(float));
+}
+
+void BiquadBank::updateActiveStages() {
+    // Trailing pass-through stages are skipped entirely
+    activeStages_ = 0;
+    for (size_t stage = 0; stage < MAX_STAGES; ++stage) {
+        if (configured_[stage]) {
+            activeStages_ = stage + 1;
+        }
+    }
+}
+
+} // namespace filters
+} // namespace drone
@@ -0,0 +1,223 @@
+#include "filters/SpectrumAnalyzer.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace drone {
+namespace filters {
+
+namespace {
+    constexpr float PI = 3.14159265358979f;
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer(float sampleRateHz, float minFrequencyHz, float maxFrequencyHz)
+    : binWidth_(sampleRateHz / FFT_SIZE)
+    , minBin_(std::max<size_t>(2, static_cast<size_t>(minFrequencyHz / binWidth_)))
+    , maxBin_(std::min<size_t>(BINS - 2, static_cast<size_t>(maxFrequencyHz / binWidth_)))
+    , capture_{}
+    , writeIndex_(0)
+    , pending_(0)
+    , phase_(Phase::IDLE)
+    , stage_(0)
+    , axis_(0)
+    , real_{}
+    , imag_{}
+    , results_{}
+    , missed_{}
+    , lastAxis_(0) {
+    for (size_t i = 0; i < FFT_SIZE; ++i) {
+        window_[i] = 0.5f - 0.5f * std::cos(2.0f * PI * i / (FFT_SIZE - 1));
+
+        size_t reversed = 0;
+        for (size_t bit = 0; bit < STAGES; ++bit) {
+            reversed |= ((i >> bit) & 1u) << (STAGES - 1 - bit);
+        }
+        bitReverse_[i] = static_cast<uint16_t>(reversed);
+    }
+    for (size_t k = 0; k < BINS; ++k) {
+        cosTable_[k] = std::cos(2.0f * PI * k / FFT_SIZE);
+        sinTable_[k] = -std::sin(2.0f * PI * k / FFT_SIZE);
+    }
+}
+
+void SpectrumAnalyzer::push(const float gyro[AXES]) {
+    for (size_t axis = 0; axis < AXES; ++axis) {
+        capture_[axis][writeIndex_] = gyro[axis];
+    }
+    writeIndex_ = (writeIndex_ + 1) % FFT_SIZE;
+    pending_++;
+}
+
+bool SpectrumAnalyzer::step() {
+    switch (phase_) {
+        case Phase::IDLE:
+            if (pending_ < HOP) {
+                return false;
+            }
+            pending_ = 0;
+            load();
+            stage_ = 0;
+            phase_ = Phase::BUTTERFLY;
+            return false;
+
+        case Phase::BUTTERFLY:
+            butterflyStage(stage_);
+            if (++stage_ == STAGES) {
+                phase_ = Phase::ANALYZE;
+            }
+            return false;
+
+        case Phase::ANALYZE:
+            analyze();
+            lastAxis_ = axis_;
+            axis_ = (axis_ + 1) % AXES;
+            phase_ = Phase::IDLE;
+            return true;
+    }
+    return false;
+}
+
+void SpectrumAnalyzer::load() {
+    // Oldest sample first, windowed, written in bit-reversed order so the
+    // butterflies can run in place
+    const auto& samples = capture_[axis_];
+    float mean = 0.0f;
+    for (float value : samples) {
+        mean += value;
+    }
+    mean /= FFT_SIZE;
+
+    for (size_t i = 0; i < FFT_SIZE; ++i) {
+        float value = samples[(writeIndex_ + i) % FFT_SIZE] - mean;
+        real_[bitReverse_[i]] = value * window_[i];
+        imag_[bitReverse_[i]] = 0.0f;
+    }
+}
+
+void SpectrumAnalyzer::butterflyStage(size_t stage) {
+    const size_t half = size_t(1) << stage;
+    const size_t span = half << 1;
+    const size_t twiddleStride = FFT_SIZE / span;
+
+    for (size_t group = 0; group < FFT_SIZE; group += span) {
+        for (size_t k = 0; k < half; ++k) {
+            float wr = cosTable_[k * twiddleStride];
+            float wi = sinTable_[k * twiddleStride];
+
+            size_t top = group + k;
+            size_t bottom = top + half;
+            float tr = wr * real_[bottom] - wi * imag_[bottom];
+            float ti = wr * imag_[bottom] + wi * real_[bottom];
+
+            real_[bottom] = real_[top] - tr;
+            imag_[bottom] = imag_[top] - ti;
+            real_[top] += tr;
+            imag_[top] += ti;
+        }
+    }
+}
+
+void SpectrumAnalyzer::analyze() {
+    Result& result = results_[axis_];
+
+    // Hann coherent gain is 0.5, so amplitude = 2 * |X| / (N * 0.5)
+    const float scale = 4.0f / FFT_SIZE;
+    float bandSum = 0.0f;
+    for (size_t k = 0; k < BINS; ++k) {
+        result.magnitude[k] = std::sqrt(real_[k] * real_[k] + imag_[k] * imag_[k]) * scale;
+        if (k >= minBin_ && k <= maxBin_) {
+            bandSum += result.magnitude[k];
+        }
+    }
+    const float threshold = PEAK_THRESHOLD * bandSum / (maxBin_ - minBin_ + 1);
+
+    // Strongest local maxima in the band
+    Peak found[MAX_PEAKS];
+    size_t foundCount = 0;
+    for (size_t k = minBin_; k <= maxBin_; ++k) {
+        float m = result.magnitude[k];
+        if (m < threshold || m <= result.magnitude[k - 1] || m < result.magnitude[k + 1]) {
+            continue;
+        }
+
+        // Parabolic interpolation between neighbouring bins
+        float left = result.magnitude[k - 1];
+        float right = result.magnitude[k + 1];
+        float denominator = left - 2.0f * m + right;
+        float offset = denominator != 0.0f ? 0.5f * (left - right) / denominator : 0.0f;
+        Peak peak;
+        peak.frequency = (k + offset) * binWidth_;
+        peak.magnitude = m;
+
+        if (foundCount < MAX_PEAKS) {
+            found[foundCount++] = peak;
+        } else {
+            auto weakest = std::min_element(found, found + MAX_PEAKS,
+                [](const Peak& a, const Peak& b) { return a.magnitude < b.magnitude; });
+            if (peak.magnitude > weakest->magnitude) {
+                *weakest = peak;
+            }
+        }
+    }
+    std::sort(found, found + foundCount,
+              [](const Peak& a, const Peak& b) { return a.magnitude > b.magnitude; });
+
+    // Each found peak continues the nearest tracked peak within tolerance,
+    // strongest first, so a slot keeps following the same vibration when
+    // other peaks come and go
+    bool slotMatched[MAX_PEAKS] = {};
+    bool peakMatched[MAX_PEAKS] = {};
+    for (size_t i = 0; i < foundCount; ++i) {
+        size_t nearest = MAX_PEAKS;
+        float nearestDistance = MATCH_TOLERANCE_HZ;
+        for (size_t slot = 0; slot < MAX_PEAKS; ++slot) {
+            const Peak& tracked = result.peaks[slot];
+            float distance = std::abs(found[i].frequency - tracked.frequency);
+            if (tracked.frequency > 0.0f && !slotMatched[slot] && distance <= nearestDistance) {
+                nearest = slot;
+                nearestDistance = distance;
+            }
+        }
+        if (nearest == MAX_PEAKS) {
+            continue;
+        }
+        Peak& tracked = result.peaks[nearest];
+        tracked.frequency += SMOOTHING * (found[i].frequency - tracked.frequency);
+        tracked.magnitude = found[i].magnitude;
+        missed_[axis_][nearest] = 0;
+        slotMatched[nearest] = true;
+        peakMatched[i] = true;
+    }
+
+    // A missing peak is held for a few transforms so the notch does not flap
+    for (size_t slot = 0; slot < MAX_PEAKS; ++slot) {
+        Peak& tracked = result.peaks[slot];
+        if (!slotMatched[slot] && tracked.frequency > 0.0f && ++missed_[axis_][slot] > PEAK_HOLD) {
+            tracked = Peak();
+        }
+    }
+
+    // New peaks only take free slots, never one still held for another
+    for (size_t i = 0; i < foundCount; ++i) {
+        if (peakMatched[i]) {
+            continue;
+        }
+        for (size_t slot = 0; slot < MAX_PEAKS; ++slot) {
+            if (result.peaks[slot].frequency == 0.0f) {
+                result.peaks[slot] = found[i];
+                missed_[axis_][slot] = 0;
+                break;
+            }
+        }
+    }
+
+    result.peakCount = 0;
+    for (const auto& peak : result.peaks) {
+        if (peak.frequency > 0.0f) {
+            result.peakCount++;
+        }
+    }
+    result.sequence++;
+}
+
+} // namespace filters
+} // namespace drone
@@ -0,0 +1,69 @@
+#include "geodesy/LocalFrame.hpp"
+#include "math/FastMath.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace drone {
+namespace geodesy {
+
+namespace {
+    // WGS-84 ellipsoid
+    constexpr double SEMI_MAJOR_AXIS = 6378137.0;
+    constexpr double ECCENTRICITY_SQUARED = 6.69437999014e-3;
+    constexpr double RADIANS_PER_DEGREE = 3.14159265358979323846 / 180.0;
+}
+
+LocalFrame::LocalFrame() {
+    setOrigin(0.0, 0.0, 0.0f);
+    hasOrigin_ = false;
+}
+
+void LocalFrame::setOrigin(double latitude, double longitude, float altitude) {
+    originLatitude_ = latitude;
+    originLongitude_ = longitude;
+    originAltitude_ = altitude;
+
+    const double sinLat = std::sin(latitude * RADIANS_PER_DEGREE);
+    const double cosLat = std::cos(latitude * RADIANS_PER_DEGREE);
+    const double w2 = 1.0 - ECCENTRICITY_SQUARED * sinLat * sinLat;
+    const double w = std::sqrt(w2);
+
+    // Meridian and prime vertical radii of curvature, lifted to the origin
+    const double meridian = SEMI_MAJOR_AXIS * (1.0 - ECCENTRICITY_SQUARED) / (w2 * w) + altitude;
+    const double primeVertical = SEMI_MAJOR_AXIS / w + altitude;
+
+    northScale_ = meridian * RADIANS_PER_DEGREE;
+    eastScale_ = primeVertical * cosLat * RADIANS_PER_DEGREE;
+    // d(N cos(lat))/d(lat) = -M sin(lat)
+    eastScaleSlope_ = -meridian * sinLat * RADIANS_PER_DEGREE * RADIANS_PER_DEGREE;
+    // A parallel bends poleward of the plane's east axis
+    northCurvature_ = 0.5 * primeVertical * sinLat * cosLat * RADIANS_PER_DEGREE * RADIANS_PER_DEGREE;
+    hasOrigin_ = true;
+}
+
+void LocalFrame::rangeAndBearing(float east, float north, const float* targetEast,
+                                 const float* targetNorth, size_t count,
+                                 float* range, float* bearing) {
+    for (size_t i = 0; i < count; ++i) {
+        const float dEast = targetEast[i] - east;
+        const float dNorth = targetNorth[i] - north;
+        const float squared = dEast * dEast + dNorth * dNorth;
+        // The inverse square root seed is finite at zero, so no test is needed
+        range[i] = squared * math::fastInvSqrt(squared);
+
+        // fastAtan2(dEast, dNorth), unfolded by octant with 0/1 multipliers
+        // rather than branches or selects; GCC will not if-convert float
+        // selects under the default -ftrapping-math
+        const float ae = std::fabs(dEast);
+        const float an = std::fabs(dNorth);
+        float angle = math::fastAtanUnit(std::min(ae, an) / std::max(std::max(ae, an), FLT_MIN));
+        angle += static_cast<float>(ae > an) * (math::HALF_PI - 2.0f * angle);
+        angle += static_cast<float>(dNorth < 0.0f) * (math::PI - 2.0f * angle);
+        angle += static_cast<float>(dEast < 0.0f) * (2.0f * math::PI - 2.0f * angle);
+        bearing[i] = angle * math::RAD_TO_DEG;
+    }
+}
+
+} // namespace geodesy
+} // namespace drone
@@ -0,0 +1,242 @@
+#include "hal/GpioLine.hpp"
+#include "runtime/Clock.hpp"
+#include <linux/gpio.h>
+#include <sys/ioctl.h>
+#include <sys/eventfd.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <wiringPi.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace drone {
+namespace hal {
+
+std::array<std::atomic<GpioLine*>, GpioLine::MAX_ISR_PINS> GpioLine::isrLines_{};
+
+template<unsigned int Pin>
+void GpioLine::isrTrampoline() {
+    GpioLine* line = isrLines_[Pin].load(std::memory_order_acquire);
+    if (line) {
+        line->onInterrupt();
+    }
+}
+
+template<unsigned int... Pins>
+std::array<void (*)(), sizeof...(Pins)> GpioLine::makeTrampolines(
+    std::integer_sequence<unsigned int, Pins...>) {
+    return {{&GpioLine::isrTrampoline<Pins>...}};
+}
+
+GpioLine::GpioLine(const std::string& chipPath, unsigned int offset)
+    : chipPath_(chipPath)
+    , offset_(offset)
+    , mode_(Mode::NONE)
+    , lineFd_(-1)
+    , notifyFd_(-1)
+    , isrQueue_{}
+    , isrHead_(0)
+    , isrTail_(0)
+    , dropped_(0) {
+}
+
+GpioLine::~GpioLine() {
+    release();
+}
+
+bool GpioLine::requestOutput(bool initialValue, const char* consumer) {
+    release();
+
+    lineFd_ = requestLine(GPIO_V2_LINE_FLAG_OUTPUT, initialValue, consumer);
+    if (lineFd_ < 0) {
+        pinMode(static_cast<int>(offset_), OUTPUT);
+        digitalWrite(static_cast<int>(offset_), initialValue ? HIGH : LOW);
+    }
+
+    mode_ = Mode::DRIVEN;
+    return true;
+}
+
+bool GpioLine::requestEdgeEvents(const char* consumer) {
+    release();
+
+    // Kernel timestamps default to CLOCK_MONOTONIC, the control loop clock
+    lineFd_ = requestLine(GPIO_V2_LINE_FLAG_INPUT |
+                          GPIO_V2_LINE_FLAG_EDGE_RISING |
+                          GPIO_V2_LINE_FLAG_EDGE_FALLING,
+                          false, consumer);
+    if (lineFd_ >= 0) {
+        int flags = fcntl(lineFd_, F_GETFL, 0);
+        fcntl(lineFd_, F_SETFL, flags | O_NONBLOCK);
+    } else {
+        pinMode(static_cast<int>(offset_), INPUT);
+        if (!attachInterrupt()) {
+            return false;
+        }
+    }
+
+    mode_ = Mode::EVENTS;
+    return true;
+}
+
+void GpioLine::release() {
+    if (mode_ == Mode::EVENTS && lineFd_ < 0) {
+        detachInterrupt();
+    }
+    if (lineFd_ >= 0) {
+        close(lineFd_);
+        lineFd_ = -1;
+    }
+    if (mode_ == Mode::DRIVEN) {
+        pinMode(static_cast<int>(offset_), INPUT);
+    }
+    mode_ = Mode::NONE;
+}
+
+bool GpioLine::setValue(bool value) {
+    if (mode_ != Mode::DRIVEN) return false;
+
+    if (lineFd_ < 0) {
+        digitalWrite(static_cast<int>(offset_), value ? HIGH : LOW);
+        return true;
+    }
+
+    struct gpio_v2_line_values values;
+    std::memset(&values, 0, sizeof(values));
+    values.mask = 1;
+    values.bits = value ? 1 : 0;
+    return ioctl(lineFd_, GPIO_V2_LINE_SET_VALUES_IOCTL, &values) == 0;
+}
+
+size_t GpioLine::readEvents(EdgeEvent* events, size_t maxEvents) {
+    if (mode_ != Mode::EVENTS || maxEvents == 0) return 0;
+
+    size_t count = 0;
+
+    if (lineFd_ >= 0) {
+        struct gpio_v2_line_event raw[ISR_QUEUE_SIZE];
+        size_t want = std::min(maxEvents, ISR_QUEUE_SIZE);
+        ssize_t bytes = read(lineFd_, raw, want * sizeof(raw[0]));
+        if (bytes <= 0) {
+            return 0;  // EAGAIN: nothing queued
+        }
+
+        size_t received = static_cast<size_t>(bytes) / sizeof(raw[0]);
+        for (size_t i = 0; i < received; ++i) {
+            events[count].edge = raw[i].id == GPIO_V2_LINE_EVENT_RISING_EDGE ?
+                Edge::RISING : Edge::FALLING;
+            events[count].timestampNs = static_cast<int64_t>(raw[i].timestamp_ns);
+            count++;
+        }
+        return count;
+    }
+
+    uint64_t pending;
+    if (read(notifyFd_, &pending, sizeof(pending)) < 0) {
+        // EAGAIN: no interrupt since the last drain
+    }
+
+    uint32_t tail = isrTail_.load(std::memory_order_relaxed);
+    uint32_t head = isrHead_.load(std::memory_order_acquire);
+    while (tail != head && count < maxEvents) {
+        events[count++] = isrQueue_[tail & (ISR_QUEUE_SIZE - 1)];
+        tail++;
+    }
+    isrTail_.store(tail, std::memory_order_release);
+    return count;
+}
+
+int GpioLine::requestLine(uint64_t flags, bool initialValue, const char* consumer) {
+    int chipFd = open(chipPath_.c_str(), O_RDWR | O_CLOEXEC);
+    if (chipFd < 0) {
+        return -1;
+    }
+
+    struct gpio_v2_line_request request;
+    std::memset(&request, 0, sizeof(request));
+    request.offsets[0] = offset_;
+    request.num_lines = 1;
+    std::strncpy(request.consumer, consumer, sizeof(request.consumer) - 1);
+    request.config.flags = flags;
+    if (flags & GPIO_V2_LINE_FLAG_OUTPUT) {
+        request.config.num_attrs = 1;
+        request.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+        request.config.attrs[0].attr.values = initialValue ? 1 : 0;
+        request.config.attrs[0].mask = 1;
+    }
+
+    int rc = ioctl(chipFd, GPIO_V2_GET_LINE_IOCTL, &request);
+    int savedErrno = errno;
+    close(chipFd);
+
+    if (rc < 0) {
+        std::cerr << "Failed to request " << chipPath_ << " line " << offset_
+                  << ": " << strerror(savedErrno) << std::endl;
+        return -1;
+    }
+    return request.fd;
+}
+
+bool GpioLine::attachInterrupt() {
+    static const auto trampolines =
+        makeTrampolines(std::make_integer_sequence<unsigned int, MAX_ISR_PINS>{});
+
+    if (offset_ >= MAX_ISR_PINS) {
+        std::cerr << "No interrupt slot for GPIO " << offset_ << std::endl;
+        return false;
+    }
+
+    notifyFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (notifyFd_ < 0) {
+        std::cerr << "Failed to create eventfd: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    isrLines_[offset_].store(this, std::memory_order_release);
+    if (wiringPiISR(static_cast<int>(offset_), INT_EDGE_BOTH, trampolines[offset_]) < 0) {
+        detachInterrupt();
+        std::cerr << "Failed to attach interrupt to GPIO " << offset_ << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void GpioLine::detachInterrupt() {
+    // wiringPi cannot remove a handler; the trampoline just stops forwarding
+    if (offset_ < MAX_ISR_PINS) {
+        isrLines_[offset_].store(nullptr, std::memory_order_release);
+    }
+    if (notifyFd_ >= 0) {
+        close(notifyFd_);
+        notifyFd_ = -1;
+    }
+}
+
+void GpioLine::onInterrupt() {
+    // Runs on wiringPi's interrupt thread. The level is read after the edge,
+    // so a very short pulse can report the wrong direction; the chardev path
+    // gets the edge from the kernel and does not have this problem.
+    int64_t now = runtime::monotonicNanoseconds();
+    Edge edge = digitalRead(static_cast<int>(offset_)) == HIGH ? Edge::RISING : Edge::FALLING;
+
+    uint32_t head = isrHead_.load(std::memory_order_relaxed);
+    uint32_t tail = isrTail_.load(std::memory_order_acquire);
+    if (head - tail >= ISR_QUEUE_SIZE) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    isrQueue_[head & (ISR_QUEUE_SIZE - 1)] = {edge, now};
+    isrHead_.store(head + 1, std::memory_order_release);
+
+    uint64_t one = 1;
+    if (write(notifyFd_, &one, sizeof(one)) < 0) {
+        // Counter saturated; the reader is already due to wake
+    }
+}
+
+} // namespace hal
+} // namespace drone
@@ -0,0 +1,125 @@
+#include "hal/LinuxI2CDevice.hpp"
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+#include <iostream>
+
+namespace drone {
+namespace hal {
+
+LinuxI2CDevice::LinuxI2CDevice(const std::string& busPath, uint8_t address)
+    : busPath_(busPath)
+    , address_(address)
+    , fd_(-1)
+    , transactions_(0)
+    , errors_(0) {
+}
+
+LinuxI2CDevice::~LinuxI2CDevice() {
+    close();
+}
+
+bool LinuxI2CDevice::open() {
+    if (fd_ >= 0) return true;
+
+    fd_ = ::open(busPath_.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd_ < 0) {
+        std::cerr << "Failed to open " << busPath_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    unsigned long functions = 0;
+    if (ioctl(fd_, I2C_FUNCS, &functions) < 0 || !(functions & I2C_FUNC_I2C)) {
+        std::cerr << busPath_ << " does not support combined I2C transfers" << std::endl;
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void LinuxI2CDevice::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool LinuxI2CDevice::writeRegister(uint8_t reg, uint8_t value) {
+    uint8_t data[2] = {reg, value};
+
+    struct i2c_msg message;
+    message.addr = address_;
+    message.flags = 0;
+    message.len = sizeof(data);
+    message.buf = data;
+
+    struct i2c_rdwr_ioctl_data transfer;
+    transfer.msgs = &message;
+    transfer.nmsgs = 1;
+
+    transactions_.fetch_add(1, std::memory_order_relaxed);
+    if (ioctl(fd_, I2C_RDWR, &transfer) < 0) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool LinuxI2CDevice::writeRegisters(uint8_t reg, const uint8_t* data, size_t length) {
+    // Register address and data go out as one message
+    uint8_t buffer[MAX_WRITE_LENGTH + 1];
+    if (length == 0 || length > MAX_WRITE_LENGTH) return false;
+    buffer[0] = reg;
+    std::memcpy(&buffer[1], data, length);
+
+    struct i2c_msg message;
+    message.addr = address_;
+    message.flags = 0;
+    message.len = static_cast<uint16_t>(length + 1);
+    message.buf = buffer;
+
+    struct i2c_rdwr_ioctl_data transfer;
+    transfer.msgs = &message;
+    transfer.nmsgs = 1;
+
+    transactions_.fetch_add(1, std::memory_order_relaxed);
+    if (ioctl(fd_, I2C_RDWR, &transfer) < 0) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool LinuxI2CDevice::readRegisters(uint8_t reg, uint8_t* buffer, size_t length) {
+    if (length == 0 || length > UINT16_MAX) return false;
+
+    // Address write and data read joined by a repeated start
+    struct i2c_msg messages[2];
+    messages[0].addr = address_;
+    messages[0].flags = 0;
+    messages[0].len = 1;
+    messages[0].buf = &reg;
+    messages[1].addr = address_;
+    messages[1].flags = I2C_M_RD;
+    messages[1].len = static_cast<uint16_t>(length);
+    messages[1].buf = buffer;
+
+    struct i2c_rdwr_ioctl_data transfer;
+    transfer.msgs = messages;
+    transfer.nmsgs = 2;
+
+    transactions_.fetch_add(1, std::memory_order_relaxed);
+    if (ioctl(fd_, I2C_RDWR, &transfer) < 0) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+} // namespace hal
+} // namespace drone
@@ -0,0 +1,104 @@
+#include "hal/Pca9685.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <utility>
+
+namespace drone {
+namespace hal {
+
+Pca9685::Pca9685(std::unique_ptr<I2CDevice> device, float oscillatorHz)
+    : device_(std::move(device))
+    , oscillatorHz_(oscillatorHz)
+    , frequencyHz_(0.0f)
+    , countsPerUs_(0.0f)
+    , open_(false) {
+}
+
+Pca9685::~Pca9685() {
+    close();
+}
+
+bool Pca9685::open(uint32_t frequencyHz) {
+    if (open_) return true;
+    if (!device_ || !device_->open()) {
+        std::cerr << "PCA9685: I2C device unavailable" << std::endl;
+        return false;
+    }
+
+    // The prescaler only takes a value while the oscillator sleeps. The
+    // datasheet range of 3-255 covers roughly 24 Hz to 1.5 kHz.
+    long prescale = std::lround(oscillatorHz_ / (static_cast<float>(COUNTS) * frequencyHz)) - 1;
+    if (frequencyHz == 0 || prescale < 3 || prescale > 255) {
+        std::cerr << "PCA9685: " << frequencyHz << " Hz is out of range" << std::endl;
+        return false;
+    }
+
+    uint8_t mode1 = 0;
+    if (!device_->readRegister(MODE1, mode1)) {
+        std::cerr << "PCA9685: no response" << std::endl;
+        return false;
+    }
+
+    // ALL_LED_OFF_H loads every channel's OFF_H, so this leaves each output
+    // off until write() gives it a pulse
+    const uint8_t sleep = static_cast<uint8_t>((mode1 & ~MODE1_RESTART) | MODE1_SLEEP);
+    const uint8_t awake = MODE1_AI | MODE1_ALLCALL;
+    if (!device_->writeRegister(MODE1, sleep) ||
+        !device_->writeRegister(ALL_LED_OFF_H, LED_FULL) ||
+        !device_->writeRegister(PRE_SCALE, static_cast<uint8_t>(prescale)) ||
+        !device_->writeRegister(MODE2, MODE2_OUTDRV) ||
+        !device_->writeRegister(MODE1, awake)) {
+        std::cerr << "PCA9685: configuration failed" << std::endl;
+        return false;
+    }
+
+    // The oscillator needs 500 us to settle before a restart
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+    if (!device_->writeRegister(MODE1, awake | MODE1_RESTART)) {
+        std::cerr << "PCA9685: restart failed" << std::endl;
+        return false;
+    }
+
+    frequencyHz_ = oscillatorHz_ / (static_cast<float>(COUNTS) * (prescale + 1));
+    countsPerUs_ = frequencyHz_ * COUNTS / 1e6f;
+    open_ = true;
+    return true;
+}
+
+void Pca9685::close() {
+    if (!open_) return;
+    device_->writeRegister(ALL_LED_OFF_H, LED_FULL);
+    device_->writeRegister(MODE1, MODE1_AI | MODE1_ALLCALL | MODE1_SLEEP);
+    device_->close();
+    open_ = false;
+}
+
+bool Pca9685::write(const uint16_t* pulseUs, size_t count) {
+    if (!open_ || count == 0 || count > CHANNELS) return false;
+
+    // LEDn_ON_L, LEDn_ON_H, LEDn_OFF_L, LEDn_OFF_H per channel. Every pulse
+    // starts at count 0 and ends at its OFF count.
+    uint8_t frame[CHANNELS * 4];
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t* registers = &frame[i * 4];
+        registers[0] = 0;
+        registers[1] = 0;
+        if (pulseUs[i] == 0) {
+            registers[2] = 0;
+            registers[3] = LED_FULL;
+            continue;
+        }
+        long counts = std::lround(pulseUs[i] * countsPerUs_);
+        counts = std::min<long>(std::max<long>(counts, 1), COUNTS - 1);
+        registers[2] = static_cast<uint8_t>(counts & 0xFF);
+        registers[3] = static_cast<uint8_t>(counts >> 8);
+    }
+
+    return device_->writeRegisters(LED0_ON_L, frame, count * 4);
+}
+
+} // namespace hal
+} // namespace drone
@@ -0,0 +1,135 @@
+#include "hal/SysfsPwm.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+namespace drone {
+namespace hal {
+
+namespace {
+    bool writeAttribute(const std::string& path, const std::string& value) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        ssize_t written = ::write(fd, value.data(), value.size());
+        int error = errno;
+        ::close(fd);
+        errno = error;
+        return written == static_cast<ssize_t>(value.size());
+    }
+}
+
+SysfsPwm::SysfsPwm(const std::string& chipPath, size_t channels)
+    : chipPath_(chipPath)
+    , channelCount_(channels)
+    , dutyFds_(channels, -1)
+    , pulses_(channels, 0)
+    , periodNs_(0)
+    , writes_(0) {
+}
+
+SysfsPwm::~SysfsPwm() {
+    close();
+}
+
+std::string SysfsPwm::channelPath(size_t channel) const {
+    return chipPath_ + "/pwm" + std::to_string(channel);
+}
+
+bool SysfsPwm::exportChannel(size_t channel) {
+    if (access(channelPath(channel).c_str(), F_OK) == 0) {
+        return true;
+    }
+    if (!writeAttribute(chipPath_ + "/export", std::to_string(channel)) && errno != EBUSY) {
+        std::cerr << "Failed to export " << channelPath(channel) << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // udev sets the attribute permissions shortly after the export
+    for (int attempt = 0; attempt < 20; ++attempt) {
+        if (access((channelPath(channel) + "/duty_cycle").c_str(), W_OK) == 0) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::cerr << channelPath(channel) << " did not become writable" << std::endl;
+    return false;
+}
+
+bool SysfsPwm::open(uint32_t frequencyHz) {
+    if (frequencyHz == 0) return false;
+    close();
+
+    // A chip with fewer channels cannot drive every output
+    size_t available = 0;
+    std::ifstream npwm(chipPath_ + "/npwm");
+    if (!(npwm >> available) || available < channelCount_) {
+        std::cerr << chipPath_ << " has " << available << " PWM channels, "
+                  << channelCount_ << " needed" << std::endl;
+        return false;
+    }
+
+    periodNs_ = 1000000000u / frequencyHz;
+    for (size_t channel = 0; channel < channelCount_; ++channel) {
+        const std::string path = channelPath(channel);
+        // The duty cycle may never exceed the period, so clear it first
+        if (!exportChannel(channel) ||
+            !writeAttribute(path + "/duty_cycle", "0") ||
+            !writeAttribute(path + "/period", std::to_string(periodNs_)) ||
+            !writeAttribute(path + "/enable", "1")) {
+            std::cerr << "Failed to configure " << path << ": " << strerror(errno) << std::endl;
+            close();
+            return false;
+        }
+        dutyFds_[channel] = ::open((path + "/duty_cycle").c_str(), O_WRONLY | O_CLOEXEC);
+        if (dutyFds_[channel] < 0) {
+            std::cerr << "Failed to open " << path << "/duty_cycle: " << strerror(errno) << std::endl;
+            close();
+            return false;
+        }
+        pulses_[channel] = 0;
+    }
+    return true;
+}
+
+void SysfsPwm::close() {
+    for (size_t channel = 0; channel < channelCount_; ++channel) {
+        if (dutyFds_[channel] < 0) continue;
+        writeDuty(channel, 0);
+        ::close(dutyFds_[channel]);
+        dutyFds_[channel] = -1;
+        writeAttribute(channelPath(channel) + "/enable", "0");
+    }
+}
+
+bool SysfsPwm::writeDuty(size_t channel, uint16_t pulseUs) {
+    char text[16];
+    int length = std::snprintf(text, sizeof(text), "%u", static_cast<unsigned>(pulseUs) * 1000u);
+    writes_++;
+    return pwrite(dutyFds_[channel], text, static_cast<size_t>(length), 0) == length;
+}
+
+bool SysfsPwm::write(const uint16_t* pulseUs, size_t count) {
+    if (count > channelCount_) return false;
+
+    bool ok = true;
+    for (size_t channel = 0; channel < count; ++channel) {
+        if (dutyFds_[channel] < 0) return false;
+        if (pulseUs[channel] == pulses_[channel]) continue;
+        if (static_cast<uint32_t>(pulseUs[channel]) * 1000u >= periodNs_ ||
+            !writeDuty(channel, pulseUs[channel])) {
+            ok = false;
+            continue;
+        }
+        pulses_[channel] = pulseUs[channel];
+    }
+    return ok;
+}
+
+} // namespace hal
+} // namespace drone
@@ -2,6 +2,9 @@
 #include "control/FlightController.hpp"
 #include "communication/CommunicationManager.hpp"
 #include "state/StateMachine.hpp"
+#include "navigation/Geofence.hpp"
+#include "runtime/RealTimeExecutive.hpp"
+#include "runtime/TaskScheduler.hpp"
 #include "wifi/WiFiSetup.hpp"
 #include "Config.hpp"
 #include <iostream>
@@ -12,6 +15,8 @@
 using namespace drone;
 
 namespace {
+    constexpr uint32_t BASE_RATE_HZ = 1000;  // Scheduler base tick
+
     volatile sig_atomic_t running = 1;
 
     void signalHandler(int) {
@@ -52,12 +57,18 @@ int main() {
         communication::CommunicationManager commManager(config);
         state::StateMachine stateMachine;
 
-        // Set up component relationships
-        flightController.setSensorManager(&sensorManager);
-        commManager.setFlightController(&flightController);
+        navigation::Geofence geofence;
+        if (!config.geofence_file.empty() && !geofence.load(config.geofence_file)) {
+            std::cerr << "Failed to load geofence" << std::endl;
+            return 1;
+        }
+
+        // Sensor data, pilot commands and actuator outputs travel over the
+        // topic bus; only the state machine holds the components it commands
         stateMachine.setFlightController(&flightController);
         stateMachine.setSensorManager(&sensorManager);
         stateMachine.setCommunicationManager(&commManager);
+        stateMachine.setGeofence(&geofence);
 
         // Initialize components
         std::cout << "Initializing sensor manager..." << std::endl;
@@ -83,27 +94,114 @@ int main() {
 
         std::cout << "ACU system initialized and running" << std::endl;
 
-        // Main control loop
-        const auto updateInterval = std::chrono::milliseconds(5);  // 200Hz
-        auto lastUpdate = std::chrono::steady_clock::now();
-
-        while (running) {
-            auto now = std::chrono::steady_clock::now();
-            if (now - lastUpdate >= updateInterval) {
-                // Update all components
-                sensorManager.update();
+        // Rate groups. Phases spread the slow groups across base ticks;
+        // only critical tasks survive when the loop runs over budget.
+        using std::chrono::microseconds;
+        using State = state::StateMachine::State;
+        runtime::TaskScheduler scheduler(BASE_RATE_HZ);
+
+        // Taken once per tick, right after the IMU update, and read by every
+        // later task in the tick. All tasks run on the executive's thread,
+        // so it needs no lock of its own.
+        sensors::SensorSnapshot snapshot;
+
+        scheduler.addTask({"imu", 1000, 0, 0, microseconds(300), true,
+            [&](const runtime::TaskScheduler::TaskContext& ctx) {
+                sensorManager.updateIMU();
+                snapshot = sensorManager.snapshot(ctx.nowNs);
+            }});
+        scheduler.addTask({"attitude", 500, 0, 1, microseconds(200), true,
+            [&](const runtime::TaskScheduler::TaskContext& ctx) {
+                if (stateMachine.getState() == State::FLYING) {
+                    flightController.updateAttitude(snapshot, ctx.dt);
+                }
+            }});
+        // One PWM frame per servo period, right after an attitude update
+        scheduler.addTask({"outputs", control::PWMController::FRAME_RATE_HZ, 0, 1, microseconds(200), true,
+            [&](const runtime::TaskScheduler::TaskContext&) {
+                flightController.commitOutputs();
+            }});
+        scheduler.addTask({"altitude", 50, 1, 2, microseconds(200), true,
+            [&](const runtime::TaskScheduler::TaskContext& ctx) {
+                if (stateMachine.getState() == State::FLYING) {
+                    flightController.updateAltitude(snapshot, ctx.dt);
+                }
+            }});
+        scheduler.addTask({"state", 50, 5, 3, microseconds(100), true,
+            [&](const runtime::TaskScheduler::TaskContext&) {
+                stateMachine.update(snapshot);
+            }});
+        scheduler.addTask({"gps", 20, 3, 4, microseconds(50), false,
+            [&](const runtime::TaskScheduler::TaskContext&) {
+                sensorManager.updateGPS();
+            }});
+        scheduler.addTask({"ultrasonic", 20, 7, 5, microseconds(100), false,
+            [&](const runtime::TaskScheduler::TaskContext& ctx) {
+                sensorManager.updateUltrasonic(ctx.nowNs);
+            }});
+        scheduler.addTask({"battery", 10, 13, 6, microseconds(100), false,
+            [&](const runtime::TaskScheduler::TaskContext&) {
+                sensorManager.updateBatteryVoltage();
+            }});
+        scheduler.addTask({"link", 50, 11, 7, microseconds(100), false,
+            [&](const runtime::TaskScheduler::TaskContext&) {
                 commManager.update();
-                stateMachine.update();
-
-                lastUpdate = now;
+            }});
+        scheduler.addTask({"telemetry", 20, 17, 8, microseconds(200), false,
+            [&](const runtime::TaskScheduler::TaskContext&) {
+                commManager.sendTelemetry();
+            }});
+        scheduler.addTask({"heartbeat", 10, 23, 9, microseconds(100), false,
+            [&](const runtime::TaskScheduler::TaskContext&) {
+                commManager.sendHeartbeat();
+            }});
+        scheduler.addTask({"spectrum", 10, 29, 10, microseconds(100), false,
+            [&, axis = size_t(0)](const runtime::TaskScheduler::TaskContext&) mutable {
+                // One gyro axis per run
+                commManager.sendSpectrum(sensorManager.getSpectrumData(axis));
+                axis = (axis + 1) % filters::SpectrumAnalyzer::AXES;
+            }});
+
+        // Base tick on absolute deadlines
+        runtime::RealTimeExecutive::Options rtOptions;
+        rtOptions.period = std::chrono::nanoseconds(1000000000LL / BASE_RATE_HZ);
+        rtOptions.priority = config.rt_priority;
+        rtOptions.cpu = config.rt_cpu;
+        rtOptions.lockMemory = config.rt_lock_memory;
+        rtOptions.prefaultStackBytes = 256 * 1024;
+        rtOptions.reportInterval = std::chrono::seconds(10);
+
+        // The geofence grid is rasterized around home, which the first GPS
+        // fix sets. Building allocates and takes milliseconds, so it runs
+        // here rather than in a control task; the state task checks against
+        // it once it is published.
+        std::thread geofenceBuilder([&]() {
+            if (!geofence.hasZones()) return;
+            while (running && !sensorManager.getLocalFrame().hasOrigin()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            if (running && geofence.build(sensorManager.getLocalFrame())) {
+                const auto& stats = geofence.getStatistics();
+                std::cout << "Geofence: " << stats.columns << "x" << stats.rows << " cells of "
+                          << stats.cellSize << " m, " << stats.boundaryCells << " on the boundary"
+                          << std::endl;
             }
+        });
 
-            // Small sleep to prevent busy waiting
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
+        runtime::RealTimeExecutive executive(rtOptions);
+        executive.configure();
+        executive.run([]() { return running != 0; }, [&]() {
+            scheduler.runTick();
+        });
+        running = 0;
+        geofenceBuilder.join();
 
         // Graceful shutdown
         std::cout << "Shutting down..." << std::endl;
+        executive.report(std::cout);
+        scheduler.report(std::cout);
+        flightController.report(std::cout);
+        sensorManager.report(std::cout);
         commManager.stop();
         flightController.stop();
         sensorManager.stop();
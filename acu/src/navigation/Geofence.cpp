@@ -0,0 +1,339 @@
+#include "navigation/Geofence.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+namespace drone {
+namespace navigation {
+
+namespace {
+    // Largest overestimate of Euclidean distance by the 5/7 chamfer
+    constexpr float CHAMFER_ERROR = 1.08f;
+    constexpr float HALF_DIAGONAL = 0.7072f;
+
+    float segmentDistance(float px, float py, float ax, float ay, float bx, float by) {
+        const float dx = bx - ax;
+        const float dy = by - ay;
+        const float lengthSquared = dx * dx + dy * dy;
+        float t = lengthSquared > 0.0f ? ((px - ax) * dx + (py - ay) * dy) / lengthSquared : 0.0f;
+        t = std::max(0.0f, std::min(1.0f, t));
+        const float ex = ax + t * dx - px;
+        const float ey = ay + t * dy - py;
+        return std::sqrt(ex * ex + ey * ey);
+    }
+}
+
+Geofence::Geofence()
+    : inclusionZones_(0)
+    , exclusionZones_(0)
+    , built_(false)
+    , minEast_(0.0f)
+    , minNorth_(0.0f)
+    , cellSize_(MIN_CELL_SIZE)
+    , columns_(0)
+    , rows_(0) {
+}
+
+bool Geofence::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Failed to open geofence file " << path << std::endl;
+        return false;
+    }
+
+    bool inZone = false;
+    ZoneType type = ZoneType::INCLUSION;
+    std::vector<Vertex> vertices;
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(file, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string first;
+        if (!(fields >> first)) {
+            continue;
+        }
+
+        if (first == "inclusion" || first == "exclusion") {
+            if (inZone && !addZone(type, vertices)) {
+                std::cerr << path << ":" << lineNumber << ": invalid zone before this line" << std::endl;
+                return false;
+            }
+            type = first == "inclusion" ? ZoneType::INCLUSION : ZoneType::EXCLUSION;
+            vertices.clear();
+            inZone = true;
+            continue;
+        }
+
+        Vertex vertex;
+        std::istringstream values(line);
+        if (!inZone || !(values >> vertex.latitude >> vertex.longitude)) {
+            std::cerr << path << ":" << lineNumber << ": expected a zone type or a vertex" << std::endl;
+            return false;
+        }
+        vertices.push_back(vertex);
+    }
+
+    if (inZone && !addZone(type, vertices)) {
+        std::cerr << path << ": invalid final zone" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Geofence::addZone(ZoneType type, const std::vector<Vertex>& vertices) {
+    if (zones_.size() >= MAX_ZONES || vertices.size() < 3 || vertices.size() > MAX_VERTICES) {
+        return false;
+    }
+    for (const Vertex& vertex : vertices) {
+        if (std::fabs(vertex.latitude) > 90.0 || std::fabs(vertex.longitude) > 180.0) {
+            return false;
+        }
+    }
+
+    const uint32_t bit = 1u << zones_.size();
+    if (type == ZoneType::INCLUSION) {
+        inclusionZones_ |= bit;
+    } else {
+        exclusionZones_ |= bit;
+    }
+    zones_.push_back({type, vertices});
+    return true;
+}
+
+bool Geofence::build(const geodesy::LocalFrame& frame) {
+    // The grid is published once; check() may be reading it from here on
+    if (built_.load(std::memory_order_acquire)) {
+        return true;
+    }
+    if (zones_.empty() || !frame.hasOrigin()) {
+        return false;
+    }
+
+    // Zones into ENU edges, each closing back to its first vertex
+    edges_.clear();
+    float minEast = INFINITY, minNorth = INFINITY, maxEast = -INFINITY, maxNorth = -INFINITY;
+    for (size_t z = 0; z < zones_.size(); ++z) {
+        const std::vector<Vertex>& vertices = zones_[z].vertices;
+        for (size_t v = 0; v < vertices.size(); ++v) {
+            const Vertex& a = vertices[v];
+            const Vertex& b = vertices[(v + 1) % vertices.size()];
+            geodesy::Enu pa = frame.toEnu(a.latitude, a.longitude, 0.0f);
+            geodesy::Enu pb = frame.toEnu(b.latitude, b.longitude, 0.0f);
+            edges_.push_back({pa.east, pa.north, pb.east, pb.north, 1u << z});
+
+            minEast = std::min(minEast, pa.east);
+            maxEast = std::max(maxEast, pa.east);
+            minNorth = std::min(minNorth, pa.north);
+            maxNorth = std::max(maxNorth, pa.north);
+        }
+    }
+
+    // Fit the fence and a margin into the grid at the finest cell allowed
+    const float extent = std::max(maxEast - minEast, maxNorth - minNorth);
+    cellSize_ = std::max(MIN_CELL_SIZE, extent / (MAX_GRID_SIDE - 2 * MARGIN_CELLS - 1));
+    columns_ = static_cast<size_t>((maxEast - minEast) / cellSize_) + 2 * MARGIN_CELLS + 1;
+    rows_ = static_cast<size_t>((maxNorth - minNorth) / cellSize_) + 2 * MARGIN_CELLS + 1;
+    minEast_ = minEast - MARGIN_CELLS * cellSize_;
+    minNorth_ = minNorth - MARGIN_CELLS * cellSize_;
+    cells_.assign(columns_ * rows_, 0);
+
+    // Register each edge with every cell it passes within one cell of, so a
+    // point in a cell sees all edges closer than cellSize_. Measured from
+    // the center this takes in a few extra cells, which is harmless.
+    std::vector<std::pair<uint32_t, uint32_t>> registrations;
+    const float reach = cellSize_ * (1.0f + HALF_DIAGONAL);
+    for (size_t k = 0; k < edges_.size(); ++k) {
+        const Edge& edge = edges_[k];
+        const size_t i0 = static_cast<size_t>(std::max(0.0f, (std::min(edge.ax, edge.bx) - reach - minEast_) / cellSize_));
+        const size_t i1 = std::min(columns_ - 1, static_cast<size_t>((std::max(edge.ax, edge.bx) + reach - minEast_) / cellSize_));
+        const size_t j0 = static_cast<size_t>(std::max(0.0f, (std::min(edge.ay, edge.by) - reach - minNorth_) / cellSize_));
+        const size_t j1 = std::min(rows_ - 1, static_cast<size_t>((std::max(edge.ay, edge.by) + reach - minNorth_) / cellSize_));
+        for (size_t j = j0; j <= j1; ++j) {
+            for (size_t i = i0; i <= i1; ++i) {
+                const float cx = minEast_ + (i + 0.5f) * cellSize_;
+                const float cy = minNorth_ + (j + 0.5f) * cellSize_;
+                if (segmentDistance(cx, cy, edge.ax, edge.ay, edge.bx, edge.by) <= reach) {
+                    registrations.emplace_back(static_cast<uint32_t>(j * columns_ + i),
+                                               static_cast<uint32_t>(k));
+                }
+            }
+        }
+    }
+    std::sort(registrations.begin(), registrations.end());
+
+    boundary_.clear();
+    cellEdges_.clear();
+    for (size_t r = 0; r < registrations.size(); ++r) {
+        const uint32_t cell = registrations[r].first;
+        if (r == 0 || registrations[r - 1].first != cell) {
+            cells_[cell] = CELL_BOUNDARY | static_cast<uint32_t>(boundary_.size());
+            boundary_.push_back({0, static_cast<uint32_t>(cellEdges_.size()), 0});
+        }
+        cellEdges_.push_back(registrations[r].second);
+        boundary_.back().edgeCount++;
+    }
+
+    // Zone membership of every cell center, one sweep per row: toggle a
+    // zone's bit at each of its edges crossing the row, left to right
+    std::vector<std::pair<float, uint32_t>> crossings;
+    for (size_t j = 0; j < rows_; ++j) {
+        const float y = minNorth_ + (j + 0.5f) * cellSize_;
+        crossings.clear();
+        for (const Edge& edge : edges_) {
+            if ((edge.ay > y) != (edge.by > y)) {
+                crossings.emplace_back(edge.ax + (y - edge.ay) * (edge.bx - edge.ax) / (edge.by - edge.ay),
+                                       edge.zoneBit);
+            }
+        }
+        std::sort(crossings.begin(), crossings.end());
+
+        uint32_t zones = 0;
+        size_t next = 0;
+        for (size_t i = 0; i < columns_; ++i) {
+            const float x = minEast_ + (i + 0.5f) * cellSize_;
+            while (next < crossings.size() && crossings[next].first < x) {
+                zones ^= crossings[next++].second;
+            }
+
+            uint32_t& word = cells_[j * columns_ + i];
+            if (word & CELL_BOUNDARY) {
+                boundary_[word & CELL_VALUE].centerZones = zones;
+            } else if (allowed(zones)) {
+                word = CELL_ALLOWED;
+            }
+        }
+    }
+
+    // Two-pass chamfer transform: distance from each cell to the nearest
+    // boundary cell, in fifths of a cell
+    std::vector<uint32_t> distance(cells_.size(), CELL_VALUE);
+    for (size_t c = 0; c < cells_.size(); ++c) {
+        if (cells_[c] & CELL_BOUNDARY) {
+            distance[c] = 0;
+        }
+    }
+    auto relax = [&](size_t c, size_t i, size_t j, long di, long dj, uint32_t weight) {
+        const long ni = static_cast<long>(i) + di;
+        const long nj = static_cast<long>(j) + dj;
+        if (ni < 0 || nj < 0 || ni >= static_cast<long>(columns_) || nj >= static_cast<long>(rows_)) {
+            return;
+        }
+        distance[c] = std::min(distance[c], distance[nj * columns_ + ni] + weight);
+    };
+    for (size_t j = 0; j < rows_; ++j) {
+        for (size_t i = 0; i < columns_; ++i) {
+            const size_t c = j * columns_ + i;
+            relax(c, i, j, -1, 0, CHAMFER_STRAIGHT);
+            relax(c, i, j, 0, -1, CHAMFER_STRAIGHT);
+            relax(c, i, j, -1, -1, CHAMFER_DIAGONAL);
+            relax(c, i, j, 1, -1, CHAMFER_DIAGONAL);
+        }
+    }
+    for (size_t j = rows_; j-- > 0;) {
+        for (size_t i = columns_; i-- > 0;) {
+            const size_t c = j * columns_ + i;
+            relax(c, i, j, 1, 0, CHAMFER_STRAIGHT);
+            relax(c, i, j, 0, 1, CHAMFER_STRAIGHT);
+            relax(c, i, j, 1, 1, CHAMFER_DIAGONAL);
+            relax(c, i, j, -1, 1, CHAMFER_DIAGONAL);
+        }
+    }
+    for (size_t c = 0; c < cells_.size(); ++c) {
+        if (!(cells_[c] & CELL_BOUNDARY)) {
+            cells_[c] |= std::min(distance[c], CELL_VALUE);
+        }
+    }
+
+    stats_.columns = columns_;
+    stats_.rows = rows_;
+    stats_.cellSize = cellSize_;
+    stats_.boundaryCells = boundary_.size();
+    built_.store(true, std::memory_order_release);
+    return true;
+}
+
+Geofence::Status Geofence::check(float east, float north) const {
+    Status status;
+    if (!built_.load(std::memory_order_acquire)) {
+        return status;
+    }
+    stats_.checks++;
+
+    const float fx = (east - minEast_) / cellSize_;
+    const float fy = (north - minNorth_) / cellSize_;
+
+    // Beyond the grid: every edge is at least the margin further in
+    if (!(fx >= 0.0f && fy >= 0.0f && fx < columns_ && fy < rows_)) {
+        const float dx = std::max(0.0f, std::max(-fx, fx - columns_));
+        const float dy = std::max(0.0f, std::max(-fy, fy - rows_));
+        status.inside = allowed(0);
+        status.distance = (std::sqrt(dx * dx + dy * dy) + MARGIN_CELLS) * cellSize_;
+        return status;
+    }
+
+    const size_t i = static_cast<size_t>(fx);
+    const size_t j = static_cast<size_t>(fy);
+    const uint32_t word = cells_[j * columns_ + i];
+
+    if (!(word & CELL_BOUNDARY)) {
+        // The nearest edge lies in a boundary cell; take off both half
+        // diagonals and the chamfer error for a bound that never overshoots
+        const float cells = (word & CELL_VALUE) / (CHAMFER_STRAIGHT * CHAMFER_ERROR) - 2.0f * HALF_DIAGONAL;
+        status.inside = (word & CELL_ALLOWED) != 0;
+        status.distance = std::max(1.0f, cells) * cellSize_;
+        return status;
+    }
+
+    // Walk from the cell center to the point, first along the center's row
+    // (the same crossing rule the build sweep used) and then along the
+    // point's column, flipping a zone at each of its edges crossed. Only
+    // edges registered to this cell can cross inside it.
+    stats_.exactChecks++;
+    const BoundaryCell& cell = boundary_[word & CELL_VALUE];
+    const float cx = minEast_ + (i + 0.5f) * cellSize_;
+    const float cy = minNorth_ + (j + 0.5f) * cellSize_;
+    uint32_t zones = cell.centerZones;
+
+    for (uint32_t e = 0; e < cell.edgeCount; ++e) {
+        const Edge& edge = edges_[cellEdges_[cell.firstEdge + e]];
+        if ((edge.ay > cy) != (edge.by > cy)) {
+            const float x = edge.ax + (cy - edge.ay) * (edge.bx - edge.ax) / (edge.by - edge.ay);
+            if ((x < east) != (x < cx)) {
+                zones ^= edge.zoneBit;
+            }
+        }
+        if ((edge.ax > east) != (edge.bx > east)) {
+            const float y = edge.ay + (east - edge.ax) * (edge.by - edge.ay) / (edge.bx - edge.ax);
+            if ((y < north) != (y < cy)) {
+                zones ^= edge.zoneBit;
+            }
+        }
+    }
+
+    status.inside = allowed(zones);
+    status.distance = edgeDistance(cell, east, north);
+    return status;
+}
+
+bool Geofence::allowed(uint32_t zones) const {
+    return (inclusionZones_ == 0 || (zones & inclusionZones_) != 0) &&
+           (zones & exclusionZones_) == 0;
+}
+
+float Geofence::edgeDistance(const BoundaryCell& cell, float east, float north) const {
+    float nearest = INFINITY;
+    for (uint32_t e = 0; e < cell.edgeCount; ++e) {
+        const Edge& edge = edges_[cellEdges_[cell.firstEdge + e]];
+        nearest = std::min(nearest, segmentDistance(east, north, edge.ax, edge.ay, edge.bx, edge.by));
+    }
+    return nearest;
+}
+
+} // namespace navigation
+} // namespace drone
@@ -0,0 +1,183 @@
+#include "runtime/RealTimeExecutive.hpp"
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <errno.h>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace drone {
+namespace runtime {
+
+namespace {
+    constexpr int64_t NANOSECONDS_PER_SECOND = 1000000000LL;
+}
+
+RealTimeExecutive::RealTimeExecutive(const Options& options)
+    : options_(options)
+    , cycles_(0)
+    , overruns_(0)
+    , minLatencyNs_(std::numeric_limits<int64_t>::max())
+    , maxLatencyNs_(0)
+    , totalLatencyNs_(0)
+    , maxExecutionNs_(0) {
+}
+
+bool RealTimeExecutive::configure() {
+    bool ok = true;
+
+    if (options_.lockMemory) {
+        // No page faults in the loop once running
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            std::cerr << "mlockall failed: " << strerror(errno) << std::endl;
+            ok = false;
+        }
+    }
+
+    if (options_.prefaultStackBytes > 0) {
+        prefaultStack(options_.prefaultStackBytes);
+    }
+
+    if (options_.cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(options_.cpu, &cpus);
+        int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (rc != 0) {
+            std::cerr << "Failed to pin control thread to CPU " << options_.cpu
+                      << ": " << strerror(rc) << std::endl;
+            ok = false;
+        }
+    }
+
+    if (options_.priority > 0) {
+        struct sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        param.sched_priority = options_.priority;
+        int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (rc != 0) {
+            std::cerr << "Failed to set SCHED_FIFO priority " << options_.priority
+                      << ": " << strerror(rc) << std::endl;
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+void RealTimeExecutive::run(const std::function<bool()>& keepRunning,
+                            const std::function<void()>& cycle) {
+    const int64_t periodNs = options_.period.count();
+    const int64_t reportNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        options_.reportInterval).count();
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    int64_t nextReportNs = toNanoseconds(deadline) + reportNs;
+
+    while (keepRunning()) {
+        addNanoseconds(deadline, periodNs);
+
+        // Absolute sleep: restarting after a signal keeps the same deadline
+        int rc;
+        do {
+            rc = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr);
+        } while (rc == EINTR && keepRunning());
+
+        struct timespec wake;
+        clock_gettime(CLOCK_MONOTONIC, &wake);
+
+        cycle();
+
+        struct timespec done;
+        clock_gettime(CLOCK_MONOTONIC, &done);
+
+        const int64_t deadlineNs = toNanoseconds(deadline);
+        const int64_t wakeNs = toNanoseconds(wake);
+        const int64_t doneNs = toNanoseconds(done);
+        recordCycle(wakeNs - deadlineNs, doneNs - wakeNs);
+
+        // Overran one or more deadlines: drop the missed slots instead of
+        // running a burst of back-to-back cycles to catch up
+        if (doneNs >= deadlineNs + periodNs) {
+            int64_t missed = (doneNs - deadlineNs) / periodNs;
+            overruns_.fetch_add(1, std::memory_order_relaxed);
+            addNanoseconds(deadline, missed * periodNs);
+        }
+
+        if (reportNs > 0 && doneNs >= nextReportNs) {
+            report(std::cout);
+            nextReportNs = doneNs + reportNs;
+        }
+    }
+}
+
+RealTimeExecutive::Statistics RealTimeExecutive::getStatistics() const {
+    Statistics stats;
+    stats.cycles = cycles_.load(std::memory_order_relaxed);
+    stats.overruns = overruns_.load(std::memory_order_relaxed);
+    stats.maxLatencyNs = maxLatencyNs_.load(std::memory_order_relaxed);
+    stats.maxExecutionNs = maxExecutionNs_.load(std::memory_order_relaxed);
+    if (stats.cycles > 0) {
+        stats.minLatencyNs = minLatencyNs_.load(std::memory_order_relaxed);
+        stats.meanLatencyNs = totalLatencyNs_.load(std::memory_order_relaxed) /
+                              static_cast<int64_t>(stats.cycles);
+    }
+    return stats;
+}
+
+void RealTimeExecutive::resetStatistics() {
+    cycles_ = 0;
+    overruns_ = 0;
+    minLatencyNs_ = std::numeric_limits<int64_t>::max();
+    maxLatencyNs_ = 0;
+    totalLatencyNs_ = 0;
+    maxExecutionNs_ = 0;
+}
+
+void RealTimeExecutive::report(std::ostream& out) const {
+    Statistics stats = getStatistics();
+    out << "Control loop: " << stats.cycles << " cycles, "
+        << stats.overruns << " overruns, wake-up latency min/avg/max "
+        << stats.minLatencyNs / 1000 << "/"
+        << stats.meanLatencyNs / 1000 << "/"
+        << stats.maxLatencyNs / 1000 << " us, max execution "
+        << stats.maxExecutionNs / 1000 << " us" << std::endl;
+}
+
+void RealTimeExecutive::recordCycle(int64_t latencyNs, int64_t executionNs) {
+    // Single writer, so plain load/store is enough for the extrema
+    cycles_.fetch_add(1, std::memory_order_relaxed);
+    totalLatencyNs_.fetch_add(latencyNs, std::memory_order_relaxed);
+    if (latencyNs < minLatencyNs_.load(std::memory_order_relaxed)) {
+        minLatencyNs_.store(latencyNs, std::memory_order_relaxed);
+    }
+    if (latencyNs > maxLatencyNs_.load(std::memory_order_relaxed)) {
+        maxLatencyNs_.store(latencyNs, std::memory_order_relaxed);
+    }
+    if (executionNs > maxExecutionNs_.load(std::memory_order_relaxed)) {
+        maxExecutionNs_.store(executionNs, std::memory_order_relaxed);
+    }
+}
+
+__attribute__((noinline)) void RealTimeExecutive::prefaultStack(size_t bytes) {
+    // Touch each page so later stack growth does not fault in the loop
+    volatile unsigned char* stack = static_cast<volatile unsigned char*>(__builtin_alloca(bytes));
+    for (size_t i = 0; i < bytes; i += 4096) {
+        stack[i] = 0;
+    }
+}
+
+void RealTimeExecutive::addNanoseconds(struct timespec& ts, int64_t ns) {
+    int64_t total = ts.tv_nsec + ns;
+    ts.tv_sec += total / NANOSECONDS_PER_SECOND;
+    ts.tv_nsec = total % NANOSECONDS_PER_SECOND;
+}
+
+int64_t RealTimeExecutive::toNanoseconds(const struct timespec& ts) {
+    return static_cast<int64_t>(ts.tv_sec) * NANOSECONDS_PER_SECOND + ts.tv_nsec;
+}
+
+} // namespace runtime
+} // namespace drone
@@ -0,0 +1,107 @@
+#include "runtime/TaskScheduler.hpp"
+#include "runtime/Clock.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace drone {
+namespace runtime {
+
+TaskScheduler::TaskScheduler(uint32_t baseRateHz)
+    : baseRateHz_(baseRateHz)
+    , basePeriodNs_(1000000000LL / baseRateHz)
+    , tick_(0)
+    , shedTicksRemaining_(0) {
+}
+
+bool TaskScheduler::addTask(const TaskConfig& config) {
+    if (config.rateHz == 0 || config.rateHz > baseRateHz_ || baseRateHz_ % config.rateHz != 0) {
+        std::cerr << "Task " << config.name << ": " << config.rateHz
+                  << "Hz does not divide the " << baseRateHz_ << "Hz base rate" << std::endl;
+        return false;
+    }
+
+    Task task;
+    task.config = config;
+    task.divider = baseRateHz_ / config.rateHz;
+    task.config.phase = config.phase % task.divider;
+    task.lastRunNs = 0;
+    task.stats.name = config.name;
+    task.stats.rateHz = config.rateHz;
+
+    // Keep the run order deterministic: priority, then faster groups first,
+    // then registration order
+    auto pos = std::find_if(tasks_.begin(), tasks_.end(), [&](const Task& other) {
+        if (other.config.priority != config.priority) {
+            return other.config.priority > config.priority;
+        }
+        return other.config.rateHz < config.rateHz;
+    });
+    tasks_.insert(pos, task);
+    return true;
+}
+
+void TaskScheduler::runTick() {
+    const int64_t tickStart = monotonicNanoseconds();
+    const int64_t shedAfter = tickStart + static_cast<int64_t>(basePeriodNs_ * SHED_THRESHOLD);
+    const bool shedding = shedTicksRemaining_ > 0;
+
+    for (auto& task : tasks_) {
+        if ((tick_ + task.divider - task.config.phase) % task.divider != 0) {
+            continue;
+        }
+
+        int64_t start = monotonicNanoseconds();
+        if (!task.config.critical && (shedding || start > shedAfter)) {
+            task.stats.shed++;
+            continue;
+        }
+
+        TaskContext context;
+        context.tick = tick_;
+        context.nowNs = start;
+        context.period = 1.0f / task.config.rateHz;
+        context.dt = task.lastRunNs == 0 ? context.period : (start - task.lastRunNs) * 1e-9f;
+        task.lastRunNs = start;
+
+        task.config.function(context);
+
+        int64_t execution = monotonicNanoseconds() - start;
+        task.stats.runs++;
+        task.stats.maxExecutionNs = std::max(task.stats.maxExecutionNs, execution);
+        if (execution > std::chrono::duration_cast<std::chrono::nanoseconds>(
+                task.config.budget).count()) {
+            task.stats.budgetOverruns++;
+        }
+    }
+
+    // An overrunning tick sheds non-critical groups for a while so the
+    // critical ones can catch up
+    if (monotonicNanoseconds() - tickStart > basePeriodNs_) {
+        shedTicksRemaining_ = SHED_HOLD_TICKS;
+    } else if (shedTicksRemaining_ > 0) {
+        shedTicksRemaining_--;
+    }
+
+    tick_++;
+}
+
+std::vector<TaskScheduler::TaskStatistics> TaskScheduler::getStatistics() const {
+    std::vector<TaskStatistics> stats;
+    stats.reserve(tasks_.size());
+    for (const auto& task : tasks_) {
+        stats.push_back(task.stats);
+    }
+    return stats;
+}
+
+void TaskScheduler::report(std::ostream& out) const {
+    for (const auto& task : tasks_) {
+        out << "Task " << task.stats.name << " @" << task.stats.rateHz << "Hz: "
+            << task.stats.runs << " runs, " << task.stats.shed << " shed, "
+            << task.stats.budgetOverruns << " over budget, max "
+            << task.stats.maxExecutionNs / 1000 << " us" << std::endl;
+    }
+}
+
+} // namespace runtime
+} // namespace drone
@@ -0,0 +1,109 @@
+#include "runtime/Topic.hpp"
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+#include <iostream>
+
+namespace drone {
+namespace runtime {
+
+TopicNotifier::TopicNotifier() : attached_(0) {}
+
+TopicNotifier::~TopicNotifier() {
+    for (auto& waiter : waiters_) {
+        if (waiter.fd >= 0) {
+            ::close(waiter.fd);
+        }
+    }
+}
+
+int TopicNotifier::attach() {
+    for (size_t i = 0; i < MAX_WAITERS; ++i) {
+        Waiter& waiter = waiters_[i];
+        bool expected = false;
+        if (!waiter.claimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            continue;
+        }
+
+        if (waiter.fd < 0) {
+            waiter.fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            if (waiter.fd < 0) {
+                std::cerr << "Failed to create eventfd: " << strerror(errno) << std::endl;
+                waiter.claimed.store(false, std::memory_order_release);
+                return -1;
+            }
+        } else {
+            // Left over from the previous owner
+            uint64_t value;
+            while (::read(waiter.fd, &value, sizeof(value)) > 0) {}
+        }
+        waiter.pending.store(false, std::memory_order_relaxed);
+
+        waiter.active.store(true, std::memory_order_release);
+        attached_.fetch_add(1, std::memory_order_release);
+        return static_cast<int>(i);
+    }
+    std::cerr << "No free topic notification slot" << std::endl;
+    return -1;
+}
+
+void TopicNotifier::detach(int waiter) {
+    if (waiter < 0 || static_cast<size_t>(waiter) >= MAX_WAITERS) return;
+
+    waiters_[waiter].active.store(false, std::memory_order_release);
+    attached_.fetch_sub(1, std::memory_order_release);
+    waiters_[waiter].claimed.store(false, std::memory_order_release);
+}
+
+int TopicNotifier::fd(int waiter) const {
+    if (waiter < 0 || static_cast<size_t>(waiter) >= MAX_WAITERS) return -1;
+    return waiters_[waiter].fd;
+}
+
+void TopicNotifier::notify() {
+    if (attached_.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+
+    // Orders the publish before the pending checks, against the fence in
+    // arm(): either the waiter sees the new message or this sees it armed
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const uint64_t one = 1;
+    for (auto& waiter : waiters_) {
+        if (waiter.active.load(std::memory_order_acquire) &&
+            !waiter.pending.exchange(true, std::memory_order_relaxed)) {
+            // Only fails when the counter is saturated, which still wakes
+            // the reader
+            ssize_t written = ::write(waiter.fd, &one, sizeof(one));
+            (void)written;
+        }
+    }
+}
+
+void TopicNotifier::arm(int waiter) {
+    if (waiter < 0 || static_cast<size_t>(waiter) >= MAX_WAITERS) return;
+
+    waiters_[waiter].pending.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+bool TopicNotifier::wait(int waiter, int timeoutMs) const {
+    const int waitFd = fd(waiter);
+    if (waitFd < 0) return false;
+
+    struct pollfd pfd = {waitFd, POLLIN, 0};
+    int ready = poll(&pfd, 1, timeoutMs);
+    if (ready <= 0) {
+        return false;
+    }
+
+    uint64_t value;
+    ssize_t drained = ::read(waitFd, &value, sizeof(value));
+    return drained > 0;
+}
+
+} // namespace runtime
+} // namespace drone
@@ -1,40 +1,53 @@
 #include "sensors/GPS.hpp"
-#include <fcntl.h>
-#include <termios.h>
-#include <unistd.h>
-#include <sstream>
-#include <vector>
-#include <cstring>
+#include "runtime/Clock.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
 
 namespace drone {
 namespace sensors {
 
 namespace {
-    std::vector<std::string> split(const std::string& str, char delim) {
-        std::vector<std::string> tokens;
-        std::stringstream ss(str);
-        std::string token;
-        while (std::getline(ss, token, delim)) {
-            tokens.push_back(token);
-        }
-        return tokens;
+    void writeU16(uint8_t* p, uint16_t value) {
+        p[0] = static_cast<uint8_t>(value);
+        p[1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    void writeU32(uint8_t* p, uint32_t value) {
+        writeU16(p, static_cast<uint16_t>(value));
+        writeU16(p + 2, static_cast<uint16_t>(value >> 16));
     }
+
+    // CFG-PRT
+    constexpr uint8_t PORT_UART1 = 1;
+    constexpr uint32_t PORT_MODE_8N1 = 0x000008D0;
+    constexpr uint16_t PROTO_UBX = 0x0001;
+    constexpr uint16_t PROTO_NMEA = 0x0002;
+
+    // u-blox 7 receivers navigate at up to 10Hz
+    constexpr uint32_t MAX_NAV_RATE_HZ = 10;
 }
 
-GPS::GPS(const std::string& device)
-    : devicePath_(device), serialFd_(-1) {}
+GPS::GPS(const std::string& device, Protocol protocol, uint32_t navRateHz)
+    : serial_(device)
+    , protocol_(protocol)
+    , navRateHz_(std::max(1u, std::min(navRateHz, MAX_NAV_RATE_HZ)))
+    , parseNs_(0)
+    , sequence_(0)
+    , configuring_(false) {}
 
 GPS::~GPS() {
     stop();
-    closeSerial();
+    serial_.close();
 }
 
 bool GPS::init() {
-    return openSerial();
+    return openReceiver();
 }
 
 void GPS::start() {
     if (!running_) {
+        stopping_ = false;
         running_ = true;
         readThread_ = std::make_unique<std::thread>(&GPS::readLoop, this);
     }
@@ -42,7 +55,9 @@ void GPS::start() {
 
 void GPS::stop() {
     if (running_) {
+        stopping_ = true;
         running_ = false;
+        serial_.wake();
         if (readThread_ && readThread_->joinable()) {
             readThread_->join();
         }
@@ -50,163 +65,223 @@ void GPS::stop() {
 }
 
 GPS::GPSData GPS::getData() const {
-    std::lock_guard<std::mutex> lock(dataMutex_);
-    return data_;
+    // One attempt: the caller may be the real-time thread, and the read
+    // thread can be preempted mid-store. A miss reads as no fix this cycle.
+    GPSData data;
+    uint32_t version = 0;
+    if (!data_.tryLoad(data, version)) {
+        return GPSData();
+    }
+    return data;
 }
 
-bool GPS::openSerial() {
-    serialFd_ = open(devicePath_.c_str(), O_RDWR | O_NOCTTY);
-    if (serialFd_ < 0) {
-        return false;
+GPS::Statistics GPS::getStatistics() const {
+    Statistics stats;
+    uint32_t version = 0;
+    if (!statistics_.tryLoad(stats, version)) {
+        return Statistics();
     }
+    return stats;
+}
 
-    struct termios tty;
-    memset(&tty, 0, sizeof(tty));
-
-    if (tcgetattr(serialFd_, &tty) != 0) {
-        closeSerial();
-        return false;
+bool GPS::openReceiver() {
+    if (protocol_ == Protocol::NMEA) {
+        return serial_.open(NMEA_BAUD_RATE);
     }
+    return configureUblox();
+}
 
-    // Set baud rate (9600 for GT-U7)
-    cfsetospeed(&tty, B9600);
-    cfsetispeed(&tty, B9600);
-
-    // 8N1 mode
-    tty.c_cflag &= ~PARENB;
-    tty.c_cflag &= ~CSTOPB;
-    tty.c_cflag &= ~CSIZE;
-    tty.c_cflag |= CS8;
-
-    // No flow control
-    tty.c_cflag &= ~CRTSCTS;
+bool GPS::configureUblox() {
+    configuring_ = true;
+    bool configured = detectBaudRate();
+    if (!configured) {
+        std::cerr << "No GPS receiver answered at any baud rate" << std::endl;
+    }
 
-    // Enable receiver, ignore status lines
-    tty.c_cflag |= CREAD | CLOCAL;
+    if (configured) {
+        // UART1 to 115200 with UBX-only output. The receiver acknowledges at
+        // the old rate before switching, so the ACK is not waited for; the
+        // probe at the new rate confirms the change instead.
+        uint8_t port[20] = {};
+        port[0] = PORT_UART1;
+        writeU32(port + 4, PORT_MODE_8N1);
+        writeU32(port + 8, UBX_BAUD_RATE);
+        writeU16(port + 12, PROTO_UBX | PROTO_NMEA);
+        writeU16(port + 14, PROTO_UBX);
+        sendUbx(UbxParser::CLASS_CFG, UbxParser::CFG_PRT, port, sizeof(port));
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        configured = probe(UBX_BAUD_RATE);
+        if (!configured) {
+            std::cerr << "GPS receiver did not answer after switching to " << UBX_BAUD_RATE
+                      << " baud" << std::endl;
+        }
+    }
 
-    // Raw input
-    tty.c_lflag &= ~(ICANON | ECHO | ECHOE | ECHONL | ISIG);
+    if (configured) {
+        // Measurement period in ms, one navigation solution per measurement,
+        // aligned to UTC
+        uint8_t rate[6] = {};
+        writeU16(rate, static_cast<uint16_t>(1000 / navRateHz_));
+        writeU16(rate + 2, 1);
+        writeU16(rate + 4, 0);
+
+        // NAV-PVT on every solution on this port
+        uint8_t message[3] = {UbxParser::CLASS_NAV, UbxParser::NAV_PVT, 1};
+
+        configured =
+            sendUbxWithAck(UbxParser::CLASS_CFG, UbxParser::CFG_RATE, rate, sizeof(rate)) &&
+            sendUbxWithAck(UbxParser::CLASS_CFG, UbxParser::CFG_MSG, message, sizeof(message));
+        if (configured) {
+            std::cout << "GPS receiver sending NAV-PVT at " << navRateHz_ << " Hz, "
+                      << UBX_BAUD_RATE << " baud" << std::endl;
+        } else {
+            std::cerr << "GPS receiver rejected the navigation configuration" << std::endl;
+        }
+    }
 
-    // Raw output
-    tty.c_oflag &= ~OPOST;
+    configuring_ = false;
+    if (!configured) {
+        serial_.close();
+    }
+    return configured;
+}
 
-    // Set read timeout
-    tty.c_cc[VMIN] = 0;
-    tty.c_cc[VTIME] = 1;  // 0.1 seconds
+bool GPS::detectBaudRate() {
+    for (uint32_t baudRate : AUTOBAUD_RATES) {
+        if (stopping_) return false;
+        if (probe(baudRate)) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    if (tcsetattr(serialFd_, TCSANOW, &tty) != 0) {
-        closeSerial();
+bool GPS::probe(uint32_t baudRate) {
+    if (!serial_.open(baudRate)) {
         return false;
     }
-
-    return true;
+    serial_.flush();
+
+    // Any intact frame or sentence proves the rate; MON-VER is polled so a
+    // receiver with its periodic output turned off still answers
+    const uint64_t frames = ubx_.getStatistics().frames;
+    const uint64_t sentences = parser_.getStatistics().sentences;
+    sendUbx(UbxParser::CLASS_MON, UbxParser::MON_VER, nullptr, 0);
+    return pumpUntil(AUTOBAUD_TIMEOUT_MS, [&]() {
+        return ubx_.getStatistics().frames != frames ||
+               parser_.getStatistics().sentences != sentences;
+    });
 }
 
-void GPS::closeSerial() {
-    if (serialFd_ >= 0) {
-        close(serialFd_);
-        serialFd_ = -1;
-    }
+bool GPS::sendUbx(uint8_t messageClass, uint8_t messageId, const uint8_t* payload, uint16_t length) {
+    uint8_t frame[64];
+    size_t size = UbxParser::encode(messageClass, messageId, payload, length, frame, sizeof(frame));
+    return size > 0 && serial_.write(frame, size);
 }
 
-void GPS::readLoop() {
-    while (running_) {
-        std::string line = readLine();
-        if (!line.empty()) {
-            parseNMEA(line);
+bool GPS::sendUbxWithAck(uint8_t messageClass, uint8_t messageId, const uint8_t* payload,
+                         uint16_t length) {
+    for (int attempt = 0; attempt < CONFIG_ATTEMPTS && !stopping_; ++attempt) {
+        const uint64_t acks = ubx_.getStatistics().acks;
+        if (!sendUbx(messageClass, messageId, payload, length)) {
+            return false;
+        }
+
+        bool answered = pumpUntil(ACK_TIMEOUT_MS, [&]() {
+            const auto& ack = ubx_.getLastAck();
+            return ubx_.getStatistics().acks != acks && ack.messageClass == messageClass &&
+                   ack.messageId == messageId;
+        });
+        if (answered) {
+            return ubx_.getLastAck().accepted;
         }
     }
+    return false;
 }
 
-std::string GPS::readLine() {
-    std::string line;
-    char c;
-    while (running_ && serialFd_ >= 0) {
-        if (read(serialFd_, &c, 1) == 1) {
-            if (c == '\n') {
-                return line;
-            } else if (c != '\r') {
-                line += c;
+bool GPS::pumpUntil(int timeoutMs, const std::function<bool()>& done) {
+    const int64_t deadlineNs = runtime::monotonicNanoseconds() + timeoutMs * 1000000LL;
+    while (!stopping_ && serial_.isOpen()) {
+        int64_t remainingMs = (deadlineNs - runtime::monotonicNanoseconds()) / 1000000;
+        if (remainingMs <= 0) {
+            return false;
+        }
+        if (serial_.fill(static_cast<int>(remainingMs)) > 0) {
+            consumeInput();
+            if (done()) {
+                return true;
             }
         }
     }
-    return line;
+    return false;
 }
 
-void GPS::parseNMEA(const std::string& sentence) {
-    if (sentence.empty() || sentence[0] != '$') {
-        return;
-    }
-
-    // Calculate checksum
-    size_t asterisk = sentence.find('*');
-    if (asterisk == std::string::npos || asterisk + 3 >= sentence.length()) {
-        return;
-    }
-
-    uint8_t checksum = 0;
-    for (size_t i = 1; i < asterisk; ++i) {
-        checksum ^= sentence[i];
+bool GPS::consumeInput() {
+    uint8_t buffer[READ_CHUNK];
+    int64_t arrival[READ_CHUNK];
+
+    const int64_t startNs = runtime::monotonicNanoseconds();
+    const bool nmea = protocol_ == Protocol::NMEA || configuring_;
+    const bool ubx = protocol_ == Protocol::UBX;
+    bool nmeaFix = false;
+    bool ubxFix = false;
+    while (size_t count = serial_.read(buffer, READ_CHUNK, arrival)) {
+        if (nmea) nmeaFix |= parser_.feed(buffer, arrival, count);
+        if (ubx) ubxFix |= ubx_.feed(buffer, arrival, count);
     }
 
-    char expectedChecksum[3];
-    sprintf(expectedChecksum, "%02X", checksum);
-    if (sentence.substr(asterisk + 1, 2) != expectedChecksum) {
-        return;
+    bool published = false;
+    GPSData fix;
+    if (protocol_ == Protocol::UBX && ubxFix && !configuring_) {
+        fix = ubx_.getFix();
+        published = true;
+    } else if (protocol_ == Protocol::NMEA && nmeaFix) {
+        fix = parser_.getFix();
+        published = true;
     }
-
-    // Parse different sentence types
-    if (sentence.substr(3, 3) == "GGA") {
-        parseGGA(sentence);
-    } else if (sentence.substr(3, 3) == "RMC") {
-        parseRMC(sentence);
-    }
-}
-
-void GPS::parseGGA(const std::string& sentence) {
-    auto tokens = split(sentence, ',');
-    if (tokens.size() < 15) return;
-
-    std::lock_guard<std::mutex> lock(dataMutex_);
-    
-    // Parse fix quality
-    data_.fix = (tokens[6] != "0");
-    
-    // Parse position if we have a fix
-    if (data_.fix) {
-        data_.latitude = parseLatLon(tokens[2], tokens[3][0]);
-        data_.longitude = parseLatLon(tokens[4], tokens[5][0]);
-        data_.altitude = tokens[9].empty() ? 0 : std::stof(tokens[9]);
-        data_.satellites = tokens[7].empty() ? 0 : std::stoi(tokens[7]);
-        data_.hdop = tokens[8].empty() ? 0 : std::stof(tokens[8]);
+    if (published) {
+        fix.sequence = ++sequence_;
+        data_.store(fix);
     }
+    parseNs_ += runtime::monotonicNanoseconds() - startNs;
+
+    Statistics stats;
+    stats.serial = serial_.getStatistics();
+    stats.parser = parser_.getStatistics();
+    stats.ubx = ubx_.getStatistics();
+    stats.parseNs = parseNs_;
+    statistics_.store(stats);
+    return published;
 }
 
-void GPS::parseRMC(const std::string& sentence) {
-    auto tokens = split(sentence, ',');
-    if (tokens.size() < 12) return;
-
-    std::lock_guard<std::mutex> lock(dataMutex_);
-    
-    // Parse speed in knots and convert to m/s
-    if (!tokens[7].empty()) {
-        data_.speed = std::stof(tokens[7]) * 0.514444f;
-    }
-}
+void GPS::readLoop() {
+    int64_t lastEpochNs = runtime::monotonicNanoseconds();
 
-double GPS::parseLatLon(const std::string& value, char direction) {
-    if (value.empty()) return 0.0;
+    while (running_) {
+        // A receiver that went away is reopened and, for UBX, reconfigured
+        if (!serial_.isOpen()) {
+            if (!openReceiver()) {
+                // fill() on a closed port only waits for stop()
+                serial_.fill(POLL_TIMEOUT_MS);
+                continue;
+            }
+            lastEpochNs = runtime::monotonicNanoseconds();
+        }
 
-    double degrees = std::stod(value.substr(0, 2));
-    double minutes = std::stod(value.substr(2));
-    double result = degrees + minutes / 60.0;
+        if (serial_.fill(POLL_TIMEOUT_MS) > 0 && consumeInput()) {
+            lastEpochNs = runtime::monotonicNanoseconds();
+        }
 
-    if (direction == 'S' || direction == 'W') {
-        result = -result;
+        // NAV-PVT comes with or without a fix, so silence means the receiver
+        // restarted with its default configuration
+        if (protocol_ == Protocol::UBX &&
+            runtime::monotonicNanoseconds() - lastEpochNs > UBX_SILENCE_TIMEOUT_MS * 1000000LL) {
+            std::cerr << "No NAV-PVT from the GPS receiver, reconfiguring" << std::endl;
+            serial_.close();
+        }
     }
-
-    return result;
 }
 
 } // namespace sensors
-} // namespace drone 
\ No newline at end of file
+} // namespace drone
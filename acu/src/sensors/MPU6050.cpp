@@ -1,25 +1,62 @@
 #include "sensors/MPU6050.hpp"
-#include <wiringPiI2C.h>
+#include "hal/LinuxI2CDevice.hpp"
+#include "runtime/Clock.hpp"
+#include <pthread.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 #include <unistd.h>
+#include <errno.h>
+#include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <iostream>
 #include <thread>
 #include <cmath>
 
 namespace drone {
 namespace sensors {
 
-MPU6050::MPU6050() : i2cFd_(-1) {}
+namespace {
+    constexpr float ACCEL_SCALE = 1.0f / 16384.0f;  // For ±2g range
+    constexpr float GYRO_SCALE = 1.0f / 131.0f;     // For ±250°/s range
 
-MPU6050::~MPU6050() {
-    if (i2cFd_ >= 0) {
-        close(i2cFd_);
+    constexpr double NOMINAL_PERIOD_NS = 1e9 / MPU6050::SAMPLE_RATE_HZ;
+    constexpr double PHASE_GAIN = 0.1;          // Share of each timing error taken as phase
+    constexpr double FREQUENCY_GAIN = 0.01;     // Share taken as a period correction
+    constexpr double MAX_PERIOD_ERROR = 0.02;   // Oscillator tolerance, +/-2%
+    constexpr double RESYNC_PERIODS = 2.0;      // Larger errors re-anchor the clock
+
+    int16_t bigEndian16(const uint8_t* bytes) {
+        return static_cast<int16_t>((bytes[0] << 8) | bytes[1]);
     }
 }
 
+MPU6050::MPU6050(std::unique_ptr<hal::I2CDevice> device, int interruptPin)
+    : device_(std::move(device))
+    , stopFd_(-1)
+    , clockAnchored_(false)
+    , anchorSeq_(0)
+    , anchorNs_(0)
+    , periodNs_(NOMINAL_PERIOD_NS)
+    , nextSequence_(0)
+    , rawData_{} {
+    if (!device_) {
+        device_ = std::make_unique<hal::LinuxI2CDevice>("/dev/i2c-1", MPU6050_ADDR);
+    }
+    if (interruptPin >= 0) {
+        interrupt_ = std::make_unique<hal::GpioLine>("/dev/gpiochip0",
+                                                     static_cast<unsigned int>(interruptPin));
+    }
+}
+
+MPU6050::~MPU6050() {
+    stop();
+    device_->close();
+}
+
 bool MPU6050::init() {
     // Initialize I2C
-    i2cFd_ = wiringPiI2CSetup(MPU6050_ADDR);
-    if (i2cFd_ < 0) {
+    if (!device_->open()) {
         return false;
     }
 
@@ -38,8 +75,19 @@ bool MPU6050::init() {
         return false;
     }
 
-    // Set DLPF to 42Hz (reduces noise)
-    if (!writeReg(CONFIG, 0x03)) {
+    // DLPF at 188Hz (about 2ms delay) only as an anti-alias filter; the
+    // real low-pass and notch filtering is done in software
+    if (!writeReg(CONFIG, 0x01)) {
+        return false;
+    }
+
+    // With the DLPF enabled the gyro runs at 1kHz; divider 0 keeps that rate
+    if (!writeReg(SMPLRT_DIV, static_cast<uint8_t>(1000 / SAMPLE_RATE_HZ - 1))) {
+        return false;
+    }
+
+    // INT: active high push-pull, 50us pulse per data-ready
+    if (!writeReg(INT_PIN_CFG, 0x00) || !writeReg(INT_ENABLE, 0x01)) {
         return false;
     }
 
@@ -50,13 +98,14 @@ bool MPU6050::init() {
 }
 
 bool MPU6050::calibrate() {
+    // Reads the data registers directly, so run it before start()
     constexpr int NUM_SAMPLES = 1000;
     float sumAx = 0, sumAy = 0, sumAz = 0;
     float sumGx = 0, sumGy = 0, sumGz = 0;
 
     // Collect samples
     for (int i = 0; i < NUM_SAMPLES; ++i) {
-        if (!update()) {
+        if (!readRawData()) {
             return false;
         }
         sumAx += rawData_.ax;
@@ -79,77 +128,241 @@ bool MPU6050::calibrate() {
     return true;
 }
 
-bool MPU6050::update() {
-    uint8_t buffer[14];
-    if (!readRegs(ACCEL_XOUT_H, buffer, 14)) {
+bool MPU6050::start(int priority) {
+    if (running_) return true;
+
+    if (interrupt_ && !interrupt_->requestEdgeEvents("mpu6050-int")) {
+        std::cerr << "IMU data-ready interrupt unavailable, polling the FIFO" << std::endl;
+        interrupt_.reset();
+    }
+
+    stopFd_ = eventfd(0, EFD_CLOEXEC);
+    if (stopFd_ < 0) {
+        std::cerr << "Failed to create eventfd: " << strerror(errno) << std::endl;
         return false;
     }
 
-    // Combine high and low bytes
-    rawData_.ax = (buffer[0] << 8) | buffer[1];
-    rawData_.ay = (buffer[2] << 8) | buffer[3];
-    rawData_.az = (buffer[4] << 8) | buffer[5];
-    rawData_.temp = (buffer[6] << 8) | buffer[7];
-    rawData_.gx = (buffer[8] << 8) | buffer[9];
-    rawData_.gy = (buffer[10] << 8) | buffer[11];
-    rawData_.gz = (buffer[12] << 8) | buffer[13];
-
-    // Calculate time delta
-    auto now = std::chrono::high_resolution_clock::now();
-    auto nowUs = std::chrono::duration_cast<std::chrono::microseconds>(
-        now.time_since_epoch()).count();
-    float dt = (lastUpdate_ == 0) ? 0.0f : (nowUs - lastUpdate_) / 1000000.0f;
-    lastUpdate_ = nowUs;
-
-    // Update attitude
-    if (dt > 0) {
-        updateAttitude(dt);
+    if (!resetFifo()) {
+        return false;
+    }
+
+    running_ = true;
+    samplingThread_ = std::make_unique<std::thread>(&MPU6050::samplingLoop, this);
+
+    if (priority > 0) {
+        struct sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        param.sched_priority = priority;
+        int rc = pthread_setschedparam(samplingThread_->native_handle(), SCHED_FIFO, &param);
+        if (rc != 0) {
+            std::cerr << "Failed to set IMU sampling priority " << priority
+                      << ": " << strerror(rc) << std::endl;
+        }
     }
 
     return true;
 }
 
-void MPU6050::updateAttitude(float dt) {
-    // Convert raw values to physical units
-    constexpr float ACCEL_SCALE = 1.0f / 16384.0f;  // For ±2g range
-    constexpr float GYRO_SCALE = 1.0f / 131.0f;     // For ±250°/s range
+void MPU6050::stop() {
+    if (!running_) return;
+
+    running_ = false;
+    uint64_t one = 1;
+    if (write(stopFd_, &one, sizeof(one)) < 0) {
+        std::cerr << "Failed to wake IMU sampling thread" << std::endl;
+    }
+    if (samplingThread_ && samplingThread_->joinable()) {
+        samplingThread_->join();
+    }
+    samplingThread_.reset();
 
-    // Apply calibration offsets and scaling
-    float ax = (rawData_.ax - offsets_.ax) * ACCEL_SCALE;
-    float ay = (rawData_.ay - offsets_.ay) * ACCEL_SCALE;
-    float az = (rawData_.az - offsets_.az) * ACCEL_SCALE;
-    float gx = (rawData_.gx - offsets_.gx) * GYRO_SCALE;
-    float gy = (rawData_.gy - offsets_.gy) * GYRO_SCALE;
-    float gz = (rawData_.gz - offsets_.gz) * GYRO_SCALE;
+    close(stopFd_);
+    stopFd_ = -1;
 
-    // Calculate accelerometer angles
-    float accel_roll = atan2(ay, az) * 180.0f / M_PI;
-    float accel_pitch = atan2(-ax, sqrt(ay * ay + az * az)) * 180.0f / M_PI;
+    writeReg(USER_CTRL, 0x00);
+    if (interrupt_) {
+        interrupt_->release();
+    }
+}
 
-    // Complementary filter
-    roll_ = ALPHA * (roll_ + gx * dt) + (1 - ALPHA) * accel_roll;
-    pitch_ = ALPHA * (pitch_ + gy * dt) + (1 - ALPHA) * accel_pitch;
-    yaw_ += gz * dt;  // Simple integration for yaw
+MPU6050::Statistics MPU6050::getStatistics() const {
+    Statistics stats;
+    stats.samples = sampleCount_.load(std::memory_order_relaxed);
+    stats.fifoOverflows = fifoOverflows_.load(std::memory_order_relaxed);
+    stats.ringDrops = samples_.dropped();
+    stats.clockResyncs = clockResyncs_.load(std::memory_order_relaxed);
+    stats.readErrors = readErrors_.load(std::memory_order_relaxed);
+    return stats;
 }
 
-bool MPU6050::writeReg(uint8_t reg, uint8_t value) {
-    return wiringPiI2CWriteReg8(i2cFd_, reg, value) >= 0;
+bool MPU6050::readRawData() {
+    uint8_t buffer[14];
+    if (!readRegs(ACCEL_XOUT_H, buffer, 14)) {
+        return false;
+    }
+
+    // Combine high and low bytes
+    rawData_.ax = bigEndian16(&buffer[0]);
+    rawData_.ay = bigEndian16(&buffer[2]);
+    rawData_.az = bigEndian16(&buffer[4]);
+    rawData_.temp = bigEndian16(&buffer[6]);
+    rawData_.gx = bigEndian16(&buffer[8]);
+    rawData_.gy = bigEndian16(&buffer[10]);
+    rawData_.gz = bigEndian16(&buffer[12]);
+    return true;
 }
 
-uint8_t MPU6050::readReg(uint8_t reg) {
-    return wiringPiI2CReadReg8(i2cFd_, reg);
+bool MPU6050::resetFifo() {
+    // Reset, then enable the FIFO with accel and gyro (no temperature)
+    clockAnchored_ = false;
+    return writeReg(USER_CTRL, 0x04) &&
+           writeReg(USER_CTRL, 0x40) &&
+           writeReg(FIFO_EN, 0x78);
 }
 
-bool MPU6050::readRegs(uint8_t reg, uint8_t* buffer, size_t length) {
-    for (size_t i = 0; i < length; ++i) {
-        int value = wiringPiI2CReadReg8(i2cFd_, reg + i);
-        if (value < 0) {
-            return false;
+void MPU6050::samplingLoop() {
+    struct pollfd fds[2];
+    fds[0].fd = stopFd_;
+    fds[0].events = POLLIN;
+    fds[1].fd = interrupt_ ? interrupt_->getPollFd() : -1;
+    fds[1].events = POLLIN;
+    nfds_t count = fds[1].fd >= 0 ? 2 : 1;
+
+    hal::GpioLine::EdgeEvent events[16];
+
+    while (running_) {
+        int rc = poll(fds, count, POLL_TIMEOUT_MS);
+        if (rc < 0 && errno != EINTR) {
+            std::cerr << "IMU poll failed: " << strerror(errno) << std::endl;
+            break;
         }
-        buffer[i] = static_cast<uint8_t>(value);
+        if (fds[0].revents & POLLIN) {
+            break;
+        }
+
+        // The newest data-ready edge dates the newest FIFO sample
+        int64_t edgeNs = 0;
+        uint32_t edges = 0;
+        if (interrupt_) {
+            size_t received;
+            while ((received = interrupt_->readEvents(events, 16)) > 0) {
+                for (size_t i = 0; i < received; ++i) {
+                    if (events[i].edge == hal::GpioLine::Edge::RISING) {
+                        edgeNs = events[i].timestampNs;
+                        edges++;
+                    }
+                }
+            }
+        }
+
+        drainFifo(edgeNs, edges);
     }
-    return true;
+}
+
+void MPU6050::drainFifo(int64_t edgeNs, uint32_t edges) {
+    uint8_t countBytes[2];
+    if (!readRegs(FIFO_COUNT_H, countBytes, sizeof(countBytes))) {
+        readErrors_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const int64_t readNs = runtime::monotonicNanoseconds();
+    const size_t count = (static_cast<size_t>(countBytes[0]) << 8) | countBytes[1];
+
+    // A full FIFO overwrites its oldest bytes and loses sample alignment.
+    // 1020 bytes (85 samples) is the most that still divides into samples.
+    if (count >= FIFO_SIZE || count % FIFO_SAMPLE_BYTES != 0) {
+        fifoOverflows_.fetch_add(1, std::memory_order_relaxed);
+        nextSequence_ += static_cast<uint32_t>(count / FIFO_SAMPLE_BYTES);
+        resetFifo();
+        return;
+    }
+
+    uint32_t available = static_cast<uint32_t>(count / FIFO_SAMPLE_BYTES);
+    if (available == 0) return;
+
+    // Only trust the edge when it accounts for every queued sample; otherwise
+    // a sample landed after the last edge. Without INT the read time bounds
+    // the newest sample to within one period.
+    const uint32_t newest = nextSequence_ + available - 1;
+    if (interrupt_ && edges == available) {
+        correctClock(newest, edgeNs);
+    } else if (!interrupt_ || !clockAnchored_) {
+        correctClock(newest, readNs);
+    }
+
+    uint8_t buffer[FIFO_BURST_SAMPLES * FIFO_SAMPLE_BYTES];
+    while (available > 0) {
+        uint32_t batch = std::min<uint32_t>(available, FIFO_BURST_SAMPLES);
+
+        // FIFO_R_W does not auto-increment: a burst read streams FIFO bytes
+        if (!readRegs(FIFO_R_W, buffer, batch * FIFO_SAMPLE_BYTES)) {
+            readErrors_.fetch_add(1, std::memory_order_relaxed);
+            nextSequence_ += available;
+            resetFifo();
+            return;
+        }
+
+        for (uint32_t i = 0; i < batch; ++i) {
+            const uint8_t* bytes = &buffer[i * FIFO_SAMPLE_BYTES];
+            ImuSample sample;
+            sample.sequence = nextSequence_++;
+            sample.timestampNs = timestampSample(sample.sequence);
+            sample.ax = (bigEndian16(&bytes[0]) - offsets_.ax) * ACCEL_SCALE;
+            sample.ay = (bigEndian16(&bytes[2]) - offsets_.ay) * ACCEL_SCALE;
+            sample.az = (bigEndian16(&bytes[4]) - offsets_.az) * ACCEL_SCALE;
+            sample.gx = (bigEndian16(&bytes[6]) - offsets_.gx) * GYRO_SCALE;
+            sample.gy = (bigEndian16(&bytes[8]) - offsets_.gy) * GYRO_SCALE;
+            sample.gz = (bigEndian16(&bytes[10]) - offsets_.gz) * GYRO_SCALE;
+            samples_.push(sample);
+            sampleCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+        available -= batch;
+    }
+}
+
+int64_t MPU6050::timestampSample(uint32_t sequence) const {
+    int32_t offset = static_cast<int32_t>(sequence - anchorSeq_);
+    return static_cast<int64_t>(anchorNs_ + offset * periodNs_);
+}
+
+void MPU6050::correctClock(uint32_t sequence, int64_t observedNs) {
+    // Samples are evenly spaced on the sensor oscillator, so timestamps come
+    // from the sample count; observations only trim phase and period
+    if (!clockAnchored_) {
+        anchorSeq_ = sequence;
+        anchorNs_ = static_cast<double>(observedNs);
+        clockAnchored_ = true;
+        return;
+    }
+
+    uint32_t span = sequence - anchorSeq_;
+    double predicted = anchorNs_ + static_cast<int32_t>(span) * periodNs_;
+    double error = observedNs - predicted;
+
+    if (std::fabs(error) > RESYNC_PERIODS * periodNs_) {
+        clockResyncs_.fetch_add(1, std::memory_order_relaxed);
+        anchorSeq_ = sequence;
+        anchorNs_ = static_cast<double>(observedNs);
+        return;
+    }
+
+    anchorSeq_ = sequence;
+    anchorNs_ = predicted + PHASE_GAIN * error;
+    if (span > 0) {
+        periodNs_ += FREQUENCY_GAIN * error / span;
+        periodNs_ = std::max(NOMINAL_PERIOD_NS * (1.0 - MAX_PERIOD_ERROR),
+                             std::min(NOMINAL_PERIOD_NS * (1.0 + MAX_PERIOD_ERROR), periodNs_));
+    }
+}
+
+bool MPU6050::writeReg(uint8_t reg, uint8_t value) {
+    return device_->writeRegister(reg, value);
+}
+
+bool MPU6050::readRegs(uint8_t reg, uint8_t* buffer, size_t length) {
+    // One burst: the register pointer auto-increments across the block
+    return device_->readRegisters(reg, buffer, length);
 }
 
 } // namespace sensors
-} // namespace drone 
\ No newline at end of file
+} // namespace drone
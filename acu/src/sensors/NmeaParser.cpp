@@ -0,0 +1,390 @@
+#include "sensors/NmeaParser.hpp"
+#include "math/FastMath.hpp"
+#include <cmath>
+#include <cstring>
+
+namespace drone {
+namespace sensors {
+
+namespace {
+    constexpr int64_t POW10[] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+    };
+
+    constexpr float KNOTS_TO_MPS = 0.514444f;
+
+    // Field indices after the address field
+    constexpr size_t GGA_TIME = 1, GGA_LAT = 2, GGA_NS = 3, GGA_LON = 4, GGA_EW = 5,
+                     GGA_QUALITY = 6, GGA_SATS = 7, GGA_HDOP = 8, GGA_ALT = 9;
+    constexpr size_t RMC_TIME = 1, RMC_STATUS = 2, RMC_LAT = 3, RMC_NS = 4, RMC_LON = 5,
+                     RMC_EW = 6, RMC_SPEED = 7, RMC_COURSE = 8;
+}
+
+NmeaParser::NmeaParser() {
+    reset();
+}
+
+void NmeaParser::reset() {
+    state_ = State::WAIT_START;
+    sentence_ = Sentence::UNKNOWN;
+    length_ = 0;
+    fieldIndex_ = 0;
+    checksum_ = 0;
+    expected_ = 0;
+    sentenceStartNs_ = 0;
+    std::memset(address_, 0, sizeof(address_));
+    std::memset(&field_, 0, sizeof(field_));
+    std::memset(&pending_, 0, sizeof(pending_));
+
+    epoch_ = Fix{};
+    epochTime_ = TIME_UNKNOWN;
+    epochHasGga_ = false;
+    epochHasRmc_ = false;
+    epochPublished_ = true;
+
+    fix_ = Fix{};
+    stats_ = Statistics{};
+}
+
+bool NmeaParser::feed(const uint8_t* data, const int64_t* timestamps, size_t length) {
+    bool published = false;
+    for (size_t i = 0; i < length; ++i) {
+        published |= feed(static_cast<char>(data[i]), timestamps[i]);
+    }
+    return published;
+}
+
+bool NmeaParser::feed(const uint8_t* data, size_t length, int64_t timestampNs) {
+    bool published = false;
+    for (size_t i = 0; i < length; ++i) {
+        published |= feed(static_cast<char>(data[i]), timestampNs);
+    }
+    return published;
+}
+
+bool NmeaParser::feed(char c, int64_t timestampNs) {
+    stats_.bytes++;
+
+    // A start delimiter always begins a new sentence, whatever came before
+    if (c == '$') {
+        if (state_ != State::WAIT_START) {
+            stats_.malformed++;
+        }
+        beginSentence();
+        sentenceStartNs_ = timestampNs;
+        return false;
+    }
+
+    switch (state_) {
+        case State::WAIT_START:
+            return false;
+
+        case State::BODY:
+            if (c == '*') {
+                endField();
+                state_ = State::CHECKSUM_HIGH;
+            } else if (c == '\r' || c == '\n' || ++length_ > MAX_SENTENCE_LENGTH) {
+                // Sentences without a checksum are not trusted
+                stats_.malformed++;
+                state_ = State::WAIT_START;
+            } else {
+                checksum_ ^= static_cast<uint8_t>(c);
+                if (c == ',') {
+                    endField();
+                } else {
+                    accumulate(c);
+                }
+            }
+            return false;
+
+        case State::CHECKSUM_HIGH: {
+            int value = hexValue(c);
+            if (value < 0) {
+                stats_.malformed++;
+                state_ = State::WAIT_START;
+                return false;
+            }
+            expected_ = static_cast<uint8_t>(value << 4);
+            state_ = State::CHECKSUM_LOW;
+            return false;
+        }
+
+        case State::CHECKSUM_LOW: {
+            int value = hexValue(c);
+            state_ = State::WAIT_START;
+            if (value < 0) {
+                stats_.malformed++;
+                return false;
+            }
+            expected_ |= static_cast<uint8_t>(value);
+            if (expected_ != checksum_) {
+                stats_.checksumErrors++;
+                return false;
+            }
+            return endSentence();
+        }
+    }
+    return false;
+}
+
+void NmeaParser::beginSentence() {
+    state_ = State::BODY;
+    sentence_ = Sentence::UNKNOWN;
+    length_ = 0;
+    fieldIndex_ = 0;
+    checksum_ = 0;
+    std::memset(address_, 0, sizeof(address_));
+    std::memset(&pending_, 0, sizeof(pending_));
+    beginField();
+}
+
+void NmeaParser::beginField() {
+    field_.mantissa = 0;
+    field_.decimals = 0;
+    field_.digits = 0;
+    field_.length = 0;
+    field_.negative = false;
+    field_.point = false;
+    field_.valid = true;
+    field_.first = '\0';
+}
+
+void NmeaParser::accumulate(char c) {
+    if (fieldIndex_ == 0) {
+        // Talker and sentence type, e.g. GPGGA or GNRMC
+        if (field_.length < sizeof(address_)) {
+            address_[field_.length] = c;
+        }
+        field_.length++;
+        return;
+    }
+
+    if (field_.length == 0) {
+        field_.first = c;
+    }
+    if (++field_.length > MAX_FIELD_LENGTH) {
+        field_.valid = false;
+        return;
+    }
+
+    if (c >= '0' && c <= '9') {
+        // Precision beyond MAX_DECIMALS is dropped rather than overflowing
+        if (field_.point && field_.decimals >= MAX_DECIMALS) {
+            return;
+        }
+        if (field_.digits >= 18) {
+            field_.valid = false;
+            return;
+        }
+        field_.mantissa = field_.mantissa * 10 + (c - '0');
+        field_.digits++;
+        if (field_.point) {
+            field_.decimals++;
+        }
+    } else if (c == '.' && !field_.point) {
+        field_.point = true;
+    } else if (c == '-' && field_.length == 1) {
+        field_.negative = true;
+    } else if (field_.length > 1 || field_.point) {
+        // Letters are only meaningful as single-character fields
+        field_.valid = false;
+    }
+}
+
+void NmeaParser::endField() {
+    const size_t index = fieldIndex_++;
+
+    if (index == 0) {
+        if (field_.length == 5) {
+            if (std::memcmp(address_ + 2, "GGA", 3) == 0) {
+                sentence_ = Sentence::GGA;
+            } else if (std::memcmp(address_ + 2, "RMC", 3) == 0) {
+                sentence_ = Sentence::RMC;
+            }
+        }
+        beginField();
+        return;
+    }
+
+    if (sentence_ == Sentence::UNKNOWN || index >= MAX_FIELDS || field_.length == 0 ||
+        !field_.valid) {
+        beginField();
+        return;
+    }
+
+    bool present = true;
+    if (sentence_ == Sentence::GGA) {
+        switch (index) {
+            case GGA_TIME:    present = parseTime(field_, pending_.timeOfDayMs); break;
+            case GGA_LAT:     pending_.latitude = toDegrees(field_); break;
+            case GGA_NS:      if (field_.first == 'S') pending_.latitude = -pending_.latitude; break;
+            case GGA_LON:     pending_.longitude = toDegrees(field_); break;
+            case GGA_EW:      if (field_.first == 'W') pending_.longitude = -pending_.longitude; break;
+            case GGA_QUALITY: pending_.quality = static_cast<int>(field_.mantissa); break;
+            case GGA_SATS:    pending_.satellites = static_cast<int>(field_.mantissa); break;
+            case GGA_HDOP:    pending_.hdop = toFloat(field_); break;
+            case GGA_ALT:     pending_.altitude = toFloat(field_); break;
+            default:          present = false; break;
+        }
+    } else {
+        switch (index) {
+            case RMC_TIME:    present = parseTime(field_, pending_.timeOfDayMs); break;
+            case RMC_STATUS:  pending_.status = field_.first; break;
+            case RMC_LAT:     pending_.latitude = toDegrees(field_); break;
+            case RMC_NS:      if (field_.first == 'S') pending_.latitude = -pending_.latitude; break;
+            case RMC_LON:     pending_.longitude = toDegrees(field_); break;
+            case RMC_EW:      if (field_.first == 'W') pending_.longitude = -pending_.longitude; break;
+            case RMC_SPEED:   pending_.speed = toFloat(field_) * KNOTS_TO_MPS; break;
+            case RMC_COURSE:  pending_.course = toFloat(field_); break;
+            default:          present = false; break;
+        }
+    }
+
+    if (present) {
+        pending_.present |= 1u << index;
+    }
+    beginField();
+}
+
+bool NmeaParser::endSentence() {
+    stats_.sentences++;
+
+    switch (sentence_) {
+        case Sentence::GGA:
+            if (fieldIndex_ <= GGA_ALT) {
+                stats_.malformed++;
+                return false;
+            }
+            return commitGga();
+
+        case Sentence::RMC:
+            if (fieldIndex_ <= RMC_COURSE) {
+                stats_.malformed++;
+                return false;
+            }
+            return commitRmc();
+
+        default:
+            return false;
+    }
+}
+
+bool NmeaParser::commitGga() {
+    uint32_t time = has(GGA_TIME) ? pending_.timeOfDayMs : TIME_UNKNOWN;
+    bool published = startEpoch(time);
+
+    epoch_.fix = pending_.quality > 0 && has(GGA_LAT) && has(GGA_LON);
+    epoch_.satellites = pending_.satellites;
+    if (epoch_.fix) {
+        epoch_.latitude = pending_.latitude;
+        epoch_.longitude = pending_.longitude;
+        epoch_.altitude = pending_.altitude;
+        epoch_.hdop = pending_.hdop;
+    }
+    epochHasGga_ = true;
+
+    // Without a time there is nothing to pair it with
+    if (epochHasRmc_ || time == TIME_UNKNOWN) {
+        published |= publish();
+    }
+    return published;
+}
+
+bool NmeaParser::commitRmc() {
+    uint32_t time = has(RMC_TIME) ? pending_.timeOfDayMs : TIME_UNKNOWN;
+    bool published = startEpoch(time);
+
+    if (pending_.status == 'A') {
+        if (has(RMC_SPEED)) epoch_.speed = pending_.speed;
+        if (has(RMC_COURSE)) epoch_.course = pending_.course;
+
+        // NMEA has no vertical velocity; the horizontal one follows from
+        // speed and course
+        float course = epoch_.course * math::DEG_TO_RAD;
+        epoch_.velocityNorth = epoch_.speed * std::cos(course);
+        epoch_.velocityEast = epoch_.speed * std::sin(course);
+    }
+    epochHasRmc_ = true;
+
+    if (epochHasGga_) {
+        published |= publish();
+    }
+    return published;
+}
+
+bool NmeaParser::startEpoch(uint32_t timeOfDayMs) {
+    if (timeOfDayMs == epochTime_ && timeOfDayMs != TIME_UNKNOWN) {
+        return false;
+    }
+
+    // A receiver that only sends GGA completes an epoch when the next begins
+    bool published = false;
+    if (epochHasGga_ && !epochPublished_) {
+        published = publish();
+    }
+
+    epochTime_ = timeOfDayMs;
+    epoch_.timestampNs = sentenceStartNs_;
+    epoch_.timeOfDayMs = timeOfDayMs == TIME_UNKNOWN ? 0 : timeOfDayMs;
+    epochHasGga_ = false;
+    epochHasRmc_ = false;
+    epochPublished_ = false;
+    return published;
+}
+
+bool NmeaParser::publish() {
+    if (epochPublished_) {
+        return false;
+    }
+
+    fix_ = epoch_;
+    epochPublished_ = true;
+    stats_.fixes++;
+    return true;
+}
+
+bool NmeaParser::parseTime(const Field& field, uint32_t& timeOfDayMs) {
+    // hhmmss with optional fractional seconds
+    if (field.digits < 6 + field.decimals) {
+        return false;
+    }
+
+    int64_t scale = POW10[field.decimals];
+    int64_t whole = field.mantissa / scale;
+    int64_t fraction = field.mantissa % scale;
+
+    int64_t hours = whole / 10000;
+    int64_t minutes = (whole / 100) % 100;
+    int64_t seconds = whole % 100;
+    if (hours > 23 || minutes > 59 || seconds > 60) {
+        return false;
+    }
+
+    timeOfDayMs = static_cast<uint32_t>(((hours * 60 + minutes) * 60 + seconds) * 1000 +
+                                        fraction * 1000 / scale);
+    return true;
+}
+
+double NmeaParser::toDegrees(const Field& field) {
+    // (d)ddmm.mmmm: everything above the last two integer digits is degrees.
+    // Splitting in fixed point keeps the minutes exact until the final divide.
+    int64_t scale = POW10[field.decimals];
+    int64_t degrees = field.mantissa / (100 * scale);
+    int64_t minutes = field.mantissa - degrees * 100 * scale;
+    return static_cast<double>(degrees) + static_cast<double>(minutes) / (60.0 * scale);
+}
+
+float NmeaParser::toFloat(const Field& field) {
+    float value = static_cast<float>(static_cast<double>(field.mantissa) / POW10[field.decimals]);
+    return field.negative ? -value : value;
+}
+
+int NmeaParser::hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+} // namespace sensors
+} // namespace drone
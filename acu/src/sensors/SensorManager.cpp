@@ -1,6 +1,13 @@
 #include "sensors/SensorManager.hpp"
 #include "Config.hpp"
+#include "runtime/Clock.hpp"
+#include "estimation/AttitudeEkf.hpp"
+#include "estimation/MahonyFilter.hpp"
+#include "math/FastMath.hpp"
+#include "topics/Topics.hpp"
 #include <wiringPi.h>
+#include <algorithm>
+#include <cmath>
 #include <chrono>
 #include <thread>
 
@@ -8,14 +15,40 @@ namespace drone {
 namespace sensors {
 
 SensorManager::SensorManager(const Config& config)
-    : isCalibrated_(false) {
-    // Initialize WiringPi
-    wiringPiSetup();
+    : isCalibrated_(false)
+    // The IMU sampler must preempt the control loop it feeds
+    , imuPriority_(config.rt_priority > 0 ? std::min(config.rt_priority + 1, 99) : 0)
+    , spectrum_(static_cast<float>(MPU6050::SAMPLE_RATE_HZ), NOTCH_MIN_HZ, NOTCH_MAX_HZ)
+    , estimatorInitialized_(false)
+    , lastImuSampleNs_(0)
+    , tiltCosine_(1.0f)
+    , lastGpsFixNs_(0)
+    , batterySequence_(0)
+    , estimatorUpdates_(0)
+    , estimatorOverBudget_(0)
+    , estimatorMaxNs_(0)
+    , estimatorTotalNs_(0) {
+    // Initialize WiringPi with BCM numbering: the GpioLine fallback passes
+    // the same line offsets the GPIO character device uses
+    wiringPiSetupGpio();
 
     // Create sensor instances
-    imu_ = std::make_unique<MPU6050>();
-    gps_ = std::make_unique<GPS>();
+    imu_ = std::make_unique<MPU6050>(nullptr, 17);  // GPIO17 = IMU INT
+    gps_ = std::make_unique<GPS>("/dev/ttyAMA0",
+        config.gps_ubx ? GPS::Protocol::UBX : GPS::Protocol::NMEA, config.gps_rate_hz);
     ultrasonic_ = std::make_unique<Ultrasonic>(13, 16);  // GPIO13 = Trigger, GPIO16 = Echo
+
+    const float sampleRate = static_cast<float>(MPU6050::SAMPLE_RATE_HZ);
+    imuFilter_.setStage(LOW_PASS_STAGE, filters::BiquadBank::ACCEL_X, 3,
+        filters::BiquadCoefficients::lowPass(config.imu_accel_lpf_hz, sampleRate));
+    imuFilter_.setStage(LOW_PASS_STAGE, filters::BiquadBank::GYRO_X, 3,
+        filters::BiquadCoefficients::lowPass(config.imu_gyro_lpf_hz, sampleRate));
+
+    if (config.attitude_ekf) {
+        estimator_ = std::make_unique<estimation::AttitudeEkf>();
+    } else {
+        estimator_ = std::make_unique<estimation::MahonyFilter>();
+    }
 }
 
 SensorManager::~SensorManager() {
@@ -36,20 +69,15 @@ bool SensorManager::start() {
         return false;
     }
 
-    return true;
+    // Calibrated: hand the IMU over to its interrupt-driven sampling thread
+    return imu_->start(imuPriority_);
 }
 
 void SensorManager::stop() {
+    imu_->stop();
     gps_->stop();
 }
 
-void SensorManager::update() {
-    updateIMU();
-    updateGPS();
-    updateUltrasonic();
-    updateBatteryVoltage();
-}
-
 bool SensorManager::performCalibration() {
     // Calibrate IMU
     if (!imu_->calibrate()) {
@@ -71,25 +99,29 @@ bool SensorManager::performCalibration() {
     return true;
 }
 
-protocol::TelemetryData SensorManager::getTelemetryData() {
+SensorSnapshot SensorManager::snapshot(int64_t nowNs) const {
+    SensorSnapshot snapshot;
+    snapshot.timestampNs = nowNs;
+    snapshot.calibrated = isCalibrated_;
+
     std::lock_guard<std::mutex> lock(dataMutex_);
-    
-    protocol::TelemetryData telemetry;
-    
-    // Copy attitude data
-    telemetry.roll = sensorData_.roll;
-    telemetry.pitch = sensorData_.pitch;
-    telemetry.yaw = sensorData_.yaw;
-    
-    // Copy position data
-    telemetry.latitude = sensorData_.latitude;
-    telemetry.longitude = sensorData_.longitude;
-    telemetry.altitude = sensorData_.altitude;
-    
-    // Copy battery data
-    telemetry.battery_voltage = sensorData_.batteryVoltage;
-    
-    return telemetry;
+    snapshot.roll = sensorData_.roll;
+    snapshot.pitch = sensorData_.pitch;
+    snapshot.yaw = sensorData_.yaw;
+    snapshot.latitude = sensorData_.latitude;
+    snapshot.longitude = sensorData_.longitude;
+    snapshot.altitude = sensorData_.altitude;
+    snapshot.height = sensorData_.height;
+    snapshot.climbRate = sensorData_.climbRate;
+    snapshot.hasHome = localFrame_.hasOrigin();
+    snapshot.east = sensorData_.east;
+    snapshot.north = sensorData_.north;
+    snapshot.batteryVoltage = sensorData_.batteryVoltage;
+    snapshot.attitudeNs = sensorData_.attitudeNs;
+    snapshot.gpsNs = sensorData_.gpsNs;
+    snapshot.rangeNs = sensorData_.rangeNs;
+    snapshot.batteryNs = sensorData_.batteryNs;
+    return snapshot;
 }
 
 float SensorManager::getAltitude() const {
@@ -97,42 +129,342 @@ float SensorManager::getAltitude() const {
     return sensorData_.altitude;
 }
 
+float SensorManager::getHeight() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    return sensorData_.height;
+}
+
+float SensorManager::getClimbRate() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    return sensorData_.climbRate;
+}
+
+geodesy::Enu SensorManager::getLocalPosition() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    geodesy::Enu position;
+    position.east = sensorData_.east;
+    position.north = sensorData_.north;
+    position.up = sensorData_.height;
+    return position;
+}
+
+geodesy::LocalFrame SensorManager::getLocalFrame() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    return localFrame_;
+}
+
 float SensorManager::getBatteryVoltage() const {
     std::lock_guard<std::mutex> lock(dataMutex_);
     return sensorData_.batteryVoltage;
 }
 
 void SensorManager::updateIMU() {
-    if (imu_->update()) {
-        std::lock_guard<std::mutex> lock(dataMutex_);
-        sensorData_.roll = imu_->getRoll();
-        sensorData_.pitch = imu_->getPitch();
-        sensorData_.yaw = imu_->getYaw();
+    bool updated = false;
+    MPU6050::ImuSample sample;
+    while (imu_->readSample(sample)) {
+        imuHistory_.push(sample);
+
+        topics::ImuRaw message;
+        message.timestampNs = sample.timestampNs;
+        message.sequence = sample.sequence;
+        message.accel[0] = sample.ax;
+        message.accel[1] = sample.ay;
+        message.accel[2] = sample.az;
+        message.gyro[0] = sample.gx;
+        message.gyro[1] = sample.gy;
+        message.gyro[2] = sample.gz;
+        topics::imuRaw.publish(message);
+
+        float raw[filters::BiquadBank::CHANNELS] = {
+            sample.ax, sample.ay, sample.az, sample.gx, sample.gy, sample.gz
+        };
+        float filtered[filters::BiquadBank::CHANNELS];
+        if (!estimatorInitialized_) {
+            imuFilter_.prime(raw);
+        }
+        imuFilter_.process(raw, filtered);
+
+        // The analyzer sees the unfiltered gyro so a notch does not hide
+        // the peak it is tracking
+        spectrum_.push(&raw[filters::BiquadBank::GYRO_X]);
+
+        math::Vector3 accel = math::makeVector3(filtered[0], filtered[1], filtered[2]);
+        math::Vector3 gyro = math::makeVector3(filtered[3], filtered[4], filtered[5]) *
+                             math::DEG_TO_RAD;
+
+        if (!estimatorInitialized_) {
+            estimator_->initialize(accel);
+            estimatorInitialized_ = true;
+            lastImuSampleNs_ = sample.timestampNs;
+            continue;
+        }
+
+        // dt from sensor timestamps, so late or batched delivery does not
+        // distort the integration
+        float dt = (sample.timestampNs - lastImuSampleNs_) * 1e-9f;
+        lastImuSampleNs_ = sample.timestampNs;
+        if (dt <= 0.0f) {
+            continue;
+        }
+
+        int64_t start = runtime::monotonicNanoseconds();
+        estimator_->update(gyro, accel, dt);
+        int64_t elapsed = runtime::monotonicNanoseconds() - start;
+
+        estimatorUpdates_++;
+        estimatorTotalNs_ += elapsed;
+        estimatorMaxNs_ = std::max(estimatorMaxNs_, elapsed);
+        if (elapsed > ESTIMATOR_BUDGET_NS) {
+            estimatorOverBudget_++;
+        }
+
+        // Specific force along world up, less the 1g it reads at rest
+        math::Vector3 up = estimator_->getAttitude().worldUpInBody();
+        tiltCosine_ = up[2];
+        altitudeEstimator_.predict((math::dot(accel, up) - 1.0f) * GRAVITY, sample.timestampNs);
+
+        math::Quaternion attitude = estimator_->getAttitude();
+        math::Vector3 level = attitude.rotate(accel);
+        positionEstimator_.predict(level[0] * GRAVITY, level[1] * GRAVITY, sample.timestampNs);
+
+        AttitudeSample attitudeSample;
+        attitudeSample.timestampNs = sample.timestampNs;
+        attitudeSample.sequence = sample.sequence;
+        attitudeSample.roll = attitude.roll();
+        attitudeSample.pitch = attitude.pitch();
+        attitudeSample.yaw = attitude.yaw();
+        attitudeSample.tiltCosine = tiltCosine_;
+        attitudeHistory_.push(attitudeSample);
+        updated = true;
+    }
+
+    // One bounded slice of FFT work per tick
+    if (spectrum_.step()) {
+        retuneNotches(spectrum_.lastAxis());
+    }
+
+    if (updated) {
+        const AttitudeSample& attitude = attitudeHistory_.newest();
+        auto vertical = altitudeEstimator_.getEstimate();
+        auto horizontal = positionEstimator_.getEstimate();
+
+        topics::Attitude attitudeMessage;
+        attitudeMessage.timestampNs = attitude.timestampNs;
+        attitudeMessage.roll = attitude.roll * math::RAD_TO_DEG;
+        attitudeMessage.pitch = attitude.pitch * math::RAD_TO_DEG;
+        attitudeMessage.yaw = attitude.yaw * math::RAD_TO_DEG;
+
+        topics::Position positionMessage;
+        {
+            std::lock_guard<std::mutex> lock(dataMutex_);
+            sensorData_.roll = attitudeMessage.roll;
+            sensorData_.pitch = attitudeMessage.pitch;
+            sensorData_.yaw = attitudeMessage.yaw;
+            sensorData_.attitudeNs = attitude.timestampNs;
+            sensorData_.altitude = vertical.altitude;
+            sensorData_.height = vertical.height;
+            sensorData_.climbRate = vertical.climbRate;
+            if (horizontal.valid) {
+                geodesy::Enu position;
+                position.east = horizontal.east;
+                position.north = horizontal.north;
+                float altitude;
+                localFrame_.toGeodetic(position, sensorData_.latitude, sensorData_.longitude, altitude);
+                sensorData_.east = horizontal.east;
+                sensorData_.north = horizontal.north;
+            }
+
+            positionMessage.latitude = sensorData_.latitude;
+            positionMessage.longitude = sensorData_.longitude;
+            positionMessage.east = sensorData_.east;
+            positionMessage.north = sensorData_.north;
+        }
+        positionMessage.timestampNs = attitude.timestampNs;
+        positionMessage.altitude = vertical.altitude;
+        positionMessage.height = vertical.height;
+        positionMessage.climbRate = vertical.climbRate;
+
+        topics::attitude.publish(attitudeMessage);
+        topics::position.publish(positionMessage);
+    }
+}
+
+void SensorManager::retuneNotches(size_t axis) {
+    const auto& result = spectrum_.getResult(axis);
+    const float sampleRate = static_cast<float>(MPU6050::SAMPLE_RATE_HZ);
+    const size_t channel = filters::BiquadBank::GYRO_X + axis;
+
+    for (size_t peak = 0; peak < filters::SpectrumAnalyzer::MAX_PEAKS; ++peak) {
+        float frequency = result.peaks[peak].frequency;
+        imuFilter_.setStage(NOTCH_STAGE + peak, channel, 1, frequency > 0.0f ?
+            filters::BiquadCoefficients::notch(frequency, sampleRate, NOTCH_Q) :
+            filters::BiquadCoefficients::passThrough());
+    }
+
+    // Condense the band into the telemetry bins, keeping the per-group maximum
+    protocol::SpectrumData data{};
+    const size_t minBin = spectrum_.getMinBin();
+    const size_t group = (spectrum_.getMaxBin() - minBin + protocol::SPECTRUM_BINS) /
+                         protocol::SPECTRUM_BINS;
+    data.axis = static_cast<uint8_t>(axis);
+    data.min_frequency = minBin * spectrum_.getBinWidth();
+    data.bin_width = group * spectrum_.getBinWidth();
+    for (size_t peak = 0; peak < protocol::SPECTRUM_PEAKS; ++peak) {
+        data.peak_frequency[peak] = result.peaks[peak].frequency;
+        if (data.peak_frequency[peak] > 0.0f) {
+            data.peak_count++;
+        }
+    }
+    for (size_t bin = 0; bin < protocol::SPECTRUM_BINS; ++bin) {
+        float magnitude = 0.0f;
+        for (size_t k = minBin + bin * group;
+             k < minBin + (bin + 1) * group && k < filters::SpectrumAnalyzer::BINS; ++k) {
+            magnitude = std::max(magnitude, result.magnitude[k]);
+        }
+        float db = 20.0f * std::log10(std::max(magnitude, 1e-6f));
+        data.magnitude[bin] = static_cast<uint8_t>(std::max(0.0f, std::min(255.0f, (db + 60.0f) * 2.0f)));
+    }
+
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    spectrumData_[axis] = data;
+}
+
+protocol::SpectrumData SensorManager::getSpectrumData(size_t axis) const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    return axis < filters::SpectrumAnalyzer::AXES ? spectrumData_[axis] : protocol::SpectrumData{};
+}
+
+SensorManager::EstimatorStatistics SensorManager::getEstimatorStatistics() const {
+    EstimatorStatistics stats;
+    stats.updates = estimatorUpdates_;
+    stats.overBudget = estimatorOverBudget_;
+    stats.maxNs = estimatorMaxNs_;
+    if (estimatorUpdates_ > 0) {
+        stats.meanNs = estimatorTotalNs_ / static_cast<int64_t>(estimatorUpdates_);
     }
+    return stats;
+}
+
+void SensorManager::report(std::ostream& out) const {
+    auto imu = imu_->getStatistics();
+    out << "IMU: " << imu.samples << " samples, " << imu.fifoOverflows << " FIFO overflows, "
+        << imu.ringDrops << " ring drops, " << imu.clockResyncs << " clock resyncs, "
+        << imu.readErrors << " read errors" << std::endl;
+
+    auto estimator = getEstimatorStatistics();
+    out << "Attitude estimator: " << estimator.updates << " updates, mean/max "
+        << estimator.meanNs / 1000.0 << "/" << estimator.maxNs / 1000.0 << " us, "
+        << estimator.overBudget << " over the " << ESTIMATOR_BUDGET_NS / 1000 << " us budget"
+        << std::endl;
+
+    auto vertical = altitudeEstimator_.getStatistics();
+    out << "Altitude estimator: GPS " << vertical.gpsFused << " fused/" << vertical.gpsRejected
+        << " rejected, range " << vertical.rangeFused << " fused/" << vertical.rangeRejected
+        << " rejected, " << vertical.stale << " too late" << std::endl;
+
+    auto horizontal = positionEstimator_.getStatistics();
+    out << "Position estimator: position " << horizontal.positionFused << " fused/"
+        << horizontal.positionRejected << " rejected, velocity " << horizontal.velocityFused
+        << " fused/" << horizontal.velocityRejected << " rejected, " << horizontal.stale
+        << " too late, " << horizontal.resets << " resets, heading "
+        << (positionEstimator_.getEstimate().aligned ? "aligned" : "unaligned") << std::endl;
+
+    auto gps = gps_->getStatistics();
+    double parseSeconds = gps.parseNs / 1e9;
+    out << "GPS: " << gps.parser.fixes + gps.ubx.fixes << " fixes from "
+        << gps.parser.sentences << " NMEA sentences and " << gps.ubx.frames << " UBX frames, "
+        << gps.parser.checksumErrors + gps.ubx.checksumErrors << " checksum errors, "
+        << gps.parser.malformed << " malformed, parsed " << gps.serial.bytes << " bytes at "
+        << (parseSeconds > 0 ? gps.serial.bytes / parseSeconds / 1e6 : 0.0) << " MB/s from "
+        << gps.serial.reads << " reads, " << gps.serial.overruns << " overruns" << std::endl;
+
+    out << "Sample gaps: IMU " << imuHistory_.gaps() << ", GPS " << gpsHistory_.gaps()
+        << ", range " << rangeHistory_.gaps() << ", battery " << batteryHistory_.gaps() << std::endl;
 }
 
 void SensorManager::updateGPS() {
     auto gpsData = gps_->getData();
-    if (gpsData.fix) {
+    if (!gpsData.fix || gpsData.timestampNs == lastGpsFixNs_) {
+        return;
+    }
+    lastGpsFixNs_ = gpsData.timestampNs;
+    gpsHistory_.push(gpsData);
+    topics::gpsFix.publish(gpsData);
+    {
+        std::lock_guard<std::mutex> lock(dataMutex_);
+        sensorData_.gpsNs = gpsData.timestampNs;
+    }
+
+    // Both channels are matched to when the fix was measured
+    const int64_t measuredNs = gpsData.timestampNs - GPS_LATENCY_NS;
+    altitudeEstimator_.fuseGps(gpsData.altitude, gpsData.verticalAccuracy, measuredNs);
+
+    // The first fix is home
+    if (!localFrame_.hasOrigin()) {
         std::lock_guard<std::mutex> lock(dataMutex_);
-        sensorData_.latitude = gpsData.latitude;
-        sensorData_.longitude = gpsData.longitude;
-        sensorData_.altitude = gpsData.altitude;
+        localFrame_.setOrigin(gpsData.latitude, gpsData.longitude, gpsData.altitude);
+    }
+    geodesy::Enu position = localFrame_.toEnu(gpsData.latitude, gpsData.longitude, gpsData.altitude);
+
+    // In straight, fast flight the nose points along the ground track, which
+    // ties the attitude estimator's free yaw to north. The heading is taken
+    // from when the course was measured, not 50 ms of turning later.
+    AttitudeSample then = attitudeAt(measuredNs);
+    if (gpsData.speed > ALIGN_MIN_SPEED && then.tiltCosine > ALIGN_MIN_TILT_COSINE) {
+        positionEstimator_.alignHeading(then.yaw, gpsData.course * math::DEG_TO_RAD);
     }
+    positionEstimator_.fuseGps(position.north, position.east, gpsData.velocityNorth, gpsData.velocityEast,
+                               gpsData.horizontalAccuracy, measuredNs);
 }
 
-void SensorManager::updateUltrasonic() {
-    float distance = ultrasonic_->getDistance();
-    if (ultrasonic_->isInRange()) {
+AttitudeSample SensorManager::attitudeAt(int64_t timestampNs) const {
+    AttitudeSample sample;
+    if (attitudeHistory_.at(timestampNs, sample)) {
+        return sample;
+    }
+    // Before the history starts or after its newest sample: the nearest
+    // estimate is the best there is
+    if (!attitudeHistory_.empty()) {
+        return timestampNs < attitudeHistory_.oldest().timestampNs ? attitudeHistory_.oldest()
+                                                                   : attitudeHistory_.newest();
+    }
+    sample.tiltCosine = tiltCosine_;
+    return sample;
+}
+
+void SensorManager::updateUltrasonic(int64_t nowNs) {
+    // Collect the echo from the previous ping, then fire the next one
+    if (ultrasonic_->poll(nowNs)) {
+        auto measurement = ultrasonic_->getMeasurement();
+        rangeHistory_.push(measurement);
+
+        // Slant range to height, only while the beam pointed near the ground
+        // at the echo
+        const float tiltCosine = attitudeAt(measurement.timestampNs).tiltCosine;
+        if (measurement.valid && measurement.distance > RANGE_MIN &&
+            measurement.distance < RANGE_MAX && tiltCosine > RANGE_MIN_TILT_COSINE) {
+            altitudeEstimator_.fuseRange(measurement.distance * tiltCosine,
+                                         measurement.timestampNs);
+        }
+
         std::lock_guard<std::mutex> lock(dataMutex_);
-        sensorData_.ultrasonicDistance = distance;
+        sensorData_.ultrasonicDistance = measurement.distance;
+        sensorData_.rangeNs = measurement.timestampNs;
     }
+    ultrasonic_->trigger(nowNs);
 }
 
 void SensorManager::updateBatteryVoltage() {
-    float voltage = readBatteryVoltage();
+    topics::Battery message;
+    message.timestampNs = runtime::monotonicNanoseconds();
+    message.sequence = batterySequence_++;
+    message.voltage = readBatteryVoltage();
+    batteryHistory_.push(message);
+    topics::battery.publish(message);
+
     std::lock_guard<std::mutex> lock(dataMutex_);
-    sensorData_.batteryVoltage = voltage;
+    sensorData_.batteryVoltage = message.voltage;
+    sensorData_.batteryNs = message.timestampNs;
 }
 
 float SensorManager::readBatteryVoltage() {
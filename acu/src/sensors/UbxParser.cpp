@@ -0,0 +1,224 @@
+#include "sensors/UbxParser.hpp"
+#include <cstring>
+
+namespace drone {
+namespace sensors {
+
+namespace {
+    // UBX payloads are little-endian
+    uint16_t readU16(const uint8_t* p) {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+
+    uint32_t readU32(const uint8_t* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    int32_t readI32(const uint8_t* p) {
+        return static_cast<int32_t>(readU32(p));
+    }
+
+    // NAV-PVT payload offsets
+    constexpr size_t PVT_HOUR = 8, PVT_MIN = 9, PVT_SEC = 10, PVT_NANO = 16,
+                     PVT_FIX_TYPE = 20, PVT_FLAGS = 21, PVT_NUM_SV = 23,
+                     PVT_LON = 24, PVT_LAT = 28, PVT_HMSL = 36, PVT_H_ACC = 40,
+                     PVT_V_ACC = 44, PVT_VEL_N = 48, PVT_VEL_E = 52, PVT_VEL_D = 56,
+                     PVT_G_SPEED = 60, PVT_HEAD_MOT = 64, PVT_PDOP = 76;
+
+    constexpr uint8_t FIX_2D = 2;
+    constexpr uint8_t FIX_GNSS_DEAD_RECKONING = 4;
+    constexpr uint8_t FLAG_GNSS_FIX_OK = 0x01;
+}
+
+UbxParser::UbxParser() {
+    reset();
+}
+
+void UbxParser::reset() {
+    state_ = State::SYNC1;
+    class_ = 0;
+    id_ = 0;
+    length_ = 0;
+    received_ = 0;
+    checkA_ = 0;
+    checkB_ = 0;
+    frameStartNs_ = 0;
+    std::memset(payload_, 0, sizeof(payload_));
+
+    fix_ = GpsFix{};
+    lastAck_ = Ack{};
+    stats_ = Statistics{};
+}
+
+bool UbxParser::feed(const uint8_t* data, const int64_t* timestamps, size_t length) {
+    bool published = false;
+    for (size_t i = 0; i < length; ++i) {
+        published |= feed(data[i], timestamps[i]);
+    }
+    return published;
+}
+
+bool UbxParser::feed(uint8_t byte, int64_t timestampNs) {
+    stats_.bytes++;
+
+    switch (state_) {
+        case State::SYNC1:
+            if (byte == SYNC_CHAR_1) {
+                frameStartNs_ = timestampNs;
+                state_ = State::SYNC2;
+            }
+            return false;
+
+        case State::SYNC2:
+            if (byte == SYNC_CHAR_2) {
+                checkA_ = checkB_ = 0;
+                state_ = State::CLASS;
+            } else if (byte == SYNC_CHAR_1) {
+                frameStartNs_ = timestampNs;
+            } else {
+                state_ = State::SYNC1;
+            }
+            return false;
+
+        case State::CLASS:
+            class_ = byte;
+            checksum(byte);
+            state_ = State::ID;
+            return false;
+
+        case State::ID:
+            id_ = byte;
+            checksum(byte);
+            state_ = State::LENGTH_LOW;
+            return false;
+
+        case State::LENGTH_LOW:
+            length_ = byte;
+            checksum(byte);
+            state_ = State::LENGTH_HIGH;
+            return false;
+
+        case State::LENGTH_HIGH:
+            length_ = static_cast<uint16_t>(length_ | (byte << 8));
+            checksum(byte);
+            received_ = 0;
+            state_ = length_ > 0 ? State::PAYLOAD : State::CHECK_A;
+            return false;
+
+        case State::PAYLOAD:
+            // Oversized frames are still checksummed so the stream stays in
+            // step, but only the first MAX_PAYLOAD bytes are kept
+            if (received_ < MAX_PAYLOAD) {
+                payload_[received_] = byte;
+            }
+            checksum(byte);
+            if (++received_ == length_) {
+                state_ = State::CHECK_A;
+            }
+            return false;
+
+        case State::CHECK_A:
+            if (byte != checkA_) {
+                stats_.checksumErrors++;
+                state_ = byte == SYNC_CHAR_1 ? State::SYNC2 : State::SYNC1;
+                frameStartNs_ = timestampNs;
+                return false;
+            }
+            state_ = State::CHECK_B;
+            return false;
+
+        case State::CHECK_B:
+            state_ = State::SYNC1;
+            if (byte != checkB_) {
+                stats_.checksumErrors++;
+                return false;
+            }
+            return endFrame();
+    }
+    return false;
+}
+
+bool UbxParser::endFrame() {
+    stats_.frames++;
+    if (length_ > MAX_PAYLOAD) {
+        stats_.oversized++;
+        return false;
+    }
+
+    if (class_ == CLASS_NAV && id_ == NAV_PVT && length_ == NAV_PVT_LENGTH) {
+        return decodeNavPvt();
+    }
+
+    if (class_ == CLASS_ACK && length_ == 2) {
+        lastAck_.messageClass = payload_[0];
+        lastAck_.messageId = payload_[1];
+        lastAck_.accepted = id_ == ACK_ACK;
+        stats_.acks++;
+    }
+    return false;
+}
+
+bool UbxParser::decodeNavPvt() {
+    const uint8_t* p = payload_;
+    const uint8_t fixType = p[PVT_FIX_TYPE];
+
+    GpsFix fix = fix_;
+    fix.fix = (p[PVT_FLAGS] & FLAG_GNSS_FIX_OK) &&
+              fixType >= FIX_2D && fixType <= FIX_GNSS_DEAD_RECKONING;
+    fix.satellites = p[PVT_NUM_SV];
+    fix.timestampNs = frameStartNs_;
+
+    // nano is a signed correction to the whole seconds, within +-1 s
+    int64_t ms = ((p[PVT_HOUR] * 60 + p[PVT_MIN]) * 60 + p[PVT_SEC]) * 1000LL +
+                 readI32(p + PVT_NANO) / 1000000;
+    fix.timeOfDayMs = static_cast<uint32_t>((ms + 86400000LL) % 86400000LL);
+
+    if (fix.fix) {
+        fix.latitude = readI32(p + PVT_LAT) * 1e-7;
+        fix.longitude = readI32(p + PVT_LON) * 1e-7;
+        fix.altitude = readI32(p + PVT_HMSL) * 1e-3f;
+        fix.horizontalAccuracy = readU32(p + PVT_H_ACC) * 1e-3f;
+        fix.verticalAccuracy = readU32(p + PVT_V_ACC) * 1e-3f;
+        fix.velocityNorth = readI32(p + PVT_VEL_N) * 1e-3f;
+        fix.velocityEast = readI32(p + PVT_VEL_E) * 1e-3f;
+        fix.velocityDown = readI32(p + PVT_VEL_D) * 1e-3f;
+        fix.speed = readI32(p + PVT_G_SPEED) * 1e-3f;
+        fix.course = readI32(p + PVT_HEAD_MOT) * 1e-5f;
+
+        // NAV-PVT only carries position DOP, which bounds HDOP from above
+        fix.hdop = readU16(p + PVT_PDOP) * 0.01f;
+    }
+
+    fix_ = fix;
+    stats_.fixes++;
+    return true;
+}
+
+size_t UbxParser::encode(uint8_t messageClass, uint8_t messageId, const uint8_t* payload,
+                         uint16_t length, uint8_t* out, size_t capacity) {
+    if (capacity < length + FRAME_OVERHEAD) return 0;
+
+    out[0] = SYNC_CHAR_1;
+    out[1] = SYNC_CHAR_2;
+    out[2] = messageClass;
+    out[3] = messageId;
+    out[4] = static_cast<uint8_t>(length & 0xFF);
+    out[5] = static_cast<uint8_t>(length >> 8);
+    if (length > 0) {
+        std::memcpy(out + 6, payload, length);
+    }
+
+    uint8_t checkA = 0;
+    uint8_t checkB = 0;
+    for (size_t i = 2; i < 6u + length; ++i) {
+        checkA = static_cast<uint8_t>(checkA + out[i]);
+        checkB = static_cast<uint8_t>(checkB + checkA);
+    }
+    out[6 + length] = checkA;
+    out[7 + length] = checkB;
+    return length + FRAME_OVERHEAD;
+}
+
+} // namespace sensors
+} // namespace drone
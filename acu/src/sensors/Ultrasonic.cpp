@@ -1,104 +1,168 @@
 #include "sensors/Ultrasonic.hpp"
-#include <wiringPi.h>
-#include <thread>
+#include "runtime/Clock.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace drone {
 namespace sensors {
 
+namespace {
+    constexpr const char* GPIO_CHIP = "/dev/gpiochip0";
+    constexpr size_t EVENT_BATCH = 8;
+}
+
 Ultrasonic::Ultrasonic(int triggerPin, int echoPin)
-    : triggerPin_(triggerPin)
-    , echoPin_(echoPin)
-    , lastDistance_(0.0f) {}
+    : trigger_(GPIO_CHIP, static_cast<unsigned int>(triggerPin))
+    , echo_(GPIO_CHIP, static_cast<unsigned int>(echoPin))
+    , state_(State::IDLE)
+    , triggerNs_(0)
+    , echoStartNs_(0)
+    , window_{}
+    , windowCount_(0)
+    , windowNext_(0)
+    , consecutiveOutliers_(0)
+    , sequence_(0) {}
 
 Ultrasonic::~Ultrasonic() {
-    cleanup();
+    trigger_.release();
+    echo_.release();
 }
 
 bool Ultrasonic::init() {
-    return setupGPIO();
+    // Trigger idles low; echo edges are queued with their timestamps
+    if (!trigger_.requestOutput(false, "ultrasonic-trigger")) {
+        return false;
+    }
+    return echo_.requestEdgeEvents("ultrasonic-echo");
 }
 
-bool Ultrasonic::setupGPIO() {
-    // Set pin modes
-    pinMode(triggerPin_, OUTPUT);
-    pinMode(echoPin_, INPUT);
+void Ultrasonic::trigger(int64_t nowNs) {
+    // A ping still inside its echo window is left to finish
+    if (state_ != State::IDLE && nowNs - triggerNs_ < ECHO_TIMEOUT_NS) {
+        return;
+    }
 
-    // Initialize trigger pin to low
-    digitalWrite(triggerPin_, LOW);
-    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    // Discard edges left over from an abandoned ping
+    drainEvents();
 
-    return true;
-}
+    // 10us pulse. This is the only wait in the cycle.
+    trigger_.setValue(true);
+    int64_t pulseEnd = runtime::monotonicNanoseconds() + TRIGGER_PULSE_NS;
+    while (runtime::monotonicNanoseconds() < pulseEnd) {
+    }
+    trigger_.setValue(false);
 
-void Ultrasonic::cleanup() {
-    // Reset pins to input mode
-    pinMode(triggerPin_, INPUT);
-    pinMode(echoPin_, INPUT);
+    triggerNs_ = nowNs;
+    state_ = State::WAITING_FOR_RISE;
+    stats_.pings++;
 }
 
-float Ultrasonic::getDistance() {
-    // Send trigger pulse
-    sendTrigger();
+bool Ultrasonic::poll(int64_t nowNs) {
+    if (state_ == State::IDLE) {
+        return false;
+    }
+
+    hal::GpioLine::EdgeEvent events[EVENT_BATCH];
+    size_t count;
+    while ((count = echo_.readEvents(events, EVENT_BATCH)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            const auto& event = events[i];
+            if (state_ == State::WAITING_FOR_RISE && event.edge == hal::GpioLine::Edge::RISING) {
+                echoStartNs_ = event.timestampNs;
+                state_ = State::WAITING_FOR_FALL;
+            } else if (state_ == State::WAITING_FOR_FALL &&
+                       event.edge == hal::GpioLine::Edge::FALLING) {
+                state_ = State::IDLE;
+                stats_.echoes++;
+
+                float distance = calculateDistance(event.timestampNs - echoStartNs_);
+                if (distance < MIN_DISTANCE || distance > MAX_DISTANCE) {
+                    stats_.outOfRange++;
+                    return false;
+                }
+
+                float filtered;
+                if (!filter(distance, filtered)) {
+                    stats_.outliers++;
+                    return false;
+                }
+
+                Measurement measurement;
+                measurement.distance = filtered;
+                measurement.timestampNs = echoStartNs_;
+                measurement.sequence = ++sequence_;
+                measurement.valid = true;
+                measurement_.store(measurement);
+                return true;
+            }
+        }
+    }
 
-    // Wait for echo and measure time
-    auto echoTime = waitForEcho();
+    if (nowNs - triggerNs_ >= ECHO_TIMEOUT_NS) {
+        // No echo: nothing in range. Keep the last value but mark it stale.
+        state_ = State::IDLE;
+        stats_.timeouts++;
 
-    // Calculate distance
-    lastDistance_ = calculateDistance(echoTime);
+        Measurement measurement = getMeasurement();
+        if (measurement.valid) {
+            measurement.valid = false;
+            measurement_.store(measurement);
+        }
+    }
+    return false;
+}
 
-    return lastDistance_;
+Ultrasonic::Measurement Ultrasonic::getMeasurement() const {
+    Measurement measurement;
+    uint32_t version = 0;
+    if (!measurement_.tryLoad(measurement, version)) {
+        return Measurement();
+    }
+    return measurement;
 }
 
-void Ultrasonic::sendTrigger() {
-    // Send 10us trigger pulse
-    digitalWrite(triggerPin_, HIGH);
-    delayMicroseconds(10);
-    digitalWrite(triggerPin_, LOW);
+void Ultrasonic::drainEvents() {
+    hal::GpioLine::EdgeEvent events[EVENT_BATCH];
+    while (echo_.readEvents(events, EVENT_BATCH) > 0) {
+    }
 }
 
-std::chrono::microseconds Ultrasonic::waitForEcho() {
-    using namespace std::chrono;
-
-    // Convert timeout to microseconds
-    auto timeoutUs = microseconds(static_cast<long>(TIMEOUT_SECONDS * 1e6));
-    
-    // Wait for echo to start
-    auto startWait = steady_clock::now();
-    while (digitalRead(echoPin_) == LOW) {
-        if (duration_cast<microseconds>(steady_clock::now() - startWait) > timeoutUs) {
-            return microseconds(0);
-        }
+bool Ultrasonic::filter(float distance, float& filtered) {
+    // Reject single readings far from the running median (multipath, crosstalk
+    // from other rangers). A run of them means the surface really moved.
+    if (windowCount_ == MEDIAN_WINDOW &&
+        std::fabs(distance - median()) > OUTLIER_THRESHOLD &&
+        ++consecutiveOutliers_ < OUTLIER_ACCEPT_COUNT) {
+        return false;
     }
 
-    // Measure echo pulse width
-    auto start = steady_clock::now();
-    while (digitalRead(echoPin_) == HIGH) {
-        if (duration_cast<microseconds>(steady_clock::now() - start) > timeoutUs) {
-            return microseconds(0);
-        }
+    if (consecutiveOutliers_ >= OUTLIER_ACCEPT_COUNT) {
+        windowCount_ = 0;  // Restart the window at the new level
+        windowNext_ = 0;
     }
-    auto end = steady_clock::now();
+    consecutiveOutliers_ = 0;
 
-    return duration_cast<microseconds>(end - start);
+    window_[windowNext_] = distance;
+    windowNext_ = (windowNext_ + 1) % MEDIAN_WINDOW;
+    windowCount_ = std::min(windowCount_ + 1, MEDIAN_WINDOW);
+
+    filtered = median();
+    return true;
 }
 
-float Ultrasonic::calculateDistance(std::chrono::microseconds echoTime) {
-    // Convert echo time to seconds
-    float seconds = echoTime.count() / 1e6f;
+float Ultrasonic::median() const {
+    // The window fills from index 0, so the first windowCount_ entries are live
+    std::array<float, MEDIAN_WINDOW> sorted = window_;
+    auto middle = sorted.begin() + windowCount_ / 2;
+    std::nth_element(sorted.begin(), middle, sorted.begin() + windowCount_);
+    return *middle;
+}
 
-    // Calculate distance using speed of sound
+float Ultrasonic::calculateDistance(int64_t echoNs) {
     // Divide by 2 because sound travels to target and back
-    float distance = (SPEED_OF_SOUND * seconds) / 2.0f;
-
-    // Clamp to valid range
-    if (distance < MIN_DISTANCE) {
-        return MIN_DISTANCE;
-    } else if (distance > MAX_DISTANCE) {
-        return MAX_DISTANCE;
-    }
-
-    return distance;
+    float seconds = static_cast<float>(echoNs) / 1e9f;
+    return (SPEED_OF_SOUND * seconds) / 2.0f;
 }
 
 } // namespace sensors
-} // namespace drone 
\ No newline at end of file
+} // namespace drone
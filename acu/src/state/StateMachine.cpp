@@ -1,4 +1,5 @@
 #include "state/StateMachine.hpp"
+#include <cmath>
 #include <iostream>
 
 namespace drone {
@@ -8,10 +9,12 @@ StateMachine::StateMachine()
     : flightController_(nullptr)
     , sensorManager_(nullptr)
     , commManager_(nullptr)
+    , geofence_(nullptr)
     , currentState_(State::INITIALIZING)
     , previousState_(State::INITIALIZING)
     , lastStateChange_(std::chrono::steady_clock::now())
-    , lastHeartbeat_(std::chrono::steady_clock::now()) {}
+    , lastHeartbeat_(std::chrono::steady_clock::now())
+    , geofenceWarned_(false) {}
 
 StateMachine::~StateMachine() {
     if (flightController_) {
@@ -19,14 +22,14 @@ StateMachine::~StateMachine() {
     }
 }
 
-void StateMachine::update() {
+void StateMachine::update(const sensors::SensorSnapshot& snapshot) {
     // Handle state-specific logic
     switch (currentState_) {
         case State::INITIALIZING:
             handleInitializing();
             break;
         case State::CALIBRATING:
-            handleCalibrating();
+            handleCalibrating(snapshot);
             break;
         case State::IDLE:
             handleIdle();
@@ -38,7 +41,7 @@ void StateMachine::update() {
             handleFlying();
             break;
         case State::EMERGENCY:
-            handleEmergency();
+            handleEmergency(snapshot);
             break;
         case State::ERROR:
             handleError();
@@ -47,8 +50,8 @@ void StateMachine::update() {
 
     // Check for emergency conditions in all states except EMERGENCY and ERROR
     if (currentState_ != State::EMERGENCY && currentState_ != State::ERROR) {
-        if (!checkSensors() || !checkCommunication() || 
-            !checkBattery() || !checkAttitude()) {
+        if (!checkSensors(snapshot) || !checkCommunication() ||
+            !checkBattery(snapshot) || !checkAttitude(snapshot) || !checkGeofence(snapshot)) {
             setState(State::EMERGENCY);
         }
     }
@@ -95,8 +98,8 @@ void StateMachine::handleInitializing() {
     }
 }
 
-void StateMachine::handleCalibrating() {
-    if (sensorManager_->isCalibrated()) {
+void StateMachine::handleCalibrating(const sensors::SensorSnapshot& snapshot) {
+    if (snapshot.calibrated) {
         setState(State::IDLE);
     }
 }
@@ -112,18 +115,17 @@ void StateMachine::handleArmed() {
 }
 
 void StateMachine::handleFlying() {
-    // Normal flight operations
-    flightController_->update();
+    // Normal flight operations; the control loops run as scheduler tasks
 }
 
-void StateMachine::handleEmergency() {
+void StateMachine::handleEmergency(const sensors::SensorSnapshot& snapshot) {
     static const auto emergencyStart = std::chrono::steady_clock::now();
     auto emergencyDuration = std::chrono::steady_clock::now() - emergencyStart;
 
     // After emergency timeout, check if we can recover
     if (emergencyDuration > EMERGENCY_RECOVERY_TIME) {
-        if (checkSensors() && checkCommunication() && 
-            checkBattery() && checkAttitude()) {
+        if (checkSensors(snapshot) && checkCommunication() &&
+            checkBattery(snapshot) && checkAttitude(snapshot)) {
             setState(State::IDLE);
         }
     }
@@ -133,9 +135,9 @@ void StateMachine::handleError() {
     // Terminal state - requires system restart
 }
 
-bool StateMachine::checkSensors() const {
+bool StateMachine::checkSensors(const sensors::SensorSnapshot& snapshot) const {
     if (!sensorManager_) return false;
-    return sensorManager_->isCalibrated();
+    return snapshot.calibrated;
 }
 
 bool StateMachine::checkCommunication() const {
@@ -147,17 +149,45 @@ bool StateMachine::checkCommunication() const {
     return heartbeatAge <= HEARTBEAT_TIMEOUT;
 }
 
-bool StateMachine::checkBattery() const {
+bool StateMachine::checkBattery(const sensors::SensorSnapshot& snapshot) const {
     if (!sensorManager_) return false;
-    return sensorManager_->getBatteryVoltage() >= MIN_BATTERY_VOLTAGE;
+    return snapshot.batteryVoltage >= MIN_BATTERY_VOLTAGE;
 }
 
-bool StateMachine::checkAttitude() const {
+bool StateMachine::checkAttitude(const sensors::SensorSnapshot& snapshot) const {
     if (!sensorManager_) return false;
-    
-    auto telemetry = sensorManager_->getTelemetryData();
-    return std::abs(telemetry.roll) <= MAX_SAFE_ANGLE &&
-           std::abs(telemetry.pitch) <= MAX_SAFE_ANGLE;
+
+    return std::abs(snapshot.roll) <= MAX_SAFE_ANGLE &&
+           std::abs(snapshot.pitch) <= MAX_SAFE_ANGLE;
+}
+
+bool StateMachine::checkGeofence(const sensors::SensorSnapshot& snapshot) {
+    // The grid is built off the control thread once home is known (see
+    // main.cpp); until then check() allows every position
+    if (!geofence_ || !geofence_->hasZones()) return true;
+
+    // Enforced in the air only; outside the fence on the ground is not an
+    // emergency and would block recovery
+    if (currentState_ != State::ARMED && currentState_ != State::FLYING) {
+        return true;
+    }
+
+    auto status = geofence_->check(snapshot.east, snapshot.north);
+    if (!status.inside) {
+        std::cerr << "Geofence breached at " << snapshot.east << " E, "
+                  << snapshot.north << " N" << std::endl;
+        return false;
+    }
+
+    if (status.distance < GEOFENCE_WARNING_DISTANCE) {
+        if (!geofenceWarned_) {
+            std::cerr << "Within " << GEOFENCE_WARNING_DISTANCE << " m of the geofence" << std::endl;
+            geofenceWarned_ = true;
+        }
+    } else {
+        geofenceWarned_ = false;
+    }
+    return true;
 }
 
 } // namespace state
@@ -0,0 +1,15 @@
+#include "topics/Topics.hpp"
+
+namespace drone {
+namespace topics {
+
+ImuRawTopic imuRaw("imu_raw");
+AttitudeTopic attitude("attitude");
+PositionTopic position("position");
+GpsFixTopic gpsFix("gps_fix");
+ControlSetpointTopic controlSetpoint("control_setpoint");
+ActuatorOutputsTopic actuatorOutputs("actuator_outputs");
+BatteryTopic battery("battery");
+
+} // namespace topics
+} // namespace drone
@@ -9,6 +9,7 @@ struct Config {
     std::string gcu_address;
     uint16_t gcu_port;
     uint16_t local_port;
+    std::string drone_id;        // Handshake identity, defaults to the machine id
 
     // WiFi settings
     uint8_t wifi_channel{6};     // Default to channel 6
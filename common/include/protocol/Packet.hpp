@@ -18,7 +18,12 @@ enum class PacketType : uint8_t {
     CONTROL = 0x01,
     TELEMETRY = 0x02,
     HEARTBEAT = 0x03,
-    CONFIG = 0x04
+    CONFIG = 0x04,
+    BEACON = 0x05,
+    SYN = 0x06,
+    ACK = 0x07,
+    SYNACK = 0x08,
+    SPECTRUM = 0x09
 };
 
 // Packet header structure
@@ -73,6 +78,11 @@ public:
     static Packet createTelemetry(const TelemetryData& data);
     static Packet createHeartbeat(const HeartbeatData& data);
     static Packet createConfig(const ConfigData& data);
+    static Packet createBeacon(const BeaconData& data);
+    static Packet createSyn(const SynData& data);
+    static Packet createAck(const AckData& data);
+    static Packet createSynAck(const SynAckData& data);
+    static Packet createSpectrum(const SpectrumData& data);
 
     // Deserialization
     static Packet deserialize(const uint8_t* data, size_t size);
@@ -90,6 +100,11 @@ public:
     const TelemetryData& getTelemetryData() const;
     const HeartbeatData& getHeartbeatData() const;
     const ConfigData& getConfigData() const;
+    const BeaconData& getBeaconData() const;
+    const SynData& getSynData() const;
+    const AckData& getAckData() const;
+    const SynAckData& getSynAckData() const;
+    const SpectrumData& getSpectrumData() const;
     
     // Serialization
     std::vector<uint8_t> serialize() const;
@@ -101,6 +116,11 @@ private:
     mutable TelemetryData telemetry_data_;
     mutable HeartbeatData heartbeat_data_;
     mutable ConfigData config_data_;
+    mutable BeaconData beacon_data_;
+    mutable SynData syn_data_;
+    mutable AckData ack_data_;
+    mutable SynAckData synack_data_;
+    mutable SpectrumData spectrum_data_;
     mutable bool data_deserialized_ = false;
 
     void deserializeDataIfNeeded() const;
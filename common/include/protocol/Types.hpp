@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
 #include <array>
 
 namespace drone {
@@ -68,5 +69,54 @@ struct ConfigData {
     uint8_t flags;          // Configuration flags
 };
 
+// Connection handshake (see docs/initialization_process.md)
+constexpr size_t DRONE_ID_LENGTH = 16;
+
+// Discovery beacon (ACU to GCU)
+struct BeaconData {
+    char drone_id[DRONE_ID_LENGTH];
+    uint32_t capabilities;    // Capability flags
+    uint16_t version;         // Firmware version
+    uint8_t signal_strength;  // Percentage
+};
+
+// Connection request (ACU to GCU)
+struct SynData {
+    char drone_id[DRONE_ID_LENGTH];
+    uint64_t request_token;   // Random per boot, generated by the drone
+    uint32_t capabilities;    // Capability flags (so SYN alone can open a session)
+    uint16_t version;         // Firmware version
+    uint8_t preferred_channel;
+};
+
+// Address assignment (GCU to ACU)
+struct AckData {
+    char drone_id[DRONE_ID_LENGTH];
+    uint32_t assigned_address; // IPv4, network byte order
+    uint64_t request_token;    // Echo of the SYN token
+    uint64_t session_token;    // Generated by the ground station
+    uint8_t channel;
+};
+
+// Connection confirmation (ACU to GCU)
+struct SynAckData {
+    char drone_id[DRONE_ID_LENGTH];
+    uint32_t address;          // IPv4, network byte order
+    uint64_t session_token;
+};
+
+// Gyro vibration spectrum for one axis (ACU to GCU)
+constexpr size_t SPECTRUM_BINS = 32;
+constexpr size_t SPECTRUM_PEAKS = 2;
+
+struct SpectrumData {
+    uint8_t axis;                           // 0 = roll, 1 = pitch, 2 = yaw
+    uint8_t peak_count;
+    float min_frequency;                    // Hz at the start of bin 0
+    float bin_width;                        // Hz per reported bin
+    float peak_frequency[SPECTRUM_PEAKS];   // Notch centres in Hz, 0 if unused
+    uint8_t magnitude[SPECTRUM_BINS];       // 0.5 dB steps above -60 dB re 1 deg/s
+};
+
 } // namespace protocol
 } // namespace drone 
\ No newline at end of file
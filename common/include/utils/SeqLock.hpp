@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace drone {
+namespace utils {
+
+// Single-writer sequence lock holding the latest value of a trivially
+// copyable type. The writer never blocks; readers retry while a write is in
+// progress. The payload is kept in atomic words so a torn read is detected
+// by the sequence check rather than being a data race.
+template<typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SeqLock requires a trivially copyable type");
+
+public:
+    SeqLock() : sequence_(0) {
+        for (auto& word : words_) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Writer side (one thread only)
+    void store(const T& value) {
+        uint64_t buffer[WORD_COUNT] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        uint32_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < WORD_COUNT; ++i) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    // Reader side. Fails if the writer kept the slot busy for maxAttempts
+    // reads; callers simply try again on their next cycle.
+    bool tryLoad(T& value, uint32_t& version, int maxAttempts = 16) const {
+        uint64_t buffer[WORD_COUNT];
+        for (int attempt = 0; attempt < maxAttempts; ++attempt) {
+            uint32_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;
+            }
+
+            for (size_t i = 0; i < WORD_COUNT; ++i) {
+                buffer[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (sequence_.load(std::memory_order_relaxed) == before) {
+                std::memcpy(&value, buffer, sizeof(T));
+                version = before / 2;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Number of completed writes
+    uint32_t version() const {
+        return sequence_.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> sequence_;
+    std::array<std::atomic<uint64_t>, WORD_COUNT> words_;
+};
+
+} // namespace utils
+} // namespace drone
@@ -71,6 +71,26 @@ Packet Packet::createConfig(const ConfigData& data) {
     return Packet(PacketType::CONFIG, serializeData(data));
 }
 
+Packet Packet::createBeacon(const BeaconData& data) {
+    return Packet(PacketType::BEACON, serializeData(data));
+}
+
+Packet Packet::createSyn(const SynData& data) {
+    return Packet(PacketType::SYN, serializeData(data));
+}
+
+Packet Packet::createAck(const AckData& data) {
+    return Packet(PacketType::ACK, serializeData(data));
+}
+
+Packet Packet::createSynAck(const SynAckData& data) {
+    return Packet(PacketType::SYNACK, serializeData(data));
+}
+
+Packet Packet::createSpectrum(const SpectrumData& data) {
+    return Packet(PacketType::SPECTRUM, serializeData(data));
+}
+
 Packet Packet::deserialize(const uint8_t* data, size_t size) {
     if (size < sizeof(PacketHeader)) {
         throw std::runtime_error("Packet too small");
@@ -126,6 +146,21 @@ void Packet::deserializeDataIfNeeded() const {
             case PacketType::CONFIG:
                 config_data_ = deserializeData<ConfigData>(payload_);
                 break;
+            case PacketType::BEACON:
+                beacon_data_ = deserializeData<BeaconData>(payload_);
+                break;
+            case PacketType::SYN:
+                syn_data_ = deserializeData<SynData>(payload_);
+                break;
+            case PacketType::ACK:
+                ack_data_ = deserializeData<AckData>(payload_);
+                break;
+            case PacketType::SYNACK:
+                synack_data_ = deserializeData<SynAckData>(payload_);
+                break;
+            case PacketType::SPECTRUM:
+                spectrum_data_ = deserializeData<SpectrumData>(payload_);
+                break;
         }
         data_deserialized_ = true;
     }
@@ -175,6 +210,61 @@ const ConfigData& Packet::getConfigData() const {
     return config_data_;
 }
 
+const BeaconData& Packet::getBeaconData() const {
+    if (header_.type != PacketType::BEACON) {
+        throw std::runtime_error("Packet is not a beacon packet");
+    }
+    if (payload_.size() != sizeof(BeaconData)) {
+        throw std::runtime_error("Invalid beacon data size");
+    }
+    deserializeDataIfNeeded();
+    return beacon_data_;
+}
+
+const SynData& Packet::getSynData() const {
+    if (header_.type != PacketType::SYN) {
+        throw std::runtime_error("Packet is not a SYN packet");
+    }
+    if (payload_.size() != sizeof(SynData)) {
+        throw std::runtime_error("Invalid SYN data size");
+    }
+    deserializeDataIfNeeded();
+    return syn_data_;
+}
+
+const AckData& Packet::getAckData() const {
+    if (header_.type != PacketType::ACK) {
+        throw std::runtime_error("Packet is not an ACK packet");
+    }
+    if (payload_.size() != sizeof(AckData)) {
+        throw std::runtime_error("Invalid ACK data size");
+    }
+    deserializeDataIfNeeded();
+    return ack_data_;
+}
+
+const SynAckData& Packet::getSynAckData() const {
+    if (header_.type != PacketType::SYNACK) {
+        throw std::runtime_error("Packet is not a SYNACK packet");
+    }
+    if (payload_.size() != sizeof(SynAckData)) {
+        throw std::runtime_error("Invalid SYNACK data size");
+    }
+    deserializeDataIfNeeded();
+    return synack_data_;
+}
+
+const SpectrumData& Packet::getSpectrumData() const {
+    if (header_.type != PacketType::SPECTRUM) {
+        throw std::runtime_error("Packet is not a spectrum packet");
+    }
+    if (payload_.size() != sizeof(SpectrumData)) {
+        throw std::runtime_error("Invalid spectrum data size");
+    }
+    deserializeDataIfNeeded();
+    return spectrum_data_;
+}
+
 std::vector<uint8_t> Packet::serialize() const {
     std::vector<uint8_t> buffer(sizeof(PacketHeader) + payload_.size());
     
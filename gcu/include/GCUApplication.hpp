@@ -1,7 +1,16 @@
 #pragma once
 
+#include "protocol/Packet.hpp"
+#include "communication/TelemetryStore.hpp"
 #include <QApplication>
+#include <array>
+#include <map>
 #include <memory>
+#include <string>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
 
 namespace drone {
 namespace gcu {
@@ -25,8 +34,20 @@ private:
     std::unique_ptr<ui::MainWindow> mainWindow_;
     std::unique_ptr<communication::CommunicationManager> commManager_;
     std::unique_ptr<control::InputManager> inputManager_;
+    QTimer* telemetryTimer_;
+    QTimer* statisticsTimer_;
+
+    // Slot to drone ID, refreshed when a drone connects or drops
+    std::map<size_t, std::string> telemetrySlots_;
+    std::map<size_t, protocol::TelemetryData> latestTelemetry_;
+    std::map<size_t, std::array<protocol::SpectrumData,
+                                communication::TelemetryStore::SPECTRUM_AXES>> latestSpectrum_;
 
     void setupConnections();
+    void setupTelemetryTimer();
+    void refreshTelemetrySlots();
+    void pollTelemetry();
+    void reportStatistics();
     void updateTelemetry(const protocol::TelemetryData& telemetry);
     void updateConnectionStatus(bool connected);
 };
@@ -1,17 +1,24 @@
 #pragma once
 
 #include "protocol/Packet.hpp"
+#include "communication/TelemetryStore.hpp"
+#include "communication/ControlPacer.hpp"
 #include <QObject>
+#include <QThread>
+#include <netinet/in.h>
 #include <string>
 #include <memory>
-#include <thread>
 #include <atomic>
 #include <mutex>
-#include <queue>
 #include <chrono>
 #include <map>
 #include <vector>
 
+QT_BEGIN_NAMESPACE
+class QSocketNotifier;
+class QTimer;
+QT_END_NAMESPACE
+
 namespace drone {
 namespace gcu {
 namespace communication {
@@ -31,13 +38,16 @@ public:
 
     struct DroneInfo {
         std::string id;
-        uint32_t capabilities;
-        uint16_t version;
-        uint8_t signal_strength;
+        uint32_t capabilities{0};
+        uint16_t version{0};
+        uint8_t signal_strength{0};
         std::string address;
-        ConnectionState state;
+        ConnectionState state{ConnectionState::DISCONNECTED};
         std::chrono::steady_clock::time_point last_seen;
-        uint64_t token;
+        uint64_t token{0};
+        uint64_t request_token{0};
+        struct sockaddr_in endpoint{};
+        size_t telemetry_slot{0};
     };
 
     explicit CommunicationManager(QObject* parent = nullptr);
@@ -46,31 +56,53 @@ public:
     bool init();
     void start();
     void stop();
-    bool isConnected() const { return !active_drones_.empty(); }
+
+    // Run the network thread at QThread::TimeCriticalPriority
+    void setHighPriority(bool enabled);
+
+    // Control uplink rate, clamped to 50-250Hz
+    void setControlRate(double hz) { control_pacer_->setRate(hz); }
+    ControlPacer::Statistics getControlStatistics() const { return control_pacer_->getStatistics(); }
+    bool isConnected() const { return connected_; }
     void sendControlData(const protocol::ControlData& controlData);
 
+    // Latest telemetry per drone, polled by the UI at display rate
+    TelemetryStore& telemetryStore() { return telemetry_store_; }
+    // Telemetry slot to drone ID for every connected drone
+    std::map<size_t, std::string> getTelemetrySlots();
+
 signals:
-    void telemetryReceived(const drone::protocol::TelemetryData& telemetry);
     void connectionStatusChanged(bool connected);
     void droneDiscovered(const std::string& id, uint32_t capabilities);
     void droneConnected(const std::string& id, const std::string& address);
     void droneDisconnected(const std::string& id);
 
+private slots:
+    void onThreadStarted();
+    void onSocketReadable();
+    void onHeartbeatTimer();
+    void onDiscoveryTimer();
+
 private:
     int socket_fd_;
     uint16_t drone_port_ = 14550;  // Default drone port
     uint16_t local_port_ = 14551;  // Default local port
     std::string drone_address_ = "127.0.0.1";  // Default loopback address
     std::atomic<bool> running_;
-    std::unique_ptr<std::thread> receive_thread_;
-    std::unique_ptr<std::thread> discovery_thread_;
+    bool high_priority_;
+
+    // Network thread; the notifier and timers below live on it
+    std::unique_ptr<QThread> network_thread_;
+    QSocketNotifier* read_notifier_;
+    QTimer* heartbeat_timer_;
+    QTimer* discovery_timer_;
+    ControlPacer* control_pacer_;
     
     std::mutex drones_mutex_;
     std::map<std::string, DroneInfo> discovered_drones_;
     std::map<std::string, DroneInfo> active_drones_;
     
-    std::mutex send_mutex_;
-    std::queue<protocol::Packet> outgoing_packets_;
+    TelemetryStore telemetry_store_;
 
     // Connection state
     std::atomic<bool> connected_;
@@ -78,13 +110,18 @@ private:
     static constexpr auto HEARTBEAT_INTERVAL = std::chrono::milliseconds(100);
     static constexpr auto HEARTBEAT_TIMEOUT = std::chrono::milliseconds(500);
 
-    void discoveryLoop();
-    void receiveLoop();
-    void handleIncomingPacket(const protocol::Packet& packet);
-    void handleBeacon(const std::vector<uint8_t>& data);
-    void handleSyn(const std::vector<uint8_t>& data);
-    void handleSynAck(const std::vector<uint8_t>& data);
+    void onThreadStopping();
+    void handleIncomingPacket(const protocol::Packet& packet, const struct sockaddr_in& sender);
+    void handleBeacon(const protocol::BeaconData& beacon, const struct sockaddr_in& sender);
+    void handleSyn(const protocol::SynData& syn, const struct sockaddr_in& sender);
+    void handleSynAck(const protocol::SynAckData& synack, const struct sockaddr_in& sender);
     void sendAck(const DroneInfo& drone);
+    void sendTo(const protocol::Packet& packet, const struct sockaddr_in& endpoint);
+    void sendToDrones(const protocol::Packet& packet);
+    // Telemetry slot of the sender's session, NO_SLOT without one
+    static constexpr size_t NO_SLOT = TelemetryStore::MAX_DRONES;
+    size_t touchDrone(const struct sockaddr_in& sender);
+    size_t allocateTelemetrySlot() const;
     void validateConnections();
     void sendHeartbeat();
     bool setupSocket();
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "protocol/Packet.hpp"
+#include "utils/SeqLock.hpp"
+#include <QObject>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+namespace drone {
+namespace gcu {
+namespace communication {
+
+// Fixed-rate control uplink. Holds a single latest-command slot that the GUI
+// thread overwrites; the network thread transmits whatever is in the slot on
+// absolute deadlines. Superseded commands are dropped, never queued. A large
+// stick movement or an arm/emergency change is sent straight away.
+class ControlPacer : public QObject {
+    Q_OBJECT
+
+public:
+    using SendFunction = std::function<void(const protocol::ControlData&)>;
+
+    struct Statistics {
+        uint64_t submitted{0};   // Commands written into the slot
+        uint64_t sent{0};        // Packets transmitted
+        uint64_t superseded{0};  // Commands replaced before being sent
+        uint64_t immediate{0};   // Out-of-schedule sends for large changes
+        uint64_t late{0};        // Deadlines missed by more than a period
+    };
+
+    static constexpr double MIN_RATE_HZ = 50.0;
+    static constexpr double MAX_RATE_HZ = 250.0;
+    static constexpr double DEFAULT_RATE_HZ = 100.0;
+
+    explicit ControlPacer(SendFunction send, QObject* parent = nullptr);
+    ~ControlPacer();
+
+    // Any thread
+    void setRate(double hz);
+    double getRate() const { return rate_hz_; }
+    Statistics getStatistics() const;
+
+    // GUI thread (single writer)
+    void submit(const protocol::ControlData& controlData);
+
+    // Thread the pacer lives on
+    void start();
+    void stop();
+
+private slots:
+    void onDeadline();
+    void transmitNow();
+
+private:
+    SendFunction send_;
+    std::atomic<double> rate_hz_;
+
+    // Latest command, written by the GUI and read at each deadline
+    utils::SeqLock<protocol::ControlData> latest_;
+    // Last command transmitted, written by the pacer thread
+    utils::SeqLock<protocol::ControlData> last_sent_;
+    std::atomic<bool> wake_pending_;
+
+    // Pacer thread state
+    QTimer* timer_;
+    std::chrono::steady_clock::time_point next_deadline_;
+    uint32_t last_sent_version_;
+
+    std::atomic<uint64_t> submitted_;
+    std::atomic<uint64_t> sent_;
+    std::atomic<uint64_t> superseded_;
+    std::atomic<uint64_t> immediate_;
+    std::atomic<uint64_t> late_;
+
+    void transmit();
+    void scheduleNext();
+    std::chrono::nanoseconds period() const;
+    static bool isLargeChange(const protocol::ControlData& previous,
+                              const protocol::ControlData& current);
+
+    static constexpr int LARGE_CHANGE_THRESHOLD = 205;  // ~5% of the 0-4095 stick range
+};
+
+} // namespace communication
+} // namespace gcu
+} // namespace drone
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "protocol/Packet.hpp"
+#include "utils/SeqLock.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace drone {
+namespace gcu {
+namespace communication {
+
+// Latest telemetry per drone, written by the network thread and read by a
+// UI timer. Packets arriving faster than the UI polls overwrite each other
+// instead of queueing events in the Qt loop.
+class TelemetryStore {
+public:
+    static constexpr size_t MAX_DRONES = 8;
+    static constexpr size_t SPECTRUM_AXES = 3;
+
+    struct Statistics {
+        uint64_t received{0};   // Packets written by the network thread
+        uint64_t delivered{0};  // Snapshots handed to the UI
+        uint64_t coalesced{0};  // Packets overwritten before the UI saw them
+    };
+
+    TelemetryStore() = default;
+
+    // Network thread
+    void publish(size_t slot, const protocol::TelemetryData& telemetry);
+
+    // UI thread: true if a newer snapshot than the last one consumed exists
+    bool consume(size_t slot, protocol::TelemetryData& telemetry);
+    Statistics getStatistics(size_t slot) const;
+
+    // Gyro spectrum, one snapshot per axis, same single-writer/single-reader split
+    void publishSpectrum(size_t slot, const protocol::SpectrumData& spectrum);
+    bool consumeSpectrum(size_t slot, size_t axis, protocol::SpectrumData& spectrum);
+
+private:
+    struct Slot {
+        utils::SeqLock<protocol::TelemetryData> latest;
+        std::atomic<uint64_t> received{0};
+
+        // Reader-owned
+        uint32_t lastVersion{0};
+        uint64_t delivered{0};
+        uint64_t coalesced{0};
+
+        utils::SeqLock<protocol::SpectrumData> spectrum[SPECTRUM_AXES];
+        uint32_t lastSpectrumVersion[SPECTRUM_AXES]{};
+    };
+
+    std::array<Slot, MAX_DRONES> slots_;
+};
+
+} // namespace communication
+} // namespace gcu
+} // namespace drone
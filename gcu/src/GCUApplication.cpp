@@ -3,13 +3,22 @@
 #include "ui/MainWindow.hpp"
 #include "control/InputManager.hpp"
 #include <QTimer>
+#include <QScreen>
 #include <iostream>
 
 namespace drone {
 namespace gcu {
 
+namespace {
+    constexpr double DEFAULT_REFRESH_RATE = 60.0;  // Hz, if the screen does not report one
+    constexpr int STATISTICS_INTERVAL_MS = 5000;
+    constexpr const char* AXIS_NAMES[] = {"roll", "pitch", "yaw"};
+}
+
 GCUApplication::GCUApplication(int argc, char* argv[])
-    : app_(std::make_unique<QApplication>(argc, argv)) {
+    : app_(std::make_unique<QApplication>(argc, argv))
+    , telemetryTimer_(nullptr)
+    , statisticsTimer_(nullptr) {
 }
 
 GCUApplication::~GCUApplication() {
@@ -35,8 +44,22 @@ bool GCUApplication::init() {
 
     // Setup connections
     setupConnections();
+    setupTelemetryTimer();
 
     // Start communication
+    const QStringList arguments = app_->arguments();
+    commManager_->setHighPriority(arguments.contains("--high-priority"));
+
+    int rateIndex = arguments.indexOf("--control-rate");
+    if (rateIndex >= 0) {
+        bool ok = false;
+        double rate = rateIndex + 1 < arguments.size() ? arguments[rateIndex + 1].toDouble(&ok) : 0.0;
+        if (ok && rate > 0.0) {
+            commManager_->setControlRate(rate);
+        } else {
+            std::cerr << "Invalid --control-rate, using the default" << std::endl;
+        }
+    }
     commManager_->start();
 
     // Show main window
@@ -61,17 +84,20 @@ void GCUApplication::shutdown() {
 }
 
 void GCUApplication::setupConnections() {
-    // Connect telemetry updates
-    QObject::connect(commManager_.get(), &communication::CommunicationManager::telemetryReceived,
-            mainWindow_.get(), &ui::MainWindow::updateTelemetry);
-
     // Connect connection status updates
     QObject::connect(commManager_.get(), &communication::CommunicationManager::connectionStatusChanged,
             mainWindow_.get(), &ui::MainWindow::updateConnectionStatus);
 
-    // Connect control inputs
+    // Track which telemetry slot belongs to which drone
+    QObject::connect(commManager_.get(), &communication::CommunicationManager::droneConnected,
+            app_.get(), [this](const std::string&, const std::string&) { refreshTelemetrySlots(); });
+    QObject::connect(commManager_.get(), &communication::CommunicationManager::droneDisconnected,
+            app_.get(), [this](const std::string&) { refreshTelemetrySlots(); });
+
+    // Connect control inputs (called on the GUI thread, not queued to the network thread)
     QObject::connect(inputManager_.get(), &control::InputManager::controlDataChanged,
-            commManager_.get(), &communication::CommunicationManager::sendControlData);
+            commManager_.get(), &communication::CommunicationManager::sendControlData,
+            Qt::DirectConnection);
 
     // Connect arming and emergency stop
     QObject::connect(mainWindow_.get(), &ui::MainWindow::armingRequested,
@@ -89,6 +115,106 @@ void GCUApplication::setupConnections() {
             });
 }
 
+void GCUApplication::setupTelemetryTimer() {
+    // Telemetry is pulled once per display frame rather than pushed per packet
+    double refreshRate = DEFAULT_REFRESH_RATE;
+    if (QScreen* screen = QGuiApplication::primaryScreen()) {
+        if (screen->refreshRate() > 0) {
+            refreshRate = screen->refreshRate();
+        }
+    }
+
+    telemetryTimer_ = new QTimer(app_.get());
+    telemetryTimer_->setTimerType(Qt::PreciseTimer);
+    QObject::connect(telemetryTimer_, &QTimer::timeout, [this]() { pollTelemetry(); });
+    telemetryTimer_->start(static_cast<int>(1000.0 / refreshRate));
+
+    statisticsTimer_ = new QTimer(app_.get());
+    QObject::connect(statisticsTimer_, &QTimer::timeout, [this]() { reportStatistics(); });
+    statisticsTimer_->start(STATISTICS_INTERVAL_MS);
+}
+
+void GCUApplication::refreshTelemetrySlots() {
+    telemetrySlots_ = commManager_->getTelemetrySlots();
+    for (auto it = latestTelemetry_.begin(); it != latestTelemetry_.end();) {
+        if (telemetrySlots_.count(it->first) == 0) {
+            it = latestTelemetry_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = latestSpectrum_.begin(); it != latestSpectrum_.end();) {
+        if (telemetrySlots_.count(it->first) == 0) {
+            it = latestSpectrum_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void GCUApplication::pollTelemetry() {
+    // Every connected drone is drained each frame; the first one connected
+    // (lowest slot) is the one shown in the main window
+    auto& store = commManager_->telemetryStore();
+    for (const auto& entry : telemetrySlots_) {
+        for (size_t axis = 0; axis < communication::TelemetryStore::SPECTRUM_AXES; ++axis) {
+            protocol::SpectrumData spectrum;
+            if (store.consumeSpectrum(entry.first, axis, spectrum)) {
+                latestSpectrum_[entry.first][axis] = spectrum;
+            }
+        }
+
+        protocol::TelemetryData telemetry;
+        if (!store.consume(entry.first, telemetry)) {
+            continue;
+        }
+        latestTelemetry_[entry.first] = telemetry;
+        if (entry.first == telemetrySlots_.begin()->first) {
+            updateTelemetry(telemetry);
+        }
+    }
+}
+
+void GCUApplication::reportStatistics() {
+    auto control = commManager_->getControlStatistics();
+    std::cout << "Control uplink: " << control.sent << " sent, "
+              << control.superseded << " superseded, "
+              << control.immediate << " immediate, "
+              << control.late << " late" << std::endl;
+
+    auto& store = commManager_->telemetryStore();
+    for (const auto& entry : telemetrySlots_) {
+        auto stats = store.getStatistics(entry.first);
+        std::cout << "Drone " << entry.second << ": "
+                  << stats.received << " telemetry received, "
+                  << stats.delivered << " delivered, "
+                  << stats.coalesced << " coalesced";
+        auto latest = latestTelemetry_.find(entry.first);
+        if (latest != latestTelemetry_.end()) {
+            std::cout << ", altitude " << latest->second.altitude << " m"
+                      << ", battery " << latest->second.battery_voltage << " V";
+        }
+        std::cout << std::endl;
+
+        // Gyro vibration peaks the ACU is notching, per axis
+        auto spectrum = latestSpectrum_.find(entry.first);
+        if (spectrum == latestSpectrum_.end()) {
+            continue;
+        }
+        for (size_t axis = 0; axis < communication::TelemetryStore::SPECTRUM_AXES; ++axis) {
+            const protocol::SpectrumData& data = spectrum->second[axis];
+            std::cout << "  " << AXIS_NAMES[axis] << " vibration peaks:";
+            if (data.peak_count == 0) {
+                std::cout << " none";
+            }
+            for (size_t i = 0; i < data.peak_count && i < protocol::SPECTRUM_PEAKS; ++i) {
+                std::cout << " " << data.peak_frequency[i] << " Hz";
+            }
+            std::cout << std::endl;
+        }
+    }
+}
+
 void GCUApplication::updateTelemetry(const protocol::TelemetryData& telemetry) {
     mainWindow_->updateTelemetry(telemetry);
 }
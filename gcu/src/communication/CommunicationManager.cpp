@@ -1,10 +1,15 @@
 #include "communication/CommunicationManager.hpp"
+#include <QMetaType>
+#include <QSocketNotifier>
+#include <QTimer>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <random>
 #include <sstream>
@@ -17,8 +22,13 @@ CommunicationManager::CommunicationManager(QObject* parent)
     : QObject(parent)
     , socket_fd_(-1)
     , running_(false)
-    , receive_thread_(nullptr)
-    , discovery_thread_(nullptr)
+    , high_priority_(false)
+    , read_notifier_(nullptr)
+    , heartbeat_timer_(nullptr)
+    , discovery_timer_(nullptr)
+    , control_pacer_(new ControlPacer([this](const protocol::ControlData& controlData) {
+          sendToDrones(protocol::Packet::createControl(controlData));
+      }, this))
     , connected_(false)
     , last_heartbeat_(std::chrono::steady_clock::now()) {
 }
@@ -38,97 +48,145 @@ void CommunicationManager::start() {
     if (running_) return;
     
     running_ = true;
-    receive_thread_ = std::make_unique<std::thread>(&CommunicationManager::receiveLoop, this);
-    discovery_thread_ = std::make_unique<std::thread>(&CommunicationManager::discoveryLoop, this);
+
+    // Signals cross from the network thread to the GUI thread as queued events
+    qRegisterMetaType<std::string>("std::string");
+
+    // Everything below runs on the network thread's event loop: the socket
+    // notifier wakes it for datagrams and the timers for periodic work
+    network_thread_ = std::make_unique<QThread>();
+    network_thread_->setObjectName("gcu-network");
+    moveToThread(network_thread_.get());
+    connect(network_thread_.get(), &QThread::started,
+            this, &CommunicationManager::onThreadStarted, Qt::DirectConnection);
+    network_thread_->start(high_priority_ ? QThread::TimeCriticalPriority
+                                          : QThread::InheritPriority);
 }
 
 void CommunicationManager::stop() {
     if (!running_) return;
     
     running_ = false;
-    if (receive_thread_ && receive_thread_->joinable()) {
-        receive_thread_->join();
-    }
-    if (discovery_thread_ && discovery_thread_->joinable()) {
-        discovery_thread_->join();
+    if (network_thread_) {
+        // Notifier and timers must be destroyed on the thread that owns them
+        QMetaObject::invokeMethod(this, [this]() { onThreadStopping(); },
+                                  Qt::BlockingQueuedConnection);
+        network_thread_->quit();
+        network_thread_->wait();
     }
     closeSocket();
 }
 
+void CommunicationManager::setHighPriority(bool enabled) {
+    high_priority_ = enabled;
+    if (network_thread_ && network_thread_->isRunning()) {
+        network_thread_->setPriority(enabled ? QThread::TimeCriticalPriority
+                                             : QThread::InheritPriority);
+    }
+}
+
 void CommunicationManager::sendControlData(const protocol::ControlData& controlData) {
-    protocol::Packet control = protocol::Packet::createControl(controlData);
-    std::lock_guard<std::mutex> lock(send_mutex_);
-    outgoing_packets_.push(control);
+    // Only replaces the pending command; the pacer owns transmission
+    control_pacer_->submit(controlData);
+}
+
+void CommunicationManager::onThreadStarted() {
+    read_notifier_ = new QSocketNotifier(socket_fd_, QSocketNotifier::Read, this);
+    connect(read_notifier_, &QSocketNotifier::activated,
+            this, &CommunicationManager::onSocketReadable);
+
+    heartbeat_timer_ = new QTimer(this);
+    heartbeat_timer_->setTimerType(Qt::PreciseTimer);
+    connect(heartbeat_timer_, &QTimer::timeout, this, &CommunicationManager::onHeartbeatTimer);
+    heartbeat_timer_->start(static_cast<int>(HEARTBEAT_INTERVAL.count()));
+
+    discovery_timer_ = new QTimer(this);
+    connect(discovery_timer_, &QTimer::timeout, this, &CommunicationManager::onDiscoveryTimer);
+    discovery_timer_->start(static_cast<int>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(DISCOVERY_INTERVAL).count()));
+
+    control_pacer_->start();
+}
+
+void CommunicationManager::onThreadStopping() {
+    control_pacer_->stop();
+    delete read_notifier_;
+    read_notifier_ = nullptr;
+    delete heartbeat_timer_;
+    heartbeat_timer_ = nullptr;
+    delete discovery_timer_;
+    discovery_timer_ = nullptr;
 }
 
-void CommunicationManager::receiveLoop() {
-    std::vector<uint8_t> buffer(MAX_PACKET_SIZE);
+void CommunicationManager::onSocketReadable() {
+    uint8_t buffer[MAX_PACKET_SIZE];
     struct sockaddr_in sender_addr;
-    socklen_t sender_len = sizeof(sender_addr);
-    
-    auto lastHeartbeat = std::chrono::steady_clock::now();
-    
-    while (running_) {
-        // Send heartbeat periodically
-        auto now = std::chrono::steady_clock::now();
-        if (now - last_heartbeat_ >= HEARTBEAT_INTERVAL) {
-            sendHeartbeat();
-            last_heartbeat_ = now;
-        }
-        
-        // Send any queued packets
-        {
-            std::lock_guard<std::mutex> lock(send_mutex_);
-            while (!outgoing_packets_.empty()) {
-                const auto& packet = outgoing_packets_.front();
-                std::vector<uint8_t> data = packet.serialize();
-                
-                struct sockaddr_in dest_addr;
-                dest_addr.sin_family = AF_INET;
-                dest_addr.sin_port = htons(drone_port_);
-                inet_pton(AF_INET, drone_address_.c_str(), &dest_addr.sin_addr);
-                
-                sendto(socket_fd_, data.data(), data.size(), 0,
-                      (struct sockaddr*)&dest_addr, sizeof(dest_addr));
-                      
-                outgoing_packets_.pop();
+
+    // Drain everything queued on the socket, the notifier is level triggered
+    while (true) {
+        socklen_t sender_len = sizeof(sender_addr);
+        ssize_t bytes_received = recvfrom(socket_fd_, buffer, sizeof(buffer), 0,
+                                        (struct sockaddr*)&sender_addr, &sender_len);
+        if (bytes_received <= 0) {
+            if (bytes_received < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "Error receiving data: " << strerror(errno) << std::endl;
             }
+            break;
         }
-        
-        // Receive incoming packets
-        ssize_t bytes_received = recvfrom(socket_fd_, buffer.data(), buffer.size(), 0,
-                                        (struct sockaddr*)&sender_addr, &sender_len);
-                                        
-        if (bytes_received > 0) {
-            try {
-                protocol::Packet packet = protocol::Packet::deserialize(buffer.data(), bytes_received);
-                if (packet.validate()) {
-                    handleIncomingPacket(packet);
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "Error processing received packet: " << e.what() << std::endl;
+
+        try {
+            protocol::Packet packet = protocol::Packet::deserialize(buffer, bytes_received);
+            if (packet.validate()) {
+                handleIncomingPacket(packet, sender_addr);
             }
-        } else if (bytes_received < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
-            std::cerr << "Error receiving data: " << strerror(errno) << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error processing received packet: " << e.what() << std::endl;
         }
-        
-        validateConnections();
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
 }
 
-void CommunicationManager::handleIncomingPacket(const protocol::Packet& packet) {
+void CommunicationManager::onHeartbeatTimer() {
+    sendHeartbeat();
+    validateConnections();
+}
+
+void CommunicationManager::handleIncomingPacket(const protocol::Packet& packet,
+                                                const struct sockaddr_in& sender) {
     switch (packet.getType()) {
+        case protocol::PacketType::BEACON:
+            handleBeacon(packet.getBeaconData(), sender);
+            break;
+
+        case protocol::PacketType::SYN:
+            handleSyn(packet.getSynData(), sender);
+            break;
+
+        case protocol::PacketType::SYNACK:
+            handleSynAck(packet.getSynAckData(), sender);
+            break;
+
         case protocol::PacketType::TELEMETRY:
-            emit telemetryReceived(packet.getTelemetryData());
+            // No Qt event per packet; the UI picks up the latest at its own rate
+            {
+                size_t slot = touchDrone(sender);
+                if (slot != NO_SLOT) {
+                    telemetry_store_.publish(slot, packet.getTelemetryData());
+                }
+            }
+            break;
+
+        case protocol::PacketType::SPECTRUM:
+            {
+                size_t slot = touchDrone(sender);
+                if (slot != NO_SLOT) {
+                    telemetry_store_.publishSpectrum(slot, packet.getSpectrumData());
+                }
+            }
             break;
             
         case protocol::PacketType::HEARTBEAT:
+            touchDrone(sender);
             last_heartbeat_ = std::chrono::steady_clock::now();
-            if (!connected_) {
-                connected_ = true;
-                emit connectionStatusChanged(true);
-            }
             break;
             
         default:
@@ -142,9 +200,31 @@ void CommunicationManager::sendHeartbeat() {
         std::chrono::system_clock::now().time_since_epoch()
     ).count();
     
-    auto packet = protocol::Packet::createHeartbeat(heartbeat);
-    std::lock_guard<std::mutex> lock(send_mutex_);
-    outgoing_packets_.push(packet);
+    sendToDrones(protocol::Packet::createHeartbeat(heartbeat));
+}
+
+void CommunicationManager::sendToDrones(const protocol::Packet& packet) {
+    // Every connected drone, or the default address while nothing has
+    // completed the handshake
+    std::vector<struct sockaddr_in> endpoints;
+    {
+        std::lock_guard<std::mutex> lock(drones_mutex_);
+        for (const auto& entry : active_drones_) {
+            endpoints.push_back(entry.second.endpoint);
+        }
+    }
+    if (endpoints.empty()) {
+        struct sockaddr_in dest_addr;
+        std::memset(&dest_addr, 0, sizeof(dest_addr));
+        dest_addr.sin_family = AF_INET;
+        dest_addr.sin_port = htons(drone_port_);
+        inet_pton(AF_INET, drone_address_.c_str(), &dest_addr.sin_addr);
+        endpoints.push_back(dest_addr);
+    }
+
+    for (const auto& endpoint : endpoints) {
+        sendTo(packet, endpoint);
+    }
 }
 
 void CommunicationManager::validateConnections() {
@@ -160,7 +240,8 @@ void CommunicationManager::validateConnections() {
         }
     }
     
-    if (active_drones_.empty()) {
+    if (active_drones_.empty() && connected_) {
+        connected_ = false;
         emit connectionStatusChanged(false);
     }
 }
@@ -198,103 +279,190 @@ void CommunicationManager::closeSocket() {
     }
 }
 
-void CommunicationManager::discoveryLoop() {
-    while (running_) {
-        // Clean up old discovered drones
-        {
-            std::lock_guard<std::mutex> lock(drones_mutex_);
-            auto now = std::chrono::steady_clock::now();
-            for (auto it = discovered_drones_.begin(); it != discovered_drones_.end();) {
-                if (now - it->second.last_seen > CONNECTION_TIMEOUT) {
-                    it = discovered_drones_.erase(it);
-                } else {
-                    ++it;
-                }
+void CommunicationManager::onDiscoveryTimer() {
+    // Clean up old discovered drones
+    {
+        std::lock_guard<std::mutex> lock(drones_mutex_);
+        auto now = std::chrono::steady_clock::now();
+        for (auto it = discovered_drones_.begin(); it != discovered_drones_.end();) {
+            if (now - it->second.last_seen > CONNECTION_TIMEOUT) {
+                it = discovered_drones_.erase(it);
+            } else {
+                ++it;
             }
         }
-
-        // Validate active connections
-        validateConnections();
-
-        std::this_thread::sleep_for(DISCOVERY_INTERVAL);
     }
 }
 
-void CommunicationManager::handleBeacon(const std::vector<uint8_t>& data) {
-    // Parse beacon data (ID, capabilities, version)
-    if (data.size() < 12) return;  // Minimum size check
-    
-    std::string id(reinterpret_cast<const char*>(data.data()), 8);
-    uint32_t capabilities = *reinterpret_cast<const uint32_t*>(data.data() + 8);
-    
+void CommunicationManager::handleBeacon(const protocol::BeaconData& beacon,
+                                        const struct sockaddr_in& sender) {
+    std::string id(beacon.drone_id, strnlen(beacon.drone_id, protocol::DRONE_ID_LENGTH));
     if (!validateDroneId(id)) return;
     
-    {
-        std::lock_guard<std::mutex> lock(drones_mutex_);
-        auto& drone = discovered_drones_[id];
+    std::lock_guard<std::mutex> lock(drones_mutex_);
+    if (active_drones_.count(id)) {
+        // Still connected from our side; the SYN that follows decides
+        // whether this is a reboot
+        return;
+    }
+
+    auto& drone = discovered_drones_[id];
+    drone.last_seen = std::chrono::steady_clock::now();
+    drone.endpoint = sender;
+    if (drone.id.empty()) {
         drone.id = id;
-        drone.capabilities = capabilities;
-        drone.last_seen = std::chrono::steady_clock::now();
+        drone.capabilities = beacon.capabilities;
+        drone.version = beacon.version;
+        drone.signal_strength = beacon.signal_strength;
         drone.state = ConnectionState::DISCOVERY;
-        
-        emit droneDiscovered(id, capabilities);
+        emit droneDiscovered(id, beacon.capabilities);
     }
 }
 
-void CommunicationManager::handleSyn(const std::vector<uint8_t>& data) {
-    // Parse SYN data and send ACK with address assignment
-    if (data.size() < 8) return;  // Minimum size check
-    
-    std::string id(reinterpret_cast<const char*>(data.data()), 8);
+void CommunicationManager::handleSyn(const protocol::SynData& syn,
+                                     const struct sockaddr_in& sender) {
+    std::string id(syn.drone_id, strnlen(syn.drone_id, protocol::DRONE_ID_LENGTH));
+    if (!validateDroneId(id)) return;
     
     std::lock_guard<std::mutex> lock(drones_mutex_);
-    auto it = discovered_drones_.find(id);
-    if (it != discovered_drones_.end() && it->second.state == ConnectionState::DISCOVERY) {
-        it->second.state = ConnectionState::CONNECTING;
-        it->second.address = assignAddress();
-        it->second.token = generateToken();
-        sendAck(it->second);
+    auto now = std::chrono::steady_clock::now();
+
+    // Known session: the drone did not see our ACK, answer it again
+    auto active = active_drones_.find(id);
+    if (active != active_drones_.end()) {
+        if (active->second.request_token == syn.request_token) {
+            active->second.last_seen = now;
+            sendAck(active->second);
+            return;
+        }
+
+        // New request token from a connected drone means it rebooted. Drop
+        // the stale session now instead of waiting for CONNECTION_TIMEOUT and
+        // keep its address so the link comes back in a single round trip.
+        DroneInfo previous = active->second;
+        active_drones_.erase(active);
+        emit droneDisconnected(id);
+        discovered_drones_[id] = previous;
+    }
+
+    auto& drone = discovered_drones_[id];
+    if (drone.state == ConnectionState::CONNECTING &&
+        drone.request_token == syn.request_token) {
+        drone.last_seen = now;
+        drone.endpoint = sender;
+        sendAck(drone);
+        return;
     }
+
+    // A SYN is enough to open a session, no need to have seen a beacon
+    if (drone.id.empty()) {
+        drone.id = id;
+        emit droneDiscovered(id, syn.capabilities);
+    }
+    drone.capabilities = syn.capabilities;
+    drone.version = syn.version;
+    drone.endpoint = sender;
+    drone.last_seen = now;
+    drone.request_token = syn.request_token;
+    drone.token = generateToken();
+    if (drone.address.empty()) {
+        drone.address = assignAddress();
+    }
+    drone.state = ConnectionState::CONNECTING;
+    sendAck(drone);
 }
 
-void CommunicationManager::handleSynAck(const std::vector<uint8_t>& data) {
-    // Validate SYNACK and finalize connection
-    if (data.size() < 16) return;  // Minimum size check
-    
-    std::string id(reinterpret_cast<const char*>(data.data()), 8);
-    uint64_t token = *reinterpret_cast<const uint64_t*>(data.data() + 8);
+void CommunicationManager::handleSynAck(const protocol::SynAckData& synack,
+                                        const struct sockaddr_in& sender) {
+    std::string id(synack.drone_id, strnlen(synack.drone_id, protocol::DRONE_ID_LENGTH));
     
     std::lock_guard<std::mutex> lock(drones_mutex_);
     auto it = discovered_drones_.find(id);
-    if (it != discovered_drones_.end() && 
-        it->second.state == ConnectionState::CONNECTING &&
-        it->second.token == token) {
-        
-        active_drones_[id] = it->second;
-        active_drones_[id].state = ConnectionState::ACTIVE;
-        discovered_drones_.erase(it);
-        
-        emit droneConnected(id, active_drones_[id].address);
+    if (it == discovered_drones_.end() ||
+        it->second.state != ConnectionState::CONNECTING ||
+        it->second.token != synack.session_token) {
+        return;
+    }
+
+    // Every slot taken: leave the drone connecting so a retransmitted
+    // SYNACK can still get in once a session ends
+    size_t slot = allocateTelemetrySlot();
+    if (slot == NO_SLOT) {
+        std::cerr << "No telemetry slot free for drone " << id << std::endl;
+        return;
+    }
+    DroneInfo& drone = active_drones_[id];
+    drone = it->second;
+    drone.telemetry_slot = slot;
+    drone.state = ConnectionState::ACTIVE;
+    drone.endpoint = sender;
+    drone.last_seen = std::chrono::steady_clock::now();
+    discovered_drones_.erase(it);
+    
+    emit droneConnected(id, drone.address);
+    if (!connected_) {
+        connected_ = true;
         emit connectionStatusChanged(true);
     }
 }
 
 void CommunicationManager::sendAck(const DroneInfo& drone) {
-    std::vector<uint8_t> data;
-    data.resize(24);  // ID + token + address
-    
-    std::copy(drone.id.begin(), drone.id.end(), data.begin());
-    *reinterpret_cast<uint64_t*>(data.data() + 8) = drone.token;
-    std::copy(drone.address.begin(), drone.address.end(), data.data() + 16);
-    
-    protocol::ConfigData config = {};
-    config.mode = 0x01;  // ACK mode
-    std::copy(data.begin(), data.end(), reinterpret_cast<uint8_t*>(&config.pid_gains[0]));
-    
-    protocol::Packet ack = protocol::Packet::createConfig(config);
-    
-    std::lock_guard<std::mutex> lock(send_mutex_);
-    outgoing_packets_.push(ack);
+    protocol::AckData ack = {};
+    std::memcpy(ack.drone_id, drone.id.data(),
+                std::min(drone.id.size(), protocol::DRONE_ID_LENGTH));
+    inet_pton(AF_INET, drone.address.c_str(), &ack.assigned_address);
+    ack.request_token = drone.request_token;
+    ack.session_token = drone.token;
+    ack.channel = 0;
+
+    // Reply straight away to where the SYN came from, bypassing the queue
+    sendTo(protocol::Packet::createAck(ack), drone.endpoint);
+}
+
+void CommunicationManager::sendTo(const protocol::Packet& packet,
+                                  const struct sockaddr_in& endpoint) {
+    std::vector<uint8_t> data = packet.serialize();
+    sendto(socket_fd_, data.data(), data.size(), 0,
+           (const struct sockaddr*)&endpoint, sizeof(endpoint));
+}
+
+size_t CommunicationManager::touchDrone(const struct sockaddr_in& sender) {
+    std::lock_guard<std::mutex> lock(drones_mutex_);
+    for (auto& entry : active_drones_) {
+        if (entry.second.endpoint.sin_addr.s_addr == sender.sin_addr.s_addr &&
+            entry.second.endpoint.sin_port == sender.sin_port) {
+            entry.second.last_seen = std::chrono::steady_clock::now();
+            return entry.second.telemetry_slot;
+        }
+    }
+    // Traffic from a drone that has not completed the handshake, or whose
+    // session has timed out
+    return NO_SLOT;
+}
+
+std::map<size_t, std::string> CommunicationManager::getTelemetrySlots() {
+    std::lock_guard<std::mutex> lock(drones_mutex_);
+    std::map<size_t, std::string> slots;
+    for (const auto& entry : active_drones_) {
+        if (entry.second.state == ConnectionState::ACTIVE) {
+            slots[entry.second.telemetry_slot] = entry.first;
+        }
+    }
+    return slots;
+}
+
+size_t CommunicationManager::allocateTelemetrySlot() const {
+    // Lowest slot not held by another active drone (caller holds drones_mutex_)
+    for (size_t slot = 0; slot < TelemetryStore::MAX_DRONES; ++slot) {
+        bool used = false;
+        for (const auto& entry : active_drones_) {
+            used = used || entry.second.telemetry_slot == slot;
+        }
+        if (!used) {
+            return slot;
+        }
+    }
+    return NO_SLOT;
 }
 
 std::string CommunicationManager::assignAddress() {
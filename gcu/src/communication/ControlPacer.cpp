@@ -0,0 +1,143 @@
+#include "communication/ControlPacer.hpp"
+#include <QTimer>
+#include <algorithm>
+#include <cstdlib>
+
+namespace drone {
+namespace gcu {
+namespace communication {
+
+ControlPacer::ControlPacer(SendFunction send, QObject* parent)
+    : QObject(parent)
+    , send_(std::move(send))
+    , rate_hz_(DEFAULT_RATE_HZ)
+    , wake_pending_(false)
+    , timer_(nullptr)
+    , last_sent_version_(0)
+    , submitted_(0)
+    , sent_(0)
+    , superseded_(0)
+    , immediate_(0)
+    , late_(0) {
+}
+
+ControlPacer::~ControlPacer() = default;
+
+void ControlPacer::setRate(double hz) {
+    rate_hz_ = std::max(MIN_RATE_HZ, std::min(MAX_RATE_HZ, hz));
+}
+
+ControlPacer::Statistics ControlPacer::getStatistics() const {
+    Statistics stats;
+    stats.submitted = submitted_;
+    stats.sent = sent_;
+    stats.superseded = superseded_;
+    stats.immediate = immediate_;
+    stats.late = late_;
+    return stats;
+}
+
+void ControlPacer::submit(const protocol::ControlData& controlData) {
+    latest_.store(controlData);
+    submitted_++;
+
+    protocol::ControlData previous;
+    uint32_t version = 0;
+    bool haveSent = last_sent_.version() > 0 && last_sent_.tryLoad(previous, version);
+    if (haveSent && !isLargeChange(previous, controlData)) {
+        return;
+    }
+
+    // At most one wake-up in flight; it sends whatever is latest when it runs
+    if (!wake_pending_.exchange(true)) {
+        QMetaObject::invokeMethod(this, "transmitNow", Qt::QueuedConnection);
+    }
+}
+
+void ControlPacer::start() {
+    if (timer_) return;
+
+    timer_ = new QTimer(this);
+    timer_->setTimerType(Qt::PreciseTimer);
+    timer_->setSingleShot(true);
+    connect(timer_, &QTimer::timeout, this, &ControlPacer::onDeadline);
+
+    next_deadline_ = std::chrono::steady_clock::now() + period();
+    scheduleNext();
+}
+
+void ControlPacer::stop() {
+    delete timer_;
+    timer_ = nullptr;
+}
+
+void ControlPacer::onDeadline() {
+    transmit();
+
+    // Advance from the deadline, not from now, so the rate does not drift
+    auto now = std::chrono::steady_clock::now();
+    next_deadline_ += period();
+    if (next_deadline_ <= now) {
+        late_++;
+        next_deadline_ = now + period();
+    }
+    scheduleNext();
+}
+
+void ControlPacer::transmitNow() {
+    wake_pending_ = false;
+    if (!timer_) return;
+
+    transmit();
+    immediate_++;
+
+    // Restart the schedule so the next periodic send is a full period away
+    next_deadline_ = std::chrono::steady_clock::now() + period();
+    scheduleNext();
+}
+
+void ControlPacer::transmit() {
+    protocol::ControlData controlData;
+    uint32_t version = 0;
+    if (latest_.version() == 0 || !latest_.tryLoad(controlData, version)) {
+        return;  // Nothing submitted yet, never send a zeroed command
+    }
+
+    if (version > last_sent_version_ + 1) {
+        superseded_ += version - last_sent_version_ - 1;
+    }
+    last_sent_version_ = std::max(last_sent_version_, version);
+
+    send_(controlData);
+    last_sent_.store(controlData);
+    sent_++;
+}
+
+void ControlPacer::scheduleNext() {
+    if (!timer_) return;
+
+    auto remaining = next_deadline_ - std::chrono::steady_clock::now();
+    auto ms = std::chrono::ceil<std::chrono::milliseconds>(remaining).count();
+    timer_->start(static_cast<int>(std::max<int64_t>(ms, 0)));
+}
+
+std::chrono::nanoseconds ControlPacer::period() const {
+    return std::chrono::nanoseconds(static_cast<int64_t>(1e9 / rate_hz_.load()));
+}
+
+bool ControlPacer::isLargeChange(const protocol::ControlData& previous,
+                                 const protocol::ControlData& current) {
+    if (previous.armed != current.armed ||
+        previous.emergency_stop != current.emergency_stop) {
+        return true;
+    }
+
+    return std::abs(previous.ailerons - current.ailerons) > LARGE_CHANGE_THRESHOLD ||
+           std::abs(previous.elevator - current.elevator) > LARGE_CHANGE_THRESHOLD ||
+           std::abs(previous.rudder - current.rudder) > LARGE_CHANGE_THRESHOLD ||
+           std::abs(previous.thrust - current.thrust) > LARGE_CHANGE_THRESHOLD;
+}
+
+} // namespace communication
+} // namespace gcu
+} // namespace drone
@@ -0,0 +1,69 @@
+#include "communication/TelemetryStore.hpp"
+
+namespace drone {
+namespace gcu {
+namespace communication {
+
+void TelemetryStore::publish(size_t slot, const protocol::TelemetryData& telemetry) {
+    if (slot >= MAX_DRONES) return;
+
+    Slot& s = slots_[slot];
+    s.latest.store(telemetry);
+    s.received.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool TelemetryStore::consume(size_t slot, protocol::TelemetryData& telemetry) {
+    if (slot >= MAX_DRONES) return false;
+
+    Slot& s = slots_[slot];
+    if (s.latest.version() == s.lastVersion) {
+        return false;
+    }
+
+    uint32_t version = 0;
+    if (!s.latest.tryLoad(telemetry, version) || version == s.lastVersion) {
+        return false;
+    }
+
+    // Every version skipped since the last frame was never displayed
+    s.coalesced += version - s.lastVersion - 1;
+    s.delivered++;
+    s.lastVersion = version;
+    return true;
+}
+
+void TelemetryStore::publishSpectrum(size_t slot, const protocol::SpectrumData& spectrum) {
+    if (slot >= MAX_DRONES || spectrum.axis >= SPECTRUM_AXES) return;
+
+    slots_[slot].spectrum[spectrum.axis].store(spectrum);
+}
+
+bool TelemetryStore::consumeSpectrum(size_t slot, size_t axis, protocol::SpectrumData& spectrum) {
+    if (slot >= MAX_DRONES || axis >= SPECTRUM_AXES) return false;
+
+    Slot& s = slots_[slot];
+    uint32_t version = 0;
+    if (s.spectrum[axis].version() == s.lastSpectrumVersion[axis] ||
+        !s.spectrum[axis].tryLoad(spectrum, version) ||
+        version == s.lastSpectrumVersion[axis]) {
+        return false;
+    }
+
+    s.lastSpectrumVersion[axis] = version;
+    return true;
+}
+
+TelemetryStore::Statistics TelemetryStore::getStatistics(size_t slot) const {
+    Statistics stats;
+    if (slot >= MAX_DRONES) return stats;
+
+    const Slot& s = slots_[slot];
+    stats.received = s.received.load(std::memory_order_relaxed);
+    stats.delivered = s.delivered;
+    stats.coalesced = s.coalesced;
+    return stats;
+}
+
+} // namespace communication
+} // namespace gcu
+} // namespace drone